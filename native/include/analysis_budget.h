@@ -0,0 +1,146 @@
+#ifndef ANALYSIS_BUDGET_H
+#define ANALYSIS_BUDGET_H
+
+#ifndef SWIG
+#include <atomic>
+#include <chrono>
+
+#include "cpu_time.h"
+#endif
+
+enum analysis_outcome_t
+{
+	OUTCOME_UNSCHEDULABLE,
+	OUTCOME_SCHEDULABLE,
+	// the budget ran out before the analysis reached a verdict
+	OUTCOME_INCONCLUSIVE
+};
+
+/* Limits on the effort that a single invocation of an analysis may spend.
+ * A limit of zero means unlimited. The limits are
+ *  - wall_time: seconds since the budget was created (or restarted),
+ *  - cpu_time:  CPU seconds, summed over all threads working on the
+ *               analysis,
+ *  - work:      analysis-specific units, namely LPs solved by the
+ *               LP-based analyses, test points checked by the G-EDF
+ *               tests, and response-time fixpoints computed by RTAGedf.
+ * Analyses check the budget cooperatively at their natural steps (check
+ * points, test points, LP solves) and give up once it is exhausted,
+ * reporting "not schedulable". get_outcome() then tells such a give-up
+ * apart from a genuine negative result. Budgets are independent of each
+ * other, so concurrent analyses in one process can each have their own.
+ * A budget may be shared by the worker threads of one invocation, but
+ * should not be reused for another one without restart(). */
+class AnalysisBudget
+{
+  public:
+	AnalysisBudget(double wall_time_limit = 0, double cpu_time_limit = 0,
+	               unsigned long work_limit = 0)
+		: wall_limit(wall_time_limit), cpu_limit(cpu_time_limit),
+		  work_limit(work_limit)
+	{
+		restart();
+	}
+
+	void restart()
+	{
+		wall_start = now();
+		cpu_nanos = 0;
+		work = 0;
+		exhausted = false;
+	}
+
+	double get_wall_time_limit() const { return wall_limit; }
+	double get_cpu_time_limit() const { return cpu_limit; }
+	unsigned long get_work_limit() const { return work_limit; }
+
+	double get_wall_time() const { return now() - wall_start; }
+	double get_cpu_time() const { return cpu_nanos / 1E9; }
+	unsigned long get_work() const { return work; }
+
+	bool is_exhausted() const
+	{
+		return exhausted;
+	}
+
+	// Make the analysis give up at its next check, e.g., because its
+	// result is no longer needed. It is then reported as inconclusive.
+	// May be called from any thread.
+	void cancel()
+	{
+		exhausted = true;
+	}
+
+	analysis_outcome_t get_outcome(bool schedulable) const
+	{
+		if (schedulable)
+			return OUTCOME_SCHEDULABLE;
+		return exhausted ? OUTCOME_INCONCLUSIVE : OUTCOME_UNSCHEDULABLE;
+	}
+
+#ifndef SWIG
+	// Accounts the work of one thread against a budget (which may be
+	// NULL, in which case the budget is never exhausted).
+	class Meter
+	{
+	  public:
+		Meter(AnalysisBudget* budget = NULL)
+			: budget(budget), last_cpu(budget ? get_cpu_usage() : 0)
+		{}
+
+		void charge(unsigned long units = 1)
+		{
+			if (budget)
+				budget->work += units;
+		}
+
+		// Charge the CPU time of the calling thread since the last
+		// check and test all limits.
+		bool exhausted()
+		{
+			if (!budget)
+				return false;
+
+			const double cpu = get_cpu_usage();
+			budget->cpu_nanos += (unsigned long) ((cpu - last_cpu) * 1E9);
+			last_cpu = cpu;
+
+			return budget->check();
+		}
+
+	  private:
+		AnalysisBudget* budget;
+		double last_cpu;
+	};
+#endif
+
+  private:
+	static double now()
+	{
+		return std::chrono::duration<double>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	bool check()
+	{
+		if (!exhausted &&
+		    ((wall_limit > 0 && get_wall_time() > wall_limit) ||
+		     (cpu_limit > 0 && get_cpu_time() > cpu_limit) ||
+		     (work_limit > 0 && work > work_limit)))
+			exhausted = true;
+		return exhausted;
+	}
+
+	double wall_limit;
+	double cpu_limit;
+	unsigned long work_limit;
+
+#ifndef SWIG
+	double wall_start;
+	std::atomic<unsigned long> cpu_nanos;
+	std::atomic<unsigned long> work;
+	std::atomic<bool> exhausted;
+#endif
+};
+
+#endif
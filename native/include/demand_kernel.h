@@ -0,0 +1,79 @@
+#ifndef DEMAND_KERNEL_H
+#define DEMAND_KERNEL_H
+
+#ifndef SWIG
+
+#include "time-types.h"
+#include "tasks.h"
+
+/* Structure-of-arrays copy of the periods, relative deadlines, and WCETs of
+ * a task set, for evaluating demand and request bound functions of all
+ * tasks at once with AVX-512 or AVX2 (whichever the build targets), or one
+ * task at a time otherwise.
+ *
+ * The lanes compute in double precision, since neither instruction set
+ * divides 64-bit integers. The quotients are corrected to the exact integer
+ * results, and every value is exact as long as it stays below 2^53. The
+ * kernel guarantees this for all times t with |t| <= get_max_time(), which
+ * is derived from the utilization (the demand is at most t * U + sum C_i),
+ * and throws fixed_width_overflow for any other time, just like the
+ * fixed-width types. The copy is not updated if the task set changes. */
+class DemandKernel
+{
+  public:
+	DemandKernel(const TaskSet &ts);
+	~DemandKernel();
+
+	unsigned int get_task_count() const { return num_tasks; }
+
+	const fixed_integral_t& get_max_time() const { return max_time; }
+
+	// demand bound function: sum of max(0, floor((t - D_i) / P_i) + 1) * C_i
+	fixed_integral_t dbf(const fixed_integral_t &time) const;
+
+	// request bound function: sum of ceil(t / P_i) * C_i
+	fixed_integral_t rbf(const fixed_integral_t &time) const;
+
+	// latest absolute deadline D_i + j * P_i strictly before time, or zero
+	// if there is none (QPA's next test point)
+	fixed_integral_t last_deadline_before(const fixed_integral_t &time) const;
+
+	// per-task demand bound function and its carry-in variant,
+	// floor(t / P_i) * C_i + min(C_i, t mod P_i)
+	void task_dbf(const fixed_integral_t &time,
+	              fixed_integral_t dbf[],
+	              fixed_integral_t carry_in_dbf[]) const;
+
+	// Approximate demand bound function of Fisher, Baker, and Baruah's PTAS
+	// (see Task::approx_demand), which is exact for the first k[i] jobs of
+	// task i. approx_dbf() may only be called after set_approximation().
+	void set_approximation(const unsigned long k[]);
+	fixed_integral_t approx_dbf(const fixed_integral_t &time) const;
+
+  private:
+	// not copyable, owns the arrays
+	DemandKernel(const DemandKernel &);
+	DemandKernel& operator=(const DemandKernel &);
+
+	double checked_time(const fixed_integral_t &time) const;
+
+	unsigned int num_tasks;
+	// num_tasks rounded up to a multiple of the vector width; the
+	// padding tasks never cause any demand
+	unsigned int num_lanes;
+
+	double *buffer;
+	double *period;
+	double *deadline;
+	double *wcet;
+	// the approximation is exact before k_i * P_i + D_i
+	double *exact_until;
+
+	fixed_integral_t max_time;
+	// approx_dbf() is exact for all tasks, i.e., no P_i * C_i is too large
+	bool can_approximate;
+};
+
+#endif
+
+#endif
@@ -1,25 +1,45 @@
 #ifndef BARUAH_H
 #define BARUAH_H
 
+class AnalysisBudget;
+class DemandKernel;
+
 class BaruahGedf : public SchedulabilityTest
 {
 
 private:
     unsigned int m;
+    AnalysisBudget *budget;
 
+#ifndef SWIG
+    // Int is fixed_integral_t or integral_t (see time-types.h); the
+    // kernel is used only with the former
+    template <typename Int>
     bool is_task_schedulable(unsigned int k,
                              const TaskSet &ts,
-                             const integral_t &ilen,
-                             integral_t &i1,
-                             integral_t &sum,
-                             integral_t *idiff,
-                             integral_t **ptr);
+                             const DemandKernel &kernel,
+                             const Int &ilen,
+                             Int &i1,
+                             Int &sum,
+                             Int *dbf,
+                             Int *dbf_prime,
+                             Int *idiff,
+                             Int **ptr);
+
+    template <typename Int>
+    bool check_test_points(const TaskSet &ts,
+                           const DemandKernel &kernel,
+                           Int *max_test_point,
+                           AnalysisBudget &budget);
+#endif
 
     void get_max_test_points(const TaskSet &ts, fractional_t& m_minus_u,
                              integral_t* maxp);
 
 public:
-    BaruahGedf(unsigned int num_processors) : m(num_processors) {};
+    // Without a budget, the test gives up after MAX_RUNTIME CPU seconds.
+    BaruahGedf(unsigned int num_processors, AnalysisBudget *budget = NULL)
+        : m(num_processors), budget(budget) {};
 
     bool is_schedulable(const TaskSet &ts, bool check_preconditions = true);
 
@@ -1,25 +1,39 @@
 #ifndef FFDBF_H
 #define FFDBF_H
 
+class AnalysisBudget;
+
 class FFDBFGedf : public SchedulabilityTest
 {
   private:
     const unsigned int m;
     const unsigned long epsilon_denom;
     const fractional_t sigma_step;
+    AnalysisBudget *budget;
 
   private:
+#ifndef SWIG
+    // Int and Frac are fixed_integral_t and fixed_fractional_t, or
+    // integral_t and fractional_t (see time-types.h)
+    template <typename Int, typename Frac>
     bool witness_condition(const TaskSet &ts,
-                           const integral_t q[], const fractional_t r[],
-                           const fractional_t &time, const fractional_t &speed);
+                           const Int q[], const Frac r[],
+                           const Frac &time, const Frac &speed);
+
+    template <typename Int, typename Frac>
+    bool check_test_points(const TaskSet &ts);
+#endif
 
   public:
+    // Without a budget, the test runs until it reaches a verdict.
     FFDBFGedf(unsigned int num_processors,
               unsigned long epsilon_denom = 10,
-              unsigned long sigma_granularity = 50)
+              unsigned long sigma_granularity = 50,
+              AnalysisBudget *budget = NULL)
         :  m(num_processors),
            epsilon_denom(epsilon_denom),
-           sigma_step(1, sigma_granularity)
+           sigma_step(1, sigma_granularity),
+           budget(budget)
         {};
 
     bool is_schedulable(const TaskSet &ts, bool check_preconditions = true);
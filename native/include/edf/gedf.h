@@ -1,6 +1,55 @@
 #ifndef GEDF_H
 #define GEDF_H
 
+class AnalysisBudget;
+
+// the sufficient tests that GlobalEDF combines, in their default order
+enum gedf_test_t
+{
+    GEDF_TEST_BAKER,
+    GEDF_TEST_GFB,
+    GEDF_TEST_RTA,
+    GEDF_TEST_BARUAH,
+    GEDF_TEST_FFDBF,
+    GEDF_TEST_LA,
+    GEDF_TEST_LOAD,
+    GEDF_NUM_TESTS
+};
+
+enum gedf_cascade_mode_t
+{
+    // one test after the other in the default order, which runs the
+    // cheap tests first
+    GEDF_CASCADE_FIXED,
+    // Baker's and the GFB test (both closed-form) first, then all other
+    // tests concurrently; the first one to accept the task set cancels
+    // the others, and exceptions are only passed on if no test accepts
+    GEDF_CASCADE_PARALLEL,
+    // one test after the other, ordered by the acceptances per CPU second
+    // observed so far (see get_gedf_test_stats()); tests that have not
+    // run yet come first
+    GEDF_CASCADE_ADAPTIVE
+};
+
+/* Outcomes of the tests run by GlobalEDF in GEDF_CASCADE_ADAPTIVE mode,
+ * summed over all instances in the process. The other modes do not
+ * measure their tests. Only completed runs are counted, i.e., not those
+ * that were skipped because another test accepted the task set first.
+ * cpu_time is the CPU time of these runs in seconds. The counters are
+ * updated atomically but independently, so a snapshot taken while tests
+ * run may be slightly inconsistent. */
+struct GEDFTestStats
+{
+    unsigned long runs;
+    unsigned long accepted;
+    double cpu_time;
+
+    GEDFTestStats() : runs(0), accepted(0), cpu_time(0) {}
+};
+
+GEDFTestStats get_gedf_test_stats(gedf_test_t test);
+void reset_gedf_test_stats();
+
 class GlobalEDF : public SchedulabilityTest
 {
 
@@ -12,6 +61,13 @@ class GlobalEDF : public SchedulabilityTest
     bool want_baruah;
     bool want_rta;
     bool want_la;
+    gedf_cascade_mode_t mode;
+
+    bool run_test(gedf_test_t test, const TaskSet &ts,
+                  AnalysisBudget *budget);
+    bool run_tests_concurrently(const gedf_test_t *tests,
+                                unsigned int num_tests,
+                                const TaskSet &ts);
 
  public:
  GlobalEDF(unsigned int num_processors,
@@ -26,7 +82,15 @@ class GlobalEDF : public SchedulabilityTest
        want_load(want_load),
        want_baruah(want_baruah),
        want_rta(want_rta),
-       want_la(want_la) {};
+       want_la(want_la),
+       mode(GEDF_CASCADE_FIXED) {};
+
+    void set_cascade_mode(gedf_cascade_mode_t cascade_mode)
+    {
+        mode = cascade_mode;
+    }
+
+    gedf_cascade_mode_t get_cascade_mode() const { return mode; }
 
     bool is_schedulable(const TaskSet &ts, bool check_preconditions = true);
 };
@@ -1,21 +1,36 @@
 #ifndef LA_H
 #define LA_H
 
+class AnalysisBudget;
+
 class LAGedf : public SchedulabilityTest
 {
 
 private:
 	unsigned int m;
+	AnalysisBudget *budget;
 
+#ifndef SWIG
+	// Int is fixed_integral_t or integral_t (see time-types.h)
+	template <typename Int>
 	bool is_task_schedulable_for_interval(
 		const TaskSet &ts,
 		unsigned int l,
 		unsigned long suspend,
-		const integral_t &ilen, /* interval length is xi_l - d_l */
-		integral_t &i1,
-		integral_t &sum,
-		integral_t *idiff,
-		integral_t **ptr);
+		const Int &ilen, /* interval length is xi_l - d_l */
+		Int &i1,
+		Int &sum,
+		Int *idiff,
+		Int **ptr);
+
+	template <typename Int>
+	bool check_test_points(
+		const TaskSet &ts,
+		unsigned int l,
+		unsigned long suspend,
+		const Int &max_test_point,
+		AnalysisBudget &budget);
+#endif
 
 	bool is_task_schedulable_for_suspension_length(
 		const TaskSet &ts,
@@ -34,7 +49,10 @@ private:
 		unsigned long suspension);
 
 public:
-	LAGedf(unsigned int num_processors) : m(num_processors) {};
+	// Without a budget, the test gives up after MAX_RUNTIME CPU seconds
+	// for any one task and suspension length.
+	LAGedf(unsigned int num_processors, AnalysisBudget *budget = NULL)
+		: m(num_processors), budget(budget) {};
 
 	bool is_schedulable(const TaskSet &ts, bool check_preconditions = true);
 
@@ -1,16 +1,22 @@
 #ifndef LOAD_H
 #define LOAD_H
 
+class AnalysisBudget;
+
 class LoadGedf : public SchedulabilityTest
 {
  private:
     unsigned int m;
     fractional_t epsilon;
+    AnalysisBudget *budget;
 
  public:
+    // Without a budget, the test runs until it reaches a verdict.
     LoadGedf(unsigned int num_processors,
-             unsigned int milli_epsilon = 100
-             ) : m(num_processors), epsilon(milli_epsilon, 1000) {};
+             unsigned int milli_epsilon = 100,
+             AnalysisBudget *budget = NULL
+             ) : m(num_processors), epsilon(milli_epsilon, 1000),
+                 budget(budget) {};
 
     bool is_schedulable(const TaskSet &ts, bool check_preconditions = true);
 
@@ -1,6 +1,8 @@
 #ifndef QPA_H
 #define QPA_H
 
+class DemandKernel;
+
 class QPATest : public SchedulabilityTest
 {
  public:
@@ -10,6 +12,21 @@ class QPATest : public SchedulabilityTest
 
     virtual integral_t get_demand(integral_t interval, const TaskSet &ts);
     virtual integral_t get_max_interval(const TaskSet &ts, const fractional_t& util);
+
+#ifndef SWIG
+    // Used as long as the intervals fit into 64 bits (see demand_kernel.h).
+    // Throws fixed_width_overflow if the demand does not, and should be
+    // overridden together with the above.
+    virtual fixed_integral_t get_demand(fixed_integral_t interval,
+                                        const DemandKernel &kernel);
+
+ private:
+    // Demand is TaskSet with integral_t and DemandKernel with
+    // fixed_integral_t
+    template <typename Int, typename Demand>
+    bool check_test_points(const Demand &tasks, unsigned long min_interval,
+                           const Int &max_interval);
+#endif
 };
 
 // support for C=D semi-partitioning assignment heuristic
@@ -27,6 +27,10 @@ private:
                  unsigned int _num_cpus, unsigned int _cpu_id); // Needed by msrp_bounds
 
     integral_t get_demand(integral_t interval, const TaskSet &ts);
+#ifndef SWIG
+    fixed_integral_t get_demand(fixed_integral_t interval,
+                                const DemandKernel &kernel);
+#endif
     integral_t get_max_interval(const TaskSet &ts, const fractional_t& util);
 
 
@@ -1,6 +1,8 @@
 #ifndef RTA_H
 #define RTA_H
 
+class AnalysisBudget;
+
 class RTAGedf : public SchedulabilityTest
 {
 
@@ -8,6 +10,7 @@ class RTAGedf : public SchedulabilityTest
     unsigned int m;
     unsigned int max_rounds;
     unsigned int min_delta;
+    AnalysisBudget *budget;
 
     bool response_estimate(unsigned int k,
                            const TaskSet &ts,
@@ -21,11 +24,13 @@ class RTAGedf : public SchedulabilityTest
                       unsigned long &response);
 
  public:
+   // Without a budget, the test is limited only by max_rounds.
    RTAGedf(unsigned int num_processors,
            unsigned int min_fixpoint_step = 0,
-           unsigned int max_rounds = 25)
+           unsigned int max_rounds = 25,
+           AnalysisBudget *budget = NULL)
          : m(num_processors), max_rounds(max_rounds),
-           min_delta(min_fixpoint_step) {};
+           min_delta(min_fixpoint_step), budget(budget) {};
 
     bool is_schedulable(const TaskSet &ts, bool check_preconditions = true);
 };
@@ -92,6 +92,26 @@
 	foreach(tasks, task_iter) \
 	if (task_iter->get_cluster() != (cluster))
 
+// Same as above, but based on the cluster index of the ResourceSharingInfo
+// 'info' (see ClusterIndex) instead of filtering the whole task set.
+#define foreach_indexed_task_in_cluster(info, cluster, task_iter) \
+	foreach((info).get_tasks_in_cluster(cluster), task_iter)
+
+#define foreach_indexed_task_in_cluster_having_leq_dline(info, cluster, delta, task_iter) \
+	foreach_indexed_task_in_cluster(info, cluster, task_iter) \
+	if (task_iter->get_deadline() <= (delta))
+
+#define foreach_indexed_task_in_cluster_having_gt_dline(info, cluster, delta, task_iter) \
+	foreach_indexed_task_in_cluster(info, cluster, task_iter) \
+	if (task_iter->get_deadline() > (delta))
+
+#define foreach_indexed_task_in_cluster_having_lt_dline(info, cluster, delta, task_iter) \
+	foreach_indexed_task_in_cluster(info, cluster, task_iter) \
+	if (task_iter->get_deadline() < (delta))
+
+#define foreach_indexed_task_not_in_cluster(info, cluster, task_iter) \
+	foreach((info).get_tasks_not_in_cluster(cluster), task_iter)
+
 #define foreach_local_task(tasks, local_task, task_iter)	\
 	foreach(tasks, task_iter)				\
 	if (task_iter->get_cluster() == (local_task).get_cluster())
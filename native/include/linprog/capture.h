@@ -0,0 +1,37 @@
+#ifndef LINPROG_CAPTURE_H
+#define LINPROG_CAPTURE_H
+
+#include "linprog/model.h"
+
+// Describes where the LPs that are currently being generated in this thread
+// come from. Captured LPs (see set_lp_capture()) are tagged with it.
+struct LinearProgramOrigin
+{
+	const char *analysis; // static string, NULL if unknown
+	int task;             // index of the task under analysis, -1 if none
+	double interval;      // length of the analyzed interval, -1 if none
+
+	LinearProgramOrigin(const char *analysis = NULL, int task = -1,
+	                    double interval = -1)
+		: analysis(analysis), task(task), interval(interval)
+	{}
+};
+
+const LinearProgramOrigin& linprog_get_origin();
+
+// Sets the origin of the calling thread for the lifetime of the scope,
+// e.g., LinearProgramOriginScope origin(__func__);
+class LinearProgramOriginScope
+{
+	LinearProgramOrigin saved;
+
+public:
+	LinearProgramOriginScope(const LinearProgramOrigin &origin);
+	~LinearProgramOriginScope();
+};
+
+// Write lp to the capture directory if capturing is enabled. Called by
+// linprog_solve() and the solver sessions for every LP they are given.
+void linprog_capture(const LinearProgram &lp, unsigned int num_vars);
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef LINPROG_DISPATCH_H
+#define LINPROG_DISPATCH_H
+
+/* Runtime selection of the LP solver back end.
+ *
+ * LP_SOLVER_AUTO picks a back end for each LP individually: small programs
+ * go to the built-in simplex solver, large LPs to GLPK (or CPLEX), and
+ * large ILPs to CPLEX (or GLPK), depending on which solvers were compiled
+ * in. The other choices force a specific back end for all LPs, except
+ * that LP_SOLVER_NATIVE still hands LPs beyond get_simplex_max_rows() to
+ * an external back end (see linprog/simplex.h).
+ */
+enum lp_solver_t
+{
+	LP_SOLVER_AUTO,
+	LP_SOLVER_NATIVE,
+	LP_SOLVER_GLPK,
+	LP_SOLVER_CPLEX,
+};
+
+/* Returns false (and leaves the selection unchanged) if the requested
+ * back end was not compiled in. */
+bool set_lp_solver(lp_solver_t solver);
+lp_solver_t get_lp_solver();
+
+bool is_lp_solver_available(lp_solver_t solver);
+
+/* Size limits up to which LP_SOLVER_AUTO uses the built-in solver. An LP
+ * qualifies if it has at most max_rows constraints and max_cols
+ * variables; an ILP must in addition have at most max_int_vars integer or
+ * binary variables. */
+void set_lp_auto_dispatch_limits(unsigned int max_rows, unsigned int max_cols,
+                                 unsigned int max_int_vars);
+
+/* Enable or disable the solver-independent presolve step (see
+ * linprog/presolve.h) that runs in front of the back ends. Enabled by
+ * default. */
+void set_lp_presolve(bool enabled);
+bool get_lp_presolve();
+
+/* Write every LP that is solved from now on to an MPS file in the given
+ * (existing) directory, e.g., to replay them later with lpreplay. Files
+ * are named <seq>-<analysis>[-T<task>][-L<interval>].mps after the
+ * analysis that generated them. Pass NULL or an empty string to stop
+ * capturing. */
+void set_lp_capture(const char *directory);
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef LINPROG_EXPORT_H
+#define LINPROG_EXPORT_H
+
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+
+#include "linprog/model.h"
+
+typedef std::map<std::string, std::string> LinearProgramTags;
+
+// Write lp, which uses variables 0..num_vars-1, in free MPS format.
+// Variables are named X<i>, equalities E<r>, and inequalities L<r>, so
+// that read_mps() reproduces the exact same program. Each tag is written
+// as a "* key: value" comment line at the top of the file.
+void write_mps(std::ostream &os, const LinearProgram &lp,
+               unsigned int num_vars,
+               const LinearProgramTags &tags = LinearProgramTags());
+
+// Write lp in CPLEX LP format (also understood by GLPK and most other
+// solvers), using the same names as write_mps().
+void write_cplex_lp(std::ostream &os, const LinearProgram &lp,
+                    unsigned int num_vars,
+                    const LinearProgramTags &tags = LinearProgramTags());
+
+// Parse an MPS file (free format, or fixed format without blanks in
+// names). Returns NULL and describes the problem in error if the input
+// cannot be parsed. Columns are numbered in order of first appearance;
+// num_vars is set to the number of columns. Comment lines of the form
+// "* key: value" are stored in tags, if given.
+LinearProgram *read_mps(std::istream &in, unsigned int &num_vars,
+                        std::string &error,
+                        LinearProgramTags *tags = NULL);
+
+#endif
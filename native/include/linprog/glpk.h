@@ -4,9 +4,17 @@
 #include "linprog/model.h"
 
 class Solution;
+class LinearProgramSession;
 
 Solution *glpk_solve(const LinearProgram& lp, unsigned int max_num_vars);
 
+// persistent GLPK problem that is updated in place and warm-started
+LinearProgramSession *glpk_create_session();
+
+// release the calling thread's GLPK environment (requires a reentrant,
+// i.e., thread-local, GLPK build when used from multiple threads)
+void glpk_release_thread_state();
+
 #include "linprog/solver.h"
 
 #endif
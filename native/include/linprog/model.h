@@ -1,9 +1,11 @@
 #ifndef LINPROG_MODEL_H
 #define LINPROG_MODEL_H
 
+#include <algorithm>
 #include <vector>
 #include <utility>
 #include <set>
+#include <string>
 
 #include <sstream>
 
@@ -12,6 +14,46 @@
 typedef std::pair<double, unsigned int> Term;
 typedef std::vector<Term> Terms;
 
+// Constraints are built one LinearExpression at a time, and each expression
+// is discarded as soon as it has been added to a LinearProgram. To avoid
+// allocating a fresh term buffer for every single constraint, buffers of
+// discarded expressions are kept in a small per-thread pool and reused.
+// Buffers are recycled rather than bump-allocated from an arena, since
+// expressions die one at a time, and an arena allocator would change the
+// type of Terms in every interface that passes terms around.
+class TermBufferPool
+{
+	enum { MAX_SPARE_BUFFERS = 64 };
+
+	static std::vector<Terms>& spares()
+	{
+		static thread_local std::vector<Terms> pool;
+		return pool;
+	}
+
+public:
+	static void acquire(Terms &terms)
+	{
+		std::vector<Terms> &pool = spares();
+		if (!pool.empty())
+		{
+			terms.swap(pool.back());
+			pool.pop_back();
+		}
+	}
+
+	static void release(Terms &terms)
+	{
+		std::vector<Terms> &pool = spares();
+		if (terms.capacity() && pool.size() < MAX_SPARE_BUFFERS)
+		{
+			terms.clear();
+			pool.push_back(Terms());
+			pool.back().swap(terms);
+		}
+	}
+};
+
 class LinearExpression
 {
 private:
@@ -22,6 +64,20 @@ private:
 #endif
 
 public:
+	LinearExpression()
+	{
+		TermBufferPool::acquire(terms);
+	}
+
+	LinearExpression(const LinearExpression &other)
+		: terms(other.terms)
+	{}
+
+	~LinearExpression()
+	{
+		TermBufferPool::release(terms);
+	}
+
 	void add_term(double coefficient, unsigned int variable_index)
 	{
 		terms.push_back(Term(coefficient, variable_index));
@@ -79,52 +135,260 @@ struct VariableRange {
 #endif
 
 
-typedef std::pair<LinearExpression *, double> Constraint;
-typedef std::vector<Constraint> Constraints;
 typedef std::vector<VariableRange> VariableRanges;
 
+// A set of constraints stored in compressed sparse row (CSR) format: the
+// variables and coefficients of all rows are kept in flat arrays, with row r
+// occupying the index range [row_begin[r], row_begin[r + 1]). The arrays can
+// be handed to solver back ends as they are.
+class SparseRows
+{
+	std::vector<int> row_begin;
+	std::vector<int> vars;
+	std::vector<double> coeffs;
+	std::vector<double> bounds;
+
+#ifdef DEBUG
+	std::vector<std::string> descriptions;
+#endif
+
+public:
+	SparseRows() : row_begin(1, 0) {}
+
+	// The terms of the row are stored sorted by variable, with repeated
+	// variables merged and zero coefficients dropped.
+	void add_row(const LinearExpression &exp, double bound)
+	{
+		const unsigned int begin = vars.size();
+		bool canonical = true;
+
+		foreach(exp.get_terms(), term)
+		{
+			canonical = canonical && term->first != 0.0 &&
+				(vars.size() == begin ||
+				 (unsigned int) vars.back() < term->second);
+			vars.push_back(term->second);
+			coeffs.push_back(term->first);
+		}
+
+		if (!canonical)
+			canonicalize_row(begin);
+
+		row_begin.push_back(vars.size());
+		bounds.push_back(bound);
+#ifdef DEBUG
+		descriptions.push_back(exp.get_debug_description());
+#endif
+	}
+
+	// number of rows
+	unsigned int size() const
+	{
+		return bounds.size();
+	}
+
+	bool empty() const
+	{
+		return bounds.empty();
+	}
+
+	// total number of non-zero coefficients in all rows
+	unsigned int get_num_coeffs() const
+	{
+		return vars.size();
+	}
+
+	unsigned int get_row_size(unsigned int r) const
+	{
+		return row_begin[r + 1] - row_begin[r];
+	}
+
+	const int *get_row_vars(unsigned int r) const
+	{
+		return vars.data() + row_begin[r];
+	}
+
+	const double *get_row_coeffs(unsigned int r) const
+	{
+		return coeffs.data() + row_begin[r];
+	}
+
+	double get_bound(unsigned int r) const
+	{
+		return bounds[r];
+	}
+
+	// raw CSR arrays, for bulk loading into a solver
+	const int *get_row_begin() const
+	{
+		return row_begin.data();
+	}
+
+	const int *get_vars() const
+	{
+		return vars.data();
+	}
+
+	const double *get_coeffs() const
+	{
+		return coeffs.data();
+	}
+
+	const double *get_bounds() const
+	{
+		return bounds.data();
+	}
+
+	// append all (already canonical) rows of other, with variable indices
+	// shifted by offset
+	void append_rows(const SparseRows &other, unsigned int offset)
+	{
+		const int base = vars.size();
+
+		for (unsigned int k = 0; k < other.vars.size(); k++)
+			vars.push_back(other.vars[k] + offset);
+		coeffs.insert(coeffs.end(), other.coeffs.begin(), other.coeffs.end());
+		for (unsigned int r = 1; r < other.row_begin.size(); r++)
+			row_begin.push_back(base + other.row_begin[r]);
+		bounds.insert(bounds.end(), other.bounds.begin(), other.bounds.end());
+#ifdef DEBUG
+		descriptions.insert(descriptions.end(),
+		                    other.descriptions.begin(),
+		                    other.descriptions.end());
+#endif
+	}
+
+	// same coefficients in the same positions, bounds may differ
+	bool same_matrix(const SparseRows &other) const
+	{
+		return row_begin == other.row_begin && vars == other.vars &&
+		       coeffs == other.coeffs;
+	}
+
+	bool row_equals(unsigned int r,
+	                const SparseRows &other, unsigned int other_r) const
+	{
+		const unsigned int n = get_row_size(r);
+
+		return n == other.get_row_size(other_r) &&
+		       std::equal(get_row_vars(r), get_row_vars(r) + n,
+		                  other.get_row_vars(other_r)) &&
+		       std::equal(get_row_coeffs(r), get_row_coeffs(r) + n,
+		                  other.get_row_coeffs(other_r));
+	}
+
+private:
+	// sort and merge the terms from position begin to the end
+	void canonicalize_row(unsigned int begin)
+	{
+		static thread_local std::vector<std::pair<int, double> > row;
+
+		row.clear();
+		for (unsigned int k = begin; k < vars.size(); k++)
+			row.push_back(std::make_pair(vars[k], coeffs[k]));
+
+		std::sort(row.begin(), row.end(), var_less);
+
+		unsigned int end = begin;
+		for (unsigned int k = 0; k < row.size(); k++)
+		{
+			if (end > begin && vars[end - 1] == row[k].first)
+				coeffs[end - 1] += row[k].second;
+			else
+			{
+				if (end > begin && coeffs[end - 1] == 0.0)
+					end--;
+				vars[end] = row[k].first;
+				coeffs[end] = row[k].second;
+				end++;
+			}
+		}
+		if (end > begin && coeffs[end - 1] == 0.0)
+			end--;
+
+		vars.resize(end);
+		coeffs.resize(end);
+	}
+
+	static bool var_less(const std::pair<int, double> &a,
+	                     const std::pair<int, double> &b)
+	{
+		return a.first < b.first;
+	}
+
+public:
+#ifdef DEBUG
+	const std::string& get_debug_description(unsigned int r) const
+	{
+		return descriptions[r];
+	}
+#endif
+};
+
 // builds a maximization problem piece-wise
 class LinearProgram
 {
+	enum variable_kind_t
+	{
+		VARIABLE_INTEGER = 1,
+		VARIABLE_BINARY  = 2,
+	};
+
 	// the function to be maximized
 	LinearExpression *objective;
 
 	// linear expressions constrained to an exact value
-	Constraints equalities;
+	SparseRows equalities;
 
 	// linear expressions constrained by an upper bound (exp <= bound)
-	Constraints inequalities;
+	SparseRows inequalities;
 
-	// set of integer variables
-	std::set<unsigned int> variables_integer;
+	// integer and binary variables, in order of declaration
+	std::vector<unsigned int> variables_integer;
+	std::vector<unsigned int> variables_binary;
 
-	// set of binary variables
-	std::set<unsigned int> variables_binary;
+	// variable_kind_t flags of each variable, indexed by variable ID
+	std::vector<unsigned char> variable_kinds;
 
 	// By default all variables have a lower bound of zero and an upper bound of one.
 	// Exceptional cases are stored in this (unsorted) vector.
 	VariableRanges non_default_bounds;
 
+	bool has_kind(unsigned int variable_id, variable_kind_t kind) const
+	{
+		return variable_id < variable_kinds.size() &&
+		       (variable_kinds[variable_id] & kind);
+	}
+
+	void declare_kind(unsigned int variable_id, variable_kind_t kind,
+	                  std::vector<unsigned int> &declared)
+	{
+		if (variable_id >= variable_kinds.size())
+			variable_kinds.resize(variable_id + 1, 0);
+
+		if (!(variable_kinds[variable_id] & kind))
+		{
+			variable_kinds[variable_id] |= kind;
+			declared.push_back(variable_id);
+		}
+	}
+
 public:
 	LinearProgram() : objective(new LinearExpression()) {};
 
 	~LinearProgram()
 	{
 		delete objective;
-		foreach(equalities, eq)
-			delete eq->first;
-		foreach(inequalities, ineq)
-			delete ineq->first;
 	}
 
 	void declare_variable_integer(unsigned int variable_index)
 	{
-		variables_integer.insert(variable_index);
+		declare_kind(variable_index, VARIABLE_INTEGER, variables_integer);
 	}
 
 	void declare_variable_binary(unsigned int variable_index)
 	{
-		variables_binary.insert(variable_index);
+		declare_kind(variable_index, VARIABLE_BINARY, variables_binary);
 	}
 
 	void declare_variable_bounds(unsigned int variable_id,
@@ -145,20 +409,21 @@ public:
 		objective = exp;
 	}
 
+	// Takes ownership of exp: its terms are copied (merged, see
+	// SparseRows::add_row()) into the constraint matrix and the
+	// expression itself is discarded.
 	void add_inequality(LinearExpression *exp, double upper_bound)
 	{
 		if (exp->has_terms())
-			inequalities.push_back(Constraint(exp, upper_bound));
-		else
-			delete exp;
+			inequalities.add_row(*exp, upper_bound);
+		delete exp;
 	}
 
 	void add_equality(LinearExpression *exp, double equal_to)
 	{
 		if (exp->has_terms())
-			equalities.push_back(Constraint(exp, equal_to));
-		else
-			delete exp;
+			equalities.add_row(*exp, equal_to);
+		delete exp;
 	}
 
 	const LinearExpression *get_objective() const
@@ -166,7 +431,7 @@ public:
 		return objective;
 	}
 
-	const std::set<unsigned int>& get_integer_variables() const
+	const std::vector<unsigned int>& get_integer_variables() const
 	{
 		return variables_integer;
 	}
@@ -183,15 +448,15 @@ public:
 
 	bool is_integer_variable(unsigned int variable_id) const
 	{
-		return variables_integer.find(variable_id) != variables_integer.end();
+		return has_kind(variable_id, VARIABLE_INTEGER);
 	}
 
 	bool is_binary_variable(unsigned int variable_id) const
 	{
-		return variables_binary.find(variable_id) != variables_binary.end();
+		return has_kind(variable_id, VARIABLE_BINARY);
 	}
 
-	const std::set<unsigned int>& get_binary_variables() const
+	const std::vector<unsigned int>& get_binary_variables() const
 	{
 		return variables_binary;
 	}
@@ -201,21 +466,61 @@ public:
 		return objective;
 	}
 
-	const Constraints& get_equalities() const
+	const SparseRows& get_equalities() const
 	{
 		return equalities;
 	}
 
-	const Constraints& get_inequalities() const
+	const SparseRows& get_inequalities() const
 	{
 		return inequalities;
 	}
 
+	unsigned int get_num_rows() const
+	{
+		return equalities.size() + inequalities.size();
+	}
+
 	const VariableRanges& get_non_default_variable_ranges() const
 	{
 		return non_default_bounds;
 	}
 
+	// Add the constraints, variable kinds, and variable bounds (but not the
+	// objective) of other, with all of its variables renamed from v to
+	// v + offset. Used to combine independent LPs into one. With
+	// relax_integrality, integer and binary variables become continuous
+	// variables with the same ranges ([0, inf) and [0, 1], respectively),
+	// which yields the LP relaxation of other.
+	void append(const LinearProgram &other, unsigned int offset,
+	            bool relax_integrality = false)
+	{
+		equalities.append_rows(other.equalities, offset);
+		inequalities.append_rows(other.inequalities, offset);
+
+		foreach(other.non_default_bounds, b)
+		{
+			non_default_bounds.push_back(*b);
+			non_default_bounds.back().variable_id += offset;
+		}
+
+		if (relax_integrality)
+		{
+			// the implied ranges override any explicit bounds
+			foreach(other.variables_integer, v)
+				declare_variable_bounds(*v + offset, true, 0, false, 0);
+			foreach(other.variables_binary, v)
+				declare_variable_bounds(*v + offset, true, 0, true, 1);
+		}
+		else
+		{
+			foreach(other.variables_integer, v)
+				declare_variable_integer(*v + offset);
+			foreach(other.variables_binary, v)
+				declare_variable_binary(*v + offset);
+		}
+	}
+
 };
 
 #endif
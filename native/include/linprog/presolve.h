@@ -0,0 +1,78 @@
+#ifndef LINPROG_PRESOLVE_H
+#define LINPROG_PRESOLVE_H
+
+#include <vector>
+
+#include "linprog/model.h"
+
+class Solution;
+
+// Solver-independent reductions of a LinearProgram:
+//  - variables fixed by their bounds or by singleton equalities are
+//    substituted into all rows,
+//  - singleton inequalities are turned into variable bounds,
+//  - rows that cannot be violated given the variable bounds are dropped,
+//  - duplicate rows are merged, and
+//  - variables that occur in no remaining row are set to their optimal
+//    bound.
+// The remaining variables are renumbered densely in the reduced program,
+// and restore() maps a solution of the reduced program back.
+class PresolvedLinearProgram
+{
+private:
+	typedef std::pair<int, double> Entry;
+
+	const unsigned int num_vars;
+
+	// working copy of the rows; row r uses entries[row_begin[r]..row_end[r])
+	std::vector<Entry> entries;
+	std::vector<unsigned int> row_begin, row_end;
+	std::vector<double> rhs;
+	std::vector<bool> is_equality;
+	std::vector<bool> row_active;
+
+	std::vector<double> cost, lb, ub;
+	std::vector<bool> is_integral, is_binary, is_fixed;
+
+	// value of removed variables, or index in the reduced program
+	std::vector<double> value;
+	std::vector<int> reduced_index;
+
+	LinearProgram reduced;
+	unsigned int num_reduced_vars;
+	bool infeasible;
+
+	void load_rows(const SparseRows &rows, bool equality);
+	void load_bounds(const LinearProgram &lp);
+	bool fix(unsigned int var, double val);
+	bool substitute_fixed(unsigned int r);
+	bool apply_singleton(unsigned int r);
+	bool is_redundant(unsigned int r) const;
+	bool merge_duplicate_rows();
+	void build_reduced();
+
+public:
+	PresolvedLinearProgram(const LinearProgram &lp, unsigned int num_vars);
+
+	// true if the reductions proved the program infeasible
+	bool is_infeasible() const
+	{
+		return infeasible;
+	}
+
+	const LinearProgram &get_reduced() const
+	{
+		return reduced;
+	}
+
+	unsigned int get_num_reduced_vars() const
+	{
+		return num_reduced_vars;
+	}
+
+	// Map a solution of the reduced program (NULL if it has no variables)
+	// back to the original variables. Takes ownership of reduced_sol.
+	Solution *restore(Solution *reduced_sol) const;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef LINPROG_SIMPLEX_H
+#define LINPROG_SIMPLEX_H
+
+#include "linprog/model.h"
+
+class Solution;
+
+enum simplex_status_t
+{
+	SIMPLEX_OPTIMAL,
+	SIMPLEX_INFEASIBLE,
+	SIMPLEX_UNBOUNDED,
+	// numerical trouble
+	SIMPLEX_FAILED,
+	// Branch-and-bound gave up after the maximum number of nodes. Any
+	// integral solution found until then is discarded: it need not be
+	// optimal, and a blocking bound must not be underestimated.
+	SIMPLEX_NODE_LIMIT,
+	// The LP has more rows than set_simplex_max_rows() allows; it was not
+	// attempted.
+	SIMPLEX_TOO_LARGE,
+};
+
+// Solve with the built-in bounded-variable simplex (plus branch-and-bound
+// for integer and binary variables); meant for small, sparse programs.
+// The constraint matrix is stored sparsely, but the basis inverse is kept
+// dense, i.e., each pivot costs O(rows^2) time, and the inverse O(rows^2)
+// memory. This is cheap for the few hundred rows up to which
+// LP_SOLVER_AUTO uses this solver, and LPs beyond get_simplex_max_rows()
+// are refused. Returns NULL if the LP was not solved to optimality. The
+// reason is stored in *status if given; otherwise, it is reported on
+// stderr.
+Solution *simplex_solve(const LinearProgram& lp, unsigned int max_num_vars,
+                        simplex_status_t *status = NULL);
+
+// Maximum number of branch-and-bound nodes per ILP (default: 100000).
+void set_simplex_max_bb_nodes(unsigned long max_nodes);
+unsigned long get_simplex_max_bb_nodes();
+
+// Maximum number of rows (constraints) per LP (default: 2000, i.e., a
+// basis inverse of 32 MB). If LP_SOLVER_NATIVE is selected, larger LPs are
+// handed to an external back end, if one was compiled in.
+void set_simplex_max_rows(unsigned int max_rows);
+unsigned int get_simplex_max_rows();
+
+class LinearProgramSession;
+
+// Session that warm-starts LPs whose constraint matrix equals that of the
+// previous LP (i.e., that differ only in right-hand sides, costs, or
+// variable bounds) from the previous optimal basis. For integer programs,
+// the basis of the root relaxation is carried over. If status is given,
+// each solve() stores its outcome there instead of reporting failures, as
+// in simplex_solve().
+LinearProgramSession *simplex_create_session(simplex_status_t *status = NULL);
+
+#include "linprog/solver.h"
+
+#endif
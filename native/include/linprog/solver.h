@@ -2,12 +2,25 @@
 #define LINPROG_SOLVER_H
 
 #include "linprog/model.h"
+#include "linprog/stats.h"
 
 class Solution
 {
+	// when the solution was returned to the analysis, for the LP statistics
+	double returned_at;
+
+	friend void linprog_stats_solve_end(const LinearProgram &lp,
+	                                    unsigned int num_vars,
+	                                    double start, Solution *sol);
 
 public:
-	virtual ~Solution() {};
+	Solution() : returned_at(-1) {}
+
+	virtual ~Solution()
+	{
+		if (returned_at >= 0)
+			linprog_stats_solution_deleted(returned_at);
+	}
 
 	virtual double get_value(unsigned int variable_index) const = 0;
 
@@ -24,28 +37,55 @@ public:
 	}
 };
 
-#if defined(CONFIG_HAVE_GLPK)
-#include "linprog/glpk.h"
-#elif defined(CONFIG_HAVE_CPLEX)
-#include "linprog/cplex.h"
-#else
-#warning No LP solver available.
-#endif
+// A solver session keeps the solver's internal problem representation (and,
+// if supported by the back end, the last optimal basis) alive across calls,
+// so that a sequence of structurally similar LPs can be solved incrementally.
+// Each call to solve() returns an independent Solution that must be deleted
+// by the caller, or NULL if the LP could not be solved.
+class LinearProgramSession
+{
 
+public:
+	virtual ~LinearProgramSession() {};
 
-static inline Solution *linprog_solve(
-	const LinearProgram& lp,
-	unsigned int max_num_vars)
-{
+	virtual Solution *solve(const LinearProgram& lp,
+	                        unsigned int max_num_vars) = 0;
 
-#if defined(CONFIG_HAVE_GLPK)
-	return glpk_solve(lp, max_num_vars);
-#elif defined(CONFIG_HAVE_CPLEX)
-	return cpx_solve(lp, max_num_vars);
-#else
-	assert(0);
-	return NULL;
-#endif
-}
+	// see linprog_solve_relaxed_first()
+	Solution *solve_relaxed_first(const LinearProgram& lp,
+	                              unsigned int max_num_vars,
+	                              double threshold, bool *exact = NULL);
+};
+
+#include "linprog/dispatch.h"
+#include "linprog/capture.h"
+
+// back end that LP_SOLVER_AUTO (or the forced choice) selects for lp
+lp_solver_t linprog_choose_solver(const LinearProgram& lp,
+                                  unsigned int max_num_vars);
+
+// solve lp with the back end returned by linprog_choose_solver()
+Solution *linprog_solve(const LinearProgram& lp, unsigned int max_num_vars);
+
+// Solve lp only as far as needed to decide whether its optimum exceeds
+// threshold. If lp has integer or binary variables, its LP relaxation is
+// solved first. The relaxed optimum is an upper bound on the optimum of lp,
+// so if it does not exceed threshold, the relaxed solution is returned and
+// the expensive integer solve is skipped. Otherwise (or if the relaxation
+// cannot be solved), lp itself is solved. *exact, if given, is set to
+// false iff the returned solution is that of the relaxation, in which case
+// the objective must be rounded up to obtain a safe integral bound.
+Solution *linprog_solve_relaxed_first(const LinearProgram& lp,
+                                      unsigned int max_num_vars,
+                                      double threshold, bool *exact = NULL);
+
+// Free any per-thread state that the back ends allocated implicitly. Must
+// be called by worker threads that solved LPs before they exit.
+void linprog_release_thread_state();
+
+// Sessions forward each LP to the chosen back end; LPs that go to GLPK
+// are solved incrementally in a persistent GLPK problem, and LPs that go
+// to the built-in solver are warm-started from the previous basis.
+LinearProgramSession *linprog_create_session();
 
 #endif
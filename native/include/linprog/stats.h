@@ -0,0 +1,79 @@
+#ifndef LINPROG_STATS_H
+#define LINPROG_STATS_H
+
+/* Work done by the LP-based analyses, aggregated per analysis. LPs are
+ * attributed to the entry point that generated them (e.g.,
+ * "lp_mpcp_bounds"; see linprog/capture.h), or to "unknown" if solved
+ * outside of an analysis. Times are wall-clock seconds, summed over all
+ * worker threads:
+ *  - build_time:   time the analysis spent before handing each LP to the
+ *                  solver (i.e., generating the model),
+ *  - solve_time:   time spent in the solver, including presolve,
+ *  - extract_time: time from the end of the solve until the analysis
+ *                  deleted the solution (i.e., evaluating it).
+ * rows, cols, and nonzeros are totals over all LPs as generated (before
+ * presolve). iterations counts simplex iterations as reported by the back
+ * end. GLPK exports its iteration counter only from version 4.65 on;
+ * LPs solved with older versions count zero iterations.
+ *
+ * The counters are always enabled; their overhead is a few clock reads
+ * per LP. Each thread keeps its own counters, which are merged when they
+ * are queried. */
+struct LPStats
+{
+	unsigned long num_lps;
+	unsigned long num_failed;
+
+	double build_time;
+	double solve_time;
+	double extract_time;
+
+	unsigned long rows;
+	unsigned long cols;
+	unsigned long nonzeros;
+	unsigned long iterations;
+
+	LPStats()
+		: num_lps(0), num_failed(0),
+		  build_time(0), solve_time(0), extract_time(0),
+		  rows(0), cols(0), nonzeros(0), iterations(0)
+	{}
+};
+
+/* Analyses with recorded LPs, in alphabetical order; index is in
+ * [0, get_lp_stats_num_analyses()). */
+unsigned int get_lp_stats_num_analyses();
+const char *get_lp_stats_analysis(unsigned int index);
+
+/* Counters of one analysis, or the sum over all analyses if analysis is
+ * NULL. Unknown analyses yield all-zero counters. */
+LPStats get_lp_stats(const char *analysis = NULL);
+
+void reset_lp_stats();
+
+#ifndef SWIG
+
+#include "linprog/model.h"
+
+class Solution;
+
+// hooks for the solver front end and LinearProgramOriginScope
+
+// an analysis starts (or ends) generating LPs in the calling thread
+void linprog_stats_begin_analysis();
+void linprog_stats_end_analysis();
+
+// bracket each LP that is handed to a back end
+double linprog_stats_solve_begin();
+void linprog_stats_solve_end(const LinearProgram &lp, unsigned int num_vars,
+                             double start, Solution *sol);
+
+// back ends report the simplex iterations of the current solve
+void linprog_stats_add_iterations(unsigned long num_iterations);
+
+// a solution returned by linprog_stats_solve_end() is deleted
+void linprog_stats_solution_deleted(double returned_at);
+
+#endif
+
+#endif
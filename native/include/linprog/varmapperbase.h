@@ -2,7 +2,9 @@
 #define VARMAPPERBASE_H
 
 #include <stdint.h>
+#include <climits>
 #include <string>
+#include <vector>
 
 #include "stl-helper.h"
 #include "stl-hashmap.h"
@@ -10,18 +12,49 @@
 class VarMapperBase {
 
 private:
+	// keys that are not covered by the dense index
 	hashmap<uint64_t, unsigned int> map;
+
+	// reverse mapping: keys[var - start_var] is the key of variable var
+	std::vector<uint64_t> keys;
+
+	// Dense index over keys that decompose into four coordinates
+	// (c0, c1, c2, c3) with c_i < dense_extent[i]. The slot of a key is
+	// c0 * dense_stride[0] + c1 * dense_stride[1] + c2 * dense_stride[2] + c3.
+	// The innermost extent grows on demand (e.g., request IDs, whose
+	// range is not known up front).
+	std::vector<unsigned int> dense;
+	unsigned int dense_extent[4];
+	size_t dense_stride[3];
+	bool dense_growable;
+
+	unsigned int start_var;
 	unsigned int next_var;
 	bool sealed;
 
-protected:
-	void insert(uint64_t key)
+	enum {
+		NO_VAR = UINT_MAX,
+		// don't let the dense index exceed 4 MiB
+		MAX_DENSE_SLOTS = 1 << 20,
+	};
+
+	void set_dense_layout(unsigned int e0, unsigned int e1,
+	                      unsigned int e2, unsigned int e3);
+	bool grow_dense_index(unsigned int c3);
+
+	unsigned int insert_var(uint64_t key)
 	{
 		assert(next_var < UINT_MAX);
 		assert(!sealed);
 
-		unsigned int idx = next_var++;
-		map[key] = idx;
+		keys.push_back(key);
+		return next_var++;
+	}
+
+protected:
+	void insert(uint64_t key)
+	{
+		map[key] = insert_var(key);
 	}
 
 	bool exists(uint64_t key) const
@@ -41,24 +74,55 @@ protected:
 		return get(key);
 	}
 
+	// Enable the dense index for keys with c0 < e0, c1 < e1, c2 < e2;
+	// e3 is only the initial extent of the innermost coordinate. Must be
+	// called before any variable has been allocated.
+	void set_dense_extents(unsigned int e0, unsigned int e1,
+	                       unsigned int e2, unsigned int e3 = 1);
+
+	// Like var_for_key(), but keys whose coordinates fall into the dense
+	// index are resolved without hashing. Keys outside of the dense index
+	// fall back to the hash map. A given key must always be passed with
+	// the same coordinates.
+	unsigned int var_for_coordinates(uint64_t key,
+	                                 unsigned int c0, unsigned int c1,
+	                                 unsigned int c2, unsigned int c3)
+	{
+		if (c0 < dense_extent[0] && c1 < dense_extent[1]
+		    && c2 < dense_extent[2]
+		    && (c3 < dense_extent[3] || grow_dense_index(c3)))
+		{
+			unsigned int &slot = dense[c0 * dense_stride[0]
+			                           + c1 * dense_stride[1]
+			                           + c2 * dense_stride[2]
+			                           + c3];
+			if (slot == (unsigned int) NO_VAR)
+				slot = insert_var(key);
+			return slot;
+		}
+		else
+			return var_for_key(key);
+	}
+
 	bool search_key_for_var(unsigned int var, uint64_t &key) const
 	{
-		foreach(map, it)
+		if (var >= start_var && var - start_var < keys.size())
 		{
-			if (it->second == var)
-			{
-				key = it->first;
-				return true;
-			}
+			key = keys[var - start_var];
+			return true;
 		}
-		return false;
+		else
+			return false;
 	}
 
 public:
 
 	VarMapperBase(unsigned int start_var = 0)
-		: next_var(start_var), sealed(false)
-	{}
+		: dense_growable(false),
+		  start_var(start_var), next_var(start_var), sealed(false)
+	{
+		set_dense_layout(0, 0, 0, 0);
+	}
 
 
 	// stop new IDs from being generated
@@ -69,7 +133,7 @@ public:
 
 	unsigned int get_num_vars() const
 	{
-		return map.size();
+		return keys.size();
 	}
 
 	unsigned int get_next_var() const
@@ -3,6 +3,78 @@
 
 #include "sharedres_types.h"
 #include "nested_cs.h"
+#include "analysis_budget.h"
+
+/* Number of worker threads used by the *_bounds() analyses below to solve
+ * their independent per-task LPs concurrently, and by the
+ * lp_pedf_*_is_schedulable() tests to analyse the processors concurrently
+ * (abandoning the remaining processors once one fails; the verdict is the
+ * same as in the sequential case). The default of 1 solves them
+ * sequentially in the calling thread; 0 selects one worker per hardware
+ * thread. Parallel solving requires a thread-safe (reentrant) LP solver.
+ */
+void set_lp_analysis_num_threads(unsigned int num_threads);
+unsigned int get_lp_analysis_num_threads();
+
+/* If enabled, the analyses below that generate one LP per task combine
+ * these LPs into a single LP with disjoint variables, which is solved once
+ * (and from which the per-task bounds are then extracted), instead of
+ * invoking the solver once per task. The bounds are the same either way;
+ * merging trades many small solver calls for one large one, which usually
+ * pays off for pure LPs with many small tasks, but can make ILPs (e.g.,
+ * the spinlock analyses) much slower to solve. Disabled by default.
+ * Affects lp_dpcp_bounds(), lp_dflp_bounds(), lp_mpcp_bounds(),
+ * lp_part_fmlp_bounds(), lp_pfp_msrp_bounds(), and the
+ * lp_pfp_*_spinlock_bounds() analyses.
+ */
+void set_lp_merge_task_lps(bool merge);
+bool get_lp_merge_task_lps();
+
+/* Optional per-task decision thresholds for the ILP-based blocking analyses
+ * under P-FP scheduling, i.e., lp_pfp_msrp_bounds(), the
+ * lp_pfp_*_spinlock_bounds() analyses, and lp_nested_fifo_spinlock_bounds().
+ * (The lp_*_bounds_single() variants and the lp_pedf_*() tests do not take
+ * thresholds; the latter already solve relaxations first on their own.)
+ *
+ * If a threshold is set for task i, the analysis first solves the LP
+ * relaxation of task i's ILP. If the relaxed bound does not exceed the
+ * threshold, it is reported (rounded up) instead of the exact ILP bound,
+ * and the costly integer solve is skipped. A caller that only needs
+ * to know whether each task's blocking is at most its threshold (e.g., the
+ * slack that a schedulability test can tolerate) obtains the same answer,
+ * but the reported bounds may be less accurate than the exact ones for
+ * tasks within their thresholds. Tasks without a threshold are always
+ * analyzed exactly.
+ */
+class BlockingThresholds
+{
+	std::vector<unsigned long> thresholds;
+	std::vector<bool> has_thresholds;
+
+public:
+	BlockingThresholds(unsigned int num_tasks)
+		: thresholds(num_tasks), has_thresholds(num_tasks, false)
+	{}
+
+	void set_threshold(unsigned int tsk_index, unsigned long max_blocking)
+	{
+		assert(tsk_index < thresholds.size());
+		thresholds[tsk_index] = max_blocking;
+		has_thresholds[tsk_index] = true;
+	}
+
+	bool has_threshold(unsigned int tsk_index) const
+	{
+		return tsk_index < has_thresholds.size() &&
+		       has_thresholds[tsk_index];
+	}
+
+	unsigned long get_threshold(unsigned int tsk_index) const
+	{
+		assert(has_threshold(tsk_index));
+		return thresholds[tsk_index];
+	}
+};
 
 /* The following analyses are described in the extended version of:
  *
@@ -53,33 +125,41 @@ BlockingBounds* dummy_bounds(const ResourceSharingInfo& info);
  */
 
 /* Analysis of the MSRP under P-FP scheduling */
-BlockingBounds* lp_pfp_msrp_bounds(const ResourceSharingInfo& info);
+BlockingBounds* lp_pfp_msrp_bounds(
+	const ResourceSharingInfo& info,
+	const BlockingThresholds* thresholds = NULL);
 
 /* Analysis of FIFO spin locks with preemptable spinning under P-FP scheduling */
 BlockingBounds* lp_pfp_preemptive_fifo_spinlock_bounds(
-	const ResourceSharingInfo& info);
+	const ResourceSharingInfo& info,
+	const BlockingThresholds* thresholds = NULL);
 
 /* Analysis of unordered spin locks with preemptable and non-preemptable
  * spinning under P-FP scheduling */
 BlockingBounds* lp_pfp_unordered_spinlock_bounds(
 	const ResourceSharingInfo& info,
-	bool preemptive = false);
+	bool preemptive = false,
+	const BlockingThresholds* thresholds = NULL);
 
 /* Basic analysis without any lock-specific constraints. Useful for comparison
  * purposes only. */
-BlockingBounds* lp_pfp_baseline_spinlock_bounds(const ResourceSharingInfo& info);
+BlockingBounds* lp_pfp_baseline_spinlock_bounds(
+	const ResourceSharingInfo& info,
+	const BlockingThresholds* thresholds = NULL);
 
 /* Analysis of priority-ordered spin locks and unordered tie-breaks
  * with preemptable and non-preemptable spinning under P-FP scheduling */
 BlockingBounds* lp_pfp_prio_spinlock_bounds(
 	const ResourceSharingInfo& info,
-	bool preemptive = false);
+	bool preemptive = false,
+	const BlockingThresholds* thresholds = NULL);
 
 /* Analysis of priority-ordered spin locks and FIFO-ordered tie-breaks
  * with preemptable and non-preemptable spinning under P-FP scheduling */
 BlockingBounds* lp_pfp_prio_fifo_spinlock_bounds(
 	const ResourceSharingInfo& info,
-	bool preemptive = false);
+	bool preemptive = false,
+	const BlockingThresholds* thresholds = NULL);
 
 /* Suspension-aware analysis of the priority inheritance protocol under
  * global scheduling.
@@ -125,18 +205,159 @@ BlockingBounds* lp_no_progress_priority_bounds(
 	const ResourceSharingInfo& info,
 	unsigned int number_of_cpus);
 
+/* How far the P-EDF analyses below follow the busy window:
+ *  - PEDF_HORIZON_NONE: until the busy window converges (default).
+ *  - PEDF_HORIZON_SAFE: at most up to the interval length beyond which
+ *    no deadline can be missed, i.e., the smaller of the Zhang-Burns bound
+ *    and the utilization-based bound on the busy window, both extended by
+ *    a closed-form bound on blocking. The verdict is the same as without
+ *    a horizon.
+ *  - PEDF_HORIZON_HYPERPERIOD: as PEDF_HORIZON_SAFE, and additionally give
+ *    up (report "not schedulable") once the busy window exceeds the
+ *    hyper-period of all tasks. The hyper-period saturates instead of
+ *    overflowing, in which case it imposes no limit.
+ */
+enum pedf_horizon_t
+{
+	PEDF_HORIZON_NONE,
+	PEDF_HORIZON_SAFE,
+	PEDF_HORIZON_HYPERPERIOD
+};
+
+void set_pedf_analysis_horizon(pedf_horizon_t horizon);
+pedf_horizon_t get_pedf_analysis_horizon();
+
+/* The P-EDF analyses below optionally take a budget (see analysis_budget.h)
+ * that limits the LPs solved and the time spent; if it runs out, they
+ * return false and budget->get_outcome(false) is OUTCOME_INCONCLUSIVE. */
+
 /* P-EDF MSRP analysis, using blocking-aware PDC */
-bool lp_pedf_msrp_is_schedulable(const ResourceSharingInfo& info);
+bool lp_pedf_msrp_is_schedulable(const ResourceSharingInfo& info,
+                                 AnalysisBudget* budget = NULL);
 
 /* P-EDF FIFO Preemptive spin locks analysis, using blocking-aware PDC */
-bool lp_pedf_fifo_preempt_is_schedulable(const ResourceSharingInfo& info);
+bool lp_pedf_fifo_preempt_is_schedulable(const ResourceSharingInfo& info,
+                                         AnalysisBudget* budget = NULL);
 
 /* P-EDF Lock-Free Synchronization with Preemptive Commit Loops, using blocking aware PDC */
-bool lp_pedf_lockfree_preempt_is_schedulable(const ResourceSharingInfo& info);
+bool lp_pedf_lockfree_preempt_is_schedulable(const ResourceSharingInfo& info,
+                                             AnalysisBudget* budget = NULL);
 
 /* P-EDF Lock-Free Synchronization
  * with NP Commit Loops, using blocking aware PDC */
-bool lp_pedf_lockfree_NP_is_schedulable(const ResourceSharingInfo& info);
+bool lp_pedf_lockfree_NP_is_schedulable(const ResourceSharingInfo& info,
+                                        AnalysisBudget* budget = NULL);
+
+/* Sensitivity analysis of the P-EDF analyses above. For each processor, it
+ * determines the critical scaling factor, i.e., the largest factor f in
+ * [0, max_factor] (to within precision) for which the analysis still finds
+ * the processor schedulable if
+ *  - PEDF_SCALE_REQUEST_LENGTHS: all request lengths, or
+ *  - PEDF_SCALE_WCETS: all costs and all request lengths
+ * are multiplied by f (and rounded up). The given task set corresponds to
+ * f = 1. The factor is found by bisection, which assumes that the verdict
+ * is monotone in f (as the demand and the blocking bounds are). Each
+ * processor keeps its analysis, with its check-point structures and
+ * warm-started LP sessions, across all probes of the bisection, which is
+ * much cheaper than a fresh analysis per probe. The processors are
+ * analysed concurrently if more than one worker thread is configured.
+ *
+ * A processor that is not schedulable even for f = 0 gets a factor of -1.
+ * If the budget (if any) runs out, the bisection of the affected processors
+ * stops early; their factors are then only lower bounds on the critical
+ * ones (-1 if no factor was found schedulable before), and is_inconclusive()
+ * is true for them. The whole task set is schedulable for all f up to
+ * get_min_critical_factor().
+ */
+enum pedf_sensitivity_param_t
+{
+	PEDF_SCALE_REQUEST_LENGTHS,
+	PEDF_SCALE_WCETS
+};
+
+class PEDFSensitivity
+{
+	std::vector<double> critical_factors;
+	std::vector<bool> inconclusive;
+
+public:
+	PEDFSensitivity(unsigned int num_clusters)
+		: critical_factors(num_clusters, 0),
+		  inconclusive(num_clusters, false)
+	{}
+
+	unsigned int get_num_clusters() const
+	{
+		return critical_factors.size();
+	}
+
+	double get_critical_factor(unsigned int cluster) const
+	{
+		assert(cluster < critical_factors.size());
+		return critical_factors[cluster];
+	}
+
+	// true if the budget ran out before the bisection of cluster converged
+	bool is_inconclusive(unsigned int cluster) const
+	{
+		assert(cluster < inconclusive.size());
+		return inconclusive[cluster];
+	}
+
+	// true if the budget ran out for any cluster
+	bool is_inconclusive() const
+	{
+		for (unsigned int c = 0; c < inconclusive.size(); c++)
+			if (inconclusive[c])
+				return true;
+		return false;
+	}
+
+	void set_critical_factor(unsigned int cluster, double factor,
+	                         bool is_lower_bound = false)
+	{
+		assert(cluster < critical_factors.size());
+		critical_factors[cluster] = factor;
+		inconclusive[cluster] = is_lower_bound;
+	}
+
+	double get_min_critical_factor() const
+	{
+		double factor = 0;
+		for (unsigned int c = 0; c < critical_factors.size(); c++)
+			if (!c || critical_factors[c] < factor)
+				factor = critical_factors[c];
+		return factor;
+	}
+};
+
+PEDFSensitivity* lp_pedf_msrp_sensitivity(
+	const ResourceSharingInfo& info,
+	pedf_sensitivity_param_t param = PEDF_SCALE_REQUEST_LENGTHS,
+	double max_factor = 16,
+	double precision = 0.01,
+	AnalysisBudget* budget = NULL);
+
+PEDFSensitivity* lp_pedf_fifo_preempt_sensitivity(
+	const ResourceSharingInfo& info,
+	pedf_sensitivity_param_t param = PEDF_SCALE_REQUEST_LENGTHS,
+	double max_factor = 16,
+	double precision = 0.01,
+	AnalysisBudget* budget = NULL);
+
+PEDFSensitivity* lp_pedf_lockfree_preempt_sensitivity(
+	const ResourceSharingInfo& info,
+	pedf_sensitivity_param_t param = PEDF_SCALE_REQUEST_LENGTHS,
+	double max_factor = 16,
+	double precision = 0.01,
+	AnalysisBudget* budget = NULL);
+
+PEDFSensitivity* lp_pedf_lockfree_NP_sensitivity(
+	const ResourceSharingInfo& info,
+	pedf_sensitivity_param_t param = PEDF_SCALE_REQUEST_LENGTHS,
+	double max_factor = 16,
+	double precision = 0.01,
+	AnalysisBudget* budget = NULL);
 
 /* The following analyses are described in the extended version of:
  *
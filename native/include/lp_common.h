@@ -65,11 +65,14 @@ public:
 		: VarMapperBase(start_var)
 	{}
 
+	// size the dense variable index for the given task set
+	void reserve(const ResourceSharingInfo& info);
+
 	unsigned int lookup(unsigned int task_id, unsigned int res_id, unsigned int req_id,
 	                    blocking_type type)
 	{
 		uint64_t key = encode_request(task_id, res_id, req_id, type);
-		return var_for_key(key);
+		return var_for_coordinates(key, type, task_id, res_id, req_id);
 	}
 
 	std::string key2str(uint64_t key, unsigned int var) const;
@@ -181,6 +184,33 @@ void set_spinlock_blocking_objective(
 		const TaskInfo& ti,
 		LinearProgram& lp);
 
+// generates the LP that bounds the spin blocking of ti in lp and returns
+// its number of variables
+typedef unsigned int (*spinlock_lp_builder_t)(
+		LinearProgram& lp,
+		const ResourceSharingInfo& info,
+		const TaskInfo& ti,
+		bool preemptive);
+
+class BlockingThresholds;
+
+// Bound the spin blocking of all tasks (see solve_task_lps()). Tasks with
+// a threshold are solved relaxation-first (see lp_analysis.h).
+void apply_spinlock_bounds(
+		BlockingBounds& bounds,
+		const ResourceSharingInfo& info,
+		spinlock_lp_builder_t build_lp,
+		bool preemptive,
+		const BlockingThresholds* thresholds = NULL);
+
+// bound the spin blocking of task i only; returns the bound
+unsigned long apply_spinlock_bounds_for_task(
+		unsigned int i,
+		BlockingBounds& bounds,
+		const ResourceSharingInfo& info,
+		spinlock_lp_builder_t build_lp,
+		bool preemptive);
+
 unsigned int get_min_prio(
 		const ResourceSharingInfo& info,
 		const TaskInfo& ti,
@@ -1,6 +1,8 @@
 #ifndef LP_GLOBAL_H
 #define LP_GLOBAL_H
 
+#include <algorithm>
+
 #include "linprog/varmapperbase.h"
 
 class GlobalVarMapper : public VarMapperBase
@@ -76,65 +78,74 @@ class GlobalVarMapper : public VarMapperBase
 
 	};
 
+	// dense coordinates: (variable type and blocking type, task,
+	// resource, request)
+	unsigned int lookup(unsigned int task_id, unsigned int res_id,
+	                    unsigned int cs_id, blocking_type_t btype)
+	{
+		lookup_key_t k;
+
+		k.make_var_for(task_id, res_id, cs_id, btype);
+		return var_for_coordinates(k.raw, btype, task_id, res_id, cs_id);
+	}
+
+	unsigned int lookup_interference(unsigned int task_id,
+	                                 blocking_type_t btype)
+	{
+		lookup_key_t k;
+
+		k.make_interference_var_for(task_id, btype);
+		return var_for_coordinates(k.raw,
+		                           lookup_key_t::BTYPE_MAX + btype,
+		                           task_id, 0, 0);
+	}
+
 public:
+	// size the dense variable index
+	void reserve(unsigned int num_tasks, unsigned int num_resources)
+	{
+		// interference variables are stored with resource ID 0
+		set_dense_extents(2 * lookup_key_t::BTYPE_MAX, num_tasks,
+		                  std::max(num_resources, 1u));
+	}
+
 	unsigned int direct(unsigned int task_id, unsigned int res_id,
 	                    unsigned int cs_id)
 	{
-		lookup_key_t k;
-
-		k.make_var_for(task_id, res_id, cs_id, DIRECT_BLOCKING);
-		return var_for_key(k.raw);
+		return lookup(task_id, res_id, cs_id, DIRECT_BLOCKING);
 	}
 
 	unsigned int indirect(unsigned int task_id, unsigned int res_id,
 	                      unsigned int cs_id)
 	{
-		lookup_key_t k;
-
-		k.make_var_for(task_id, res_id, cs_id, INDIRECT_BLOCKING);
-		return var_for_key(k.raw);
+		return lookup(task_id, res_id, cs_id, INDIRECT_BLOCKING);
 	}
 
 	unsigned int preemption(unsigned int task_id, unsigned int res_id,
 	                        unsigned int cs_id)
 	{
-		lookup_key_t k;
-
-		k.make_var_for(task_id, res_id, cs_id, PREEMPTION_BLOCKING);
-		return var_for_key(k.raw);
+		return lookup(task_id, res_id, cs_id, PREEMPTION_BLOCKING);
 	}
 
 	unsigned int expelling(unsigned int task_id, unsigned int res_id,
 	                       unsigned int cs_id)
 	{
-		lookup_key_t k;
-
-		k.make_var_for(task_id, res_id, cs_id, EXPELLING_BLOCKING);
-		return var_for_key(k.raw);
+		return lookup(task_id, res_id, cs_id, EXPELLING_BLOCKING);
 	}
 
 	unsigned int regular_interference(unsigned int task_id)
 	{
-		lookup_key_t k;
-
-		k.make_interference_var_for(task_id, REGULAR_INTERFERENCE);
-		return var_for_key(k.raw);
+		return lookup_interference(task_id, REGULAR_INTERFERENCE);
 	}
 
 	unsigned int co_boosting_interference(unsigned int task_id)
 	{
-		lookup_key_t k;
-
-		k.make_interference_var_for(task_id, CO_BOOSTING_INTERFERENCE);
-		return var_for_key(k.raw);
+		return lookup_interference(task_id, CO_BOOSTING_INTERFERENCE);
 	}
 
 	unsigned int stalling_interference(unsigned int task_id)
 	{
-		lookup_key_t k;
-
-		k.make_interference_var_for(task_id, STALLING_INTERFERENCE);
-		return var_for_key(k.raw);
+		return lookup_interference(task_id, STALLING_INTERFERENCE);
 	}
 
 	std::string key2str(uint64_t key, unsigned int var) const;
@@ -0,0 +1,382 @@
+#ifndef LP_PARALLEL_H_
+#define LP_PARALLEL_H_
+
+#include <assert.h>
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "stl-helper.h"
+#include "linprog/solver.h"
+#include "lp_analysis.h"
+
+// Number of worker threads that should be used to process num_jobs
+// independent per-task LPs. Follows set_lp_analysis_num_threads().
+unsigned int lp_analysis_workers_for(unsigned int num_jobs);
+
+// Call job(i) for each i in [0, num_jobs) on a pool of num_workers threads
+// (including the calling thread), which take the next job until all jobs
+// have been started or stop is set. The first exception thrown by any job
+// sets stop and is rethrown in the caller once all workers have stopped.
+template <typename Job>
+void run_jobs_in_pool(unsigned int num_jobs, unsigned int num_workers,
+                      std::atomic<bool> &stop, Job job)
+{
+	std::atomic<unsigned int> next_job(0);
+	std::exception_ptr error;
+	std::mutex error_lock;
+
+	auto run_jobs = [&]() {
+		unsigned int i;
+		while (!stop && (i = next_job++) < num_jobs)
+		{
+			try
+			{
+				job(i);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> guard(error_lock);
+				if (!error)
+					error = std::current_exception();
+				stop = true;
+			}
+		}
+	};
+
+	std::vector<std::thread> pool;
+	pool.reserve(num_workers - 1);
+	for (unsigned int w = 1; w < num_workers; w++)
+		pool.push_back(std::thread([&]() {
+			run_jobs();
+			// drop the solver state that this worker accumulated
+			linprog_release_thread_state();
+		}));
+
+	// the calling thread helps out, but keeps its solver state
+	run_jobs();
+
+	foreach(pool, t)
+		t->join();
+
+	if (error)
+		std::rethrow_exception(error);
+}
+
+// Call job(i) for each i in [0, num_tasks). With more than one worker
+// thread configured, the calls are distributed dynamically over a pool of
+// workers, so job() must only write to per-task state (e.g., (*results)[i])
+// and must not share an LP, VarMapper, or solver session with other tasks.
+// The first exception thrown by any job is rethrown in the caller once all
+// workers have stopped. LPs generated by job(i) are attributed to task i
+// of the caller's analysis (see linprog/capture.h).
+template <typename Job>
+void foreach_task_parallel(unsigned int num_tasks, Job task_job)
+{
+	unsigned int num_workers = lp_analysis_workers_for(num_tasks);
+	const LinearProgramOrigin origin = linprog_get_origin();
+
+	auto job = [&](unsigned int i) {
+		LinearProgramOriginScope scope(
+			LinearProgramOrigin(origin.analysis, i, origin.interval));
+		task_job(i);
+	};
+
+	if (num_workers <= 1)
+	{
+		for (unsigned int i = 0; i < num_tasks; i++)
+			job(i);
+		return;
+	}
+
+	std::atomic<bool> failed(false);
+	run_jobs_in_pool(num_tasks, num_workers, failed, job);
+}
+
+// Return true iff test(c, cancelled) returns true for every cluster c in
+// [0, num_clusters). Sequentially, the clusters are tested in order and
+// the first failing cluster ends the loop. With more than one worker
+// thread configured, the clusters are tested concurrently; once a test
+// fails, cancelled is set and no further clusters are started. Tests that
+// are still running may poll cancelled and give up early, since their
+// result no longer matters. The same restrictions as for
+// foreach_task_parallel() apply to test().
+template <typename Test>
+bool forall_clusters_parallel(unsigned int num_clusters, Test test)
+{
+	unsigned int num_workers = lp_analysis_workers_for(num_clusters);
+	std::atomic<bool> cancelled(false);
+
+	if (num_workers <= 1)
+	{
+		for (unsigned int c = 0; c < num_clusters; c++)
+			if (!test(c, cancelled))
+				return false;
+		return true;
+	}
+
+	const LinearProgramOrigin origin = linprog_get_origin();
+
+	run_jobs_in_pool(num_clusters, num_workers, cancelled, [&](unsigned int c) {
+		LinearProgramOriginScope scope(origin);
+		if (!test(c, cancelled))
+			cancelled = true;
+	});
+
+	return !cancelled;
+}
+
+// Call job(c) for each cluster c in [0, num_clusters). Unlike
+// forall_clusters_parallel(), every cluster is processed; with more than
+// one worker thread configured, the clusters are processed concurrently.
+// The same restrictions as for foreach_task_parallel() apply to job().
+template <typename Job>
+void foreach_cluster_parallel(unsigned int num_clusters, Job job)
+{
+	unsigned int num_workers = lp_analysis_workers_for(num_clusters);
+
+	if (num_workers <= 1)
+	{
+		for (unsigned int c = 0; c < num_clusters; c++)
+			job(c);
+		return;
+	}
+
+	const LinearProgramOrigin origin = linprog_get_origin();
+	std::atomic<bool> failed(false);
+
+	run_jobs_in_pool(num_clusters, num_workers, failed, [&](unsigned int c) {
+		LinearProgramOriginScope scope(origin);
+		job(c);
+	});
+}
+
+// True if solve_task_lps() should combine all per-task LPs into a single
+// LP. Follows set_lp_merge_task_lps().
+bool lp_analysis_merge_task_lps();
+
+// A view of the solution of a merged LP that exposes one of the LPs that
+// were merged into it under its original variable indices.
+class ShiftedSolution : public Solution
+{
+	const Solution &merged;
+	const unsigned int offset;
+
+public:
+	ShiftedSolution(const Solution &merged, unsigned int offset)
+		: merged(merged), offset(offset)
+	{}
+
+	double get_value(unsigned int variable_index) const
+	{
+		return merged.get_value(variable_index + offset);
+	}
+};
+
+// Solve lp until extract() no longer asks for another round (see below).
+// If thresholds gives a threshold for task i, each round is solved with
+// linprog_solve_relaxed_first().
+template <typename Extract>
+void solve_task_lp(unsigned int i, LinearProgram &lp, unsigned int num_vars,
+                   Extract &extract, const BlockingThresholds *thresholds)
+{
+	bool again;
+	do
+	{
+		Solution *sol;
+		bool exact = true;
+
+		if (thresholds && thresholds->has_threshold(i))
+			sol = linprog_solve_relaxed_first(lp, num_vars,
+				thresholds->get_threshold(i), &exact);
+		else
+			sol = linprog_solve(lp, num_vars);
+
+		assert(sol != NULL);
+		again = extract(i, lp, *sol, exact);
+		delete sol;
+	} while (again);
+}
+
+// Generate and solve one LP for each task in [0, num_tasks).
+// build(i, lp) generates the LP of task i in the empty LP lp and returns its
+// number of variables. extract(i, lp, sol, exact) is then called with an
+// optimal solution of lp. It can change lp's objective and return true to
+// have the LP solved again (e.g., to maximize a second component of the
+// blocking bound), or return false once all results of task i have been
+// recorded.
+//
+// Tasks for which thresholds (if not NULL) gives a threshold are solved
+// relaxation-first (see linprog_solve_relaxed_first()): if the optimum of
+// the LP relaxation does not exceed the threshold, extract() is called with
+// the relaxed solution and exact == false, and must round its bounds up.
+// Otherwise, and for all other tasks, exact is true.
+//
+// By default, each LP is solved on its own by foreach_task_parallel(). If
+// set_lp_merge_task_lps(true) has been called, the per-task LPs are instead
+// combined into one block-diagonal LP (with disjoint variables) whose
+// objective is the sum of the per-task objectives, which is solved once
+// per round; since the blocks are independent, each block of an optimal
+// solution is an optimal solution of the corresponding per-task LP. This
+// replaces num_tasks small solver invocations with a single large one.
+// With thresholds, the relaxation of the merged LP is solved first in each
+// round, with the objectives of the tasks that have a threshold, and only
+// the tasks that it does not decide enter the merged ILP. If the merged LP
+// cannot be solved, the per-task LPs are solved individually.
+template <typename Build, typename Extract>
+void solve_task_lps(unsigned int num_tasks, Build build, Extract extract,
+                    const BlockingThresholds *thresholds)
+{
+	if (!lp_analysis_merge_task_lps())
+	{
+		foreach_task_parallel(num_tasks, [&](unsigned int i)
+		{
+			LinearProgram lp;
+			unsigned int num_vars = build(i, lp);
+			solve_task_lp(i, lp, num_vars, extract, thresholds);
+		});
+		return;
+	}
+
+	std::vector<LinearProgram*> lps(num_tasks);
+	std::vector<unsigned int> num_vars(num_tasks);
+
+	foreach_task_parallel(num_tasks, [&](unsigned int i)
+	{
+		lps[i] = new LinearProgram();
+		num_vars[i] = build(i, *lps[i]);
+	});
+
+	// task i's variables start at offset[i] in the merged LP
+	std::vector<unsigned int> offset(num_tasks);
+	LinearProgram merged;
+	unsigned int total_vars = 0;
+
+	for (unsigned int i = 0; i < num_tasks; i++)
+	{
+		offset[i] = total_vars;
+		merged.append(*lps[i], offset[i]);
+		total_vars += num_vars[i];
+	}
+
+	// the LP relaxation of merged, if there are thresholds to check
+	LinearProgram *relaxed = NULL;
+	if (thresholds && (merged.has_integer_variables() ||
+	                   merged.has_binary_variables()))
+	{
+		relaxed = new LinearProgram();
+		relaxed->append(merged, 0, true);
+	}
+
+	// the sum of the objectives of the given tasks
+	auto merged_objective = [&](const std::vector<unsigned int> &tasks)
+	{
+		LinearExpression *obj = new LinearExpression();
+		foreach(tasks, i)
+			foreach(lps[*i]->get_objective()->get_terms(), term)
+				obj->add_term(term->first, term->second + offset[*i]);
+		return obj;
+	};
+
+	const LinearProgramOrigin origin = linprog_get_origin();
+
+	auto solve_individually = [&](unsigned int i)
+	{
+		LinearProgramOriginScope scope(LinearProgramOrigin(
+			origin.analysis, i, origin.interval));
+		solve_task_lp(i, *lps[i], num_vars[i], extract, thresholds);
+	};
+
+	// tasks whose extract() asked for another round
+	std::vector<unsigned int> pending;
+	for (unsigned int i = 0; i < num_tasks; i++)
+		pending.push_back(i);
+
+	while (!pending.empty())
+	{
+		std::vector<unsigned int> again;
+
+		// tasks that must be solved exactly in this round
+		std::vector<unsigned int> unresolved;
+
+		std::vector<unsigned int> relaxable;
+		foreach(pending, i)
+			if (relaxed && thresholds->has_threshold(*i))
+				relaxable.push_back(*i);
+			else
+				unresolved.push_back(*i);
+
+		if (!relaxable.empty())
+		{
+			relaxed->set_objective(merged_objective(relaxable));
+			Solution *sol = linprog_solve(*relaxed, total_vars);
+
+			foreach(relaxable, i)
+			{
+				if (!sol)
+				{
+					unresolved.push_back(*i);
+					continue;
+				}
+
+				ShiftedSolution task_sol(*sol, offset[*i]);
+				const LinearExpression &obj = *lps[*i]->get_objective();
+				if (task_sol.evaluate(obj) > thresholds->get_threshold(*i))
+					unresolved.push_back(*i);
+				else if (extract(*i, *lps[*i], task_sol, false))
+					again.push_back(*i);
+			}
+
+			delete sol;
+		}
+
+		if (!unresolved.empty())
+		{
+			merged.set_objective(merged_objective(unresolved));
+			Solution *sol = linprog_solve(merged, total_vars);
+
+			if (!sol)
+			{
+				foreach(unresolved, i)
+					solve_individually(*i);
+				foreach(again, i)
+					solve_individually(*i);
+				break;
+			}
+
+			foreach(unresolved, i)
+			{
+				ShiftedSolution task_sol(*sol, offset[*i]);
+				if (extract(*i, *lps[*i], task_sol, true))
+					again.push_back(*i);
+			}
+
+			delete sol;
+		}
+
+		pending.swap(again);
+	}
+
+	delete relaxed;
+	foreach(lps, lp)
+		delete *lp;
+}
+
+// As above, for analyses without thresholds, whose extract(i, lp, sol) is
+// always given an exact solution.
+template <typename Build, typename Extract>
+void solve_task_lps(unsigned int num_tasks, Build build, Extract extract)
+{
+	solve_task_lps(num_tasks, build,
+		[&](unsigned int i, LinearProgram &lp, const Solution &sol,
+		    bool exact)
+		{
+			return extract(i, lp, sol);
+		},
+		NULL);
+}
+
+#endif /* LP_PARALLEL_H_ */
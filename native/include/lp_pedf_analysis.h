@@ -10,27 +10,222 @@
 // Enable debug prints:
 // #define __DEBUG_PEDF_BLK_ANALYSIS__
 
-// Enable the stop of the analysis loop at the hyper-period of all
-// the tasks in the system:
-// #define __PEDF_BLK_ANALYSIS_ENABLE_HP_STOP__
-
-// Enable a timeout for the analysis loop:
-// Warning: based on SIGALARM, hence not 100% portable
-// #define  __PEDF_BLK_ANALYSIS_ENABLE_TIMEOUT__
-
 // ------------------------------------------------------------------
 
+#include <atomic>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "linprog/solver.h"
+#include "analysis_budget.h"
+#include "lp_analysis.h"
 
 // Default value used for blocking lower-bound
 static unsigned long AVAL = 0;
 
+enum analysis_type_t
+{
+    AC_MODE, // compute LP for an arrival curve
+    PDC_MODE // compute processor-demand criterion LP
+};
+
+// The blocking LPs depend on the interval length t only via the numbers of
+// local and remote jobs of each task and via which deadlines lie within t.
+// All interval lengths that agree in these step functions form a region in
+// which the LP, and hence the blocking bound, is the same. This caches the
+// bounds of one kind of LP as a piecewise constant function over such
+// regions, each of which is identified by the values of the step functions.
+// The relaxed bound and, once computed, the tightened bound of a region
+// are kept together. The regions of the check points visited so far are
+// indexed by check point, so that repeated queries for the same interval
+// length (e.g., for the relaxed and then the tightened bound, or in later
+// rounds of the fixed-point iteration) skip the computation of the region.
+class PiecewiseBlockingBound
+{
+  public:
+    typedef std::vector<unsigned long> region_t;
+
+    struct Bounds
+    {
+        unsigned long relaxed;
+        bool has_tight;
+        unsigned long tight;
+    };
+
+    Bounds* lookup(unsigned long interval_length) const
+    {
+        std::map<unsigned long, Bounds*>::const_iterator it =
+            check_points.find(interval_length);
+        return it == check_points.end() ? NULL : it->second;
+    }
+
+    Bounds* lookup(const region_t& region, unsigned long interval_length)
+    {
+        std::map<region_t, Bounds>::iterator it = regions.find(region);
+        if (it == regions.end())
+            return NULL;
+        check_points[interval_length] = &it->second;
+        return &it->second;
+    }
+
+    Bounds* insert(const region_t& region, unsigned long interval_length,
+                   unsigned long relaxed)
+    {
+        Bounds& b = regions[region];
+        b.relaxed = relaxed;
+        b.has_tight = false;
+        b.tight = 0;
+        check_points[interval_length] = &b;
+        return &b;
+    }
+
+  private:
+    std::map<region_t, Bounds> regions;
+    std::map<unsigned long, Bounds*> check_points;
+};
+
+// A weighted sum of periodic step functions, evaluated incrementally.
+// Step function k counts the points first_k + j * period_k (j >= 0) that
+// are <= t. The sum is kept up to date for the current t, and moving t
+// only touches the step functions that have a point between the old and
+// the new t, each in O(log n). The analysis moves t in small steps (QPA
+// walks down the check points, the fixed-point iteration creeps up), so
+// a move usually costs O(log n) rather than the O(n) of a full sum.
+class IncrementalStepSum
+{
+  public:
+    IncrementalStepSum() : position(0), total(0) {}
+
+    void add(unsigned long first, unsigned long period, unsigned long weight);
+
+    void move_to(unsigned long t);
+
+    // change the weight of the k-th step function added
+    void set_weight(unsigned int k, unsigned long weight)
+    {
+        total -= steps[k].count * steps[k].weight;
+        steps[k].weight = weight;
+        total += steps[k].count * weight;
+    }
+
+    // sum of weight_k * (number of points of k that are <= t)
+    unsigned long value() const
+    {
+        return total;
+    }
+
+    // largest point <= t of any step function; false if there is none
+    bool last_point(unsigned long& point) const
+    {
+        if (last_points.empty())
+            return false;
+        point = last_points.rbegin()->first;
+        return true;
+    }
+
+  private:
+    typedef std::set<std::pair<unsigned long, unsigned int> > point_set_t;
+
+    struct Step
+    {
+        unsigned long first, period, weight;
+        unsigned long count; // number of points <= position
+    };
+
+    unsigned long count_at(const Step& s, unsigned long t) const
+    {
+        return t < s.first ? 0 : (t - s.first) / s.period + 1;
+    }
+
+    void update(unsigned int k, unsigned long t);
+
+    std::vector<Step> steps;
+    unsigned long position;
+    unsigned long total;
+
+    // for each step function, the largest point <= position (if any) and
+    // the smallest point > position
+    point_set_t last_points;
+    point_set_t next_points;
+};
+
+// The caches above can be bypassed, so that every blocking bound is
+// computed from scratch (by solving its LP). The verdicts and the bounds
+// must be the same either way; this is only useful for cross-checking
+// the caches. Enabled by default.
+void set_pedf_bound_caching(bool enabled);
+bool get_pedf_bound_caching();
+
+// A blocking bound used by an analysis at one interval length: either an
+// AC bound of the fixed-point iteration over the busy window, or a PDC
+// bound at a QPA check point. For the latter, relaxed is the bound that
+// QPA compared first (closed-form or relaxed LP), and tight the tightened
+// bound if QPA needed it.
+struct PEDFCheckPoint
+{
+    unsigned int cluster;
+    analysis_type_t mode;
+    unsigned long interval_length;
+    unsigned long relaxed;
+    bool has_tight;
+    unsigned long tight;
+};
+
+// Append the bounds used by all analyses that run in the calling thread,
+// in order, to *trace (or stop recording if trace is NULL). For testing.
+void set_pedf_check_point_trace(std::vector<PEDFCheckPoint>* trace);
+
 class PEDFBlockingAnalysis
 {
   public:
     PEDFBlockingAnalysis(const ResourceSharingInfo& _info, unsigned int _cluster);
+    virtual ~PEDFBlockingAnalysis();
 
     bool is_schedulable();
 
+    // If *flag becomes true while is_schedulable() runs, the analysis
+    // stops at the next check point and reports the cluster as not
+    // schedulable. Used to abandon the remaining clusters once one of
+    // them has been found unschedulable.
+    void set_cancellation_flag(const std::atomic<bool>* flag)
+    {
+        cancelled = flag;
+    }
+
+    // Charge the LPs solved and the CPU time used to budget (see
+    // analysis_budget.h) and give up like above once it is exhausted.
+    void set_budget(AnalysisBudget* budget)
+    {
+        meter = AnalysisBudget::Meter(budget);
+    }
+
+    // To be called after the costs or request lengths of the tasks in
+    // info have been changed in place (see
+    // ResourceSharingInfo::set_scaled_parameters()), before the next
+    // is_schedulable(). Drops the cached blocking bounds, but keeps the
+    // check-point structures and the solver sessions, whose last bases
+    // warm-start the LPs of the next run.
+    void parameters_changed();
+
+    // For testing: the relaxed PDC bound at interval_length, solved from
+    // scratch, and the closed-form bounds on it (see below), if any.
+    unsigned long solve_blocking_PDC(unsigned long interval_length)
+    {
+        return compute_blocking_PDC(interval_length);
+    }
+
+    bool get_closed_form_blocking_PDC(unsigned long interval_length,
+                                      unsigned long& blk_UB)
+    {
+        return closed_form_blocking_PDC(interval_length, blk_UB);
+    }
+
+    bool get_closed_form_blocking_rate_PDC(double& rate, double& offset)
+    {
+        return closed_form_blocking_rate_PDC(rate, offset);
+    }
+
   protected:
     virtual unsigned long compute_blocking_PDC(unsigned long interval_length) = 0;
     virtual unsigned long compute_blocking_AC (unsigned long interval_length) = 0;
@@ -42,25 +237,119 @@ class PEDFBlockingAnalysis
         return blk_UB;
     }
 
+    // Optional closed-form upper bound on compute_blocking_PDC(), which
+    // lets QPA accept check points without solving any LP. Returns false
+    // if the analysis has no such bound.
+    virtual bool closed_form_blocking_PDC(unsigned long interval_length,
+                                          unsigned long& blk_UB)
+    {
+        return false;
+    }
+
+    // Affine form of the above, valid for all interval lengths t:
+    // closed_form_blocking_PDC(t) <= rate * t + offset.
+    virtual bool closed_form_blocking_rate_PDC(double& rate, double& offset)
+    {
+        return false;
+    }
+
+    // Drop any state that an analysis carries from one LP to the next
+    // within a run of is_schedulable() (see parameters_changed()).
+    virtual void reset_blocking_state() {}
+
+    unsigned long last_check_point_before(unsigned long interval_length);
+
     const ResourceSharingInfo& info;
     unsigned int cluster;
     unsigned int max_deadline, min_deadline;
 
+    // Persistent solver sessions, one for each kind of LP that is solved
+    // at every check point. Consecutive LPs of the same kind differ only
+    // in a few bounds, so they are updated in place and warm-started.
+    // Only the solver's copy is updated, though: the analyses still build
+    // the complete LinearProgram for each check point, and the session
+    // finds the changed rows by comparing it with the previous one.
+    LinearProgramSession *ac_session;
+    LinearProgramSession *pdc_session;
+    LinearProgramSession *tight_pdc_session;
+
   private:
+    // Look up the bounds of the step region of interval_length, and
+    // solve only if the analysis has not yet visited that region.
+    PiecewiseBlockingBound::Bounds& bounds_at(analysis_type_t mode,
+                                              unsigned long interval_length);
+    unsigned long blocking_PDC(unsigned long interval_length);
+    unsigned long blocking_AC (unsigned long interval_length);
+    unsigned long tighter_blocking_PDC(unsigned long interval_length,
+                                       unsigned long blk_UB,
+                                       unsigned long blk_LB);
+
+    unsigned long safe_horizon();
+
+    void trace(analysis_type_t mode, unsigned long interval_length,
+               unsigned long relaxed, bool has_tight = false,
+               unsigned long tight = 0) const;
+
+    void step_region(unsigned long interval_length,
+                     PiecewiseBlockingBound::region_t& region) const;
+
+    bool is_cancelled() const
+    {
+        return cancelled && *cancelled;
+    }
+
+    const std::atomic<bool>* cancelled;
+    AnalysisBudget::Meter meter;
+
+    bool should_stop()
+    {
+        return is_cancelled() || meter.exhausted();
+    }
+
+    PiecewiseBlockingBound ac_bounds;
+    PiecewiseBlockingBound pdc_bounds;
+
+    // holds the bounds returned by bounds_at() if caching is disabled
+    PiecewiseBlockingBound::Bounds uncached;
+
+    // DBF, arrival curve, and the steps of the remote job counts, which
+    // together define the check points of the PDC
+    IncrementalStepSum local_demand;
+    IncrementalStepSum local_arrivals;
+    IncrementalStepSum remote_arrivals;
 
     //bool processorDemandCriterion(std::map<int, unsigned int>& nJobs, unsigned long maxTime);
     bool QPA(unsigned long t_LB, unsigned long t_UB, unsigned long blk_LB_in = 0, unsigned long& blk_LB_out = AVAL);
     bool raw_PDC(unsigned long t_LB, unsigned long t_UB);
     unsigned long DBF(unsigned long interval_length);
     unsigned long arrival_curve(unsigned long interval_length);
-    unsigned long last_check_point_before(unsigned long interval_length);
 
 };
 
-enum analysis_type_t
-{
-    AC_MODE, // compute LP for an arrival curve
-    PDC_MODE // compute processor-demand criterion LP
-};
+typedef PEDFBlockingAnalysis* (*pedf_analysis_factory_t)(const ResourceSharingInfo& info,
+                                                         unsigned int cluster);
+
+// Hyper-period of all tasks in info, or ULONG_MAX if it does not fit (see
+// PEDF_HORIZON_HYPERPERIOD)
+unsigned long saturating_hyper_period(const ResourceSharingInfo& info);
+
+// The analyses behind the lp_pedf_*_is_schedulable() entry points
+PEDFBlockingAnalysis* make_pedf_msrp_analysis(const ResourceSharingInfo& info,
+                                              unsigned int cluster);
+PEDFBlockingAnalysis* make_pedf_fifo_preempt_analysis(const ResourceSharingInfo& info,
+                                                      unsigned int cluster);
+PEDFBlockingAnalysis* make_pedf_lockfree_preempt_analysis(const ResourceSharingInfo& info,
+                                                          unsigned int cluster);
+PEDFBlockingAnalysis* make_pedf_lockfree_NP_analysis(const ResourceSharingInfo& info,
+                                                     unsigned int cluster);
+
+// Sensitivity analysis behind the lp_pedf_*_sensitivity() entry points
+// (see lp_analysis.h), for the analysis created by make_analysis.
+PEDFSensitivity* lp_pedf_sensitivity(const ResourceSharingInfo& info,
+                                     pedf_analysis_factory_t make_analysis,
+                                     pedf_sensitivity_param_t param,
+                                     double max_factor,
+                                     double precision,
+                                     AnalysisBudget* budget);
 
 #endif
\ No newline at end of file
@@ -52,30 +52,38 @@ class LockFreeVarMapper : public VarMapperBase
 		}
 	};
 
+	// dense coordinates: (type, task i, resource, task j)
+	unsigned int lookup(unsigned int task_i_id, unsigned int task_j_id,
+	                    unsigned int res_id, variable_type_t vtype)
+	{
+		lookup_key_t k;
+
+		k.make_var_for(task_i_id, task_j_id, res_id, vtype);
+		return var_for_coordinates(k.raw, vtype, task_i_id, res_id,
+		                           task_j_id);
+	}
+
 public:
+	// size the dense variable index
+	void reserve(unsigned int num_tasks, unsigned int num_resources)
+	{
+		set_dense_extents(lookup_key_t::VTYPE_MAX, num_tasks, num_resources);
+	}
+
 	unsigned int local_conflicts(unsigned int task_i_id, unsigned int task_j_id,
                                 unsigned int res_id)
 	{
-		lookup_key_t k;
-
-		k.make_var_for(task_i_id, task_j_id, res_id, LOCAL_CONFLICT);
-		return var_for_key(k.raw);
+		return lookup(task_i_id, task_j_id, res_id, LOCAL_CONFLICT);
 	}
 
 	unsigned int remote_conflicts(unsigned int task_id, unsigned int res_id)
 	{
-		lookup_key_t k;
-
-		k.make_var_for(task_id, 0, res_id, REMOTE_CONFLICT);
-		return var_for_key(k.raw);
+		return lookup(task_id, 0, res_id, REMOTE_CONFLICT);
 	}
 
     unsigned int indicator_arrival(unsigned int task_id, unsigned int res_id)
 	{
-		lookup_key_t k;
-
-		k.make_var_for(task_id, 0, res_id, INDICATOR_ARRIVAL_BLOCKING);
-		return var_for_key(k.raw);
+		return lookup(task_id, 0, res_id, INDICATOR_ARRIVAL_BLOCKING);
 	}
 
 	std::string key2str(uint64_t key, unsigned int var) const;
@@ -139,7 +147,26 @@ public:
         unsigned long blocking_UB = 0,
         bool relax = true);
 
-	unsigned long solve(bool verbose = false);
+	// If a session is given, the LP is solved incrementally within it.
+	unsigned long solve(bool verbose = false,
+	                    LinearProgramSession *session = NULL);
+
+	// Closed-form upper bound on the retries caused by remote commits in
+	// any LP that includes the generic constraints: each remote commit
+	// causes a retry of the longest local commit to the same resource.
+	static unsigned long closed_form_remote_bound(const ResourceSharingInfo& info,
+	                                              unsigned int cluster,
+	                                              unsigned long interval_length);
+
+	// closed_form_remote_bound(t) <= rate * t + offset for all t
+	static void closed_form_remote_bound_rate(const ResourceSharingInfo& info,
+	                                          unsigned int cluster,
+	                                          double& rate, double& offset);
+
+	// The longest local commit to resource q (0 if there is none).
+	static unsigned long max_local_commit_length(const ResourceSharingInfo& info,
+	                                             unsigned int cluster,
+	                                             unsigned int q);
 };
 
 #endif
@@ -50,37 +50,40 @@ class SpinVarMapper : public VarMapperBase
 		}
 	};
 
-public:
-	unsigned int spin(unsigned int task_id, unsigned int res_id)
+	unsigned int lookup(unsigned int task_id, unsigned int res_id,
+	                    variable_type_t vtype)
 	{
 		lookup_key_t k;
 
-		k.make_var_for(task_id, res_id, SPIN_BLOCKING);
-		return var_for_key(k.raw);
+		k.make_var_for(task_id, res_id, vtype);
+		return var_for_coordinates(k.raw, vtype, task_id, res_id, 0);
 	}
 
-	unsigned int arrival(unsigned int task_id, unsigned int res_id)
+public:
+	// size the dense variable index
+	void reserve(unsigned int num_tasks, unsigned int num_resources)
 	{
-		lookup_key_t k;
+		set_dense_extents(lookup_key_t::VTYPE_MAX, num_tasks, num_resources);
+	}
+
+	unsigned int spin(unsigned int task_id, unsigned int res_id)
+	{
+		return lookup(task_id, res_id, SPIN_BLOCKING);
+	}
 
-		k.make_var_for(task_id, res_id, ARRIVAL_BLOCKING);
-		return var_for_key(k.raw);
+	unsigned int arrival(unsigned int task_id, unsigned int res_id)
+	{
+		return lookup(task_id, res_id, ARRIVAL_BLOCKING);
 	}
 
     unsigned int indicator_arrival(unsigned int res_id)
 	{
-		lookup_key_t k;
-
-		k.make_var_for(0, res_id, INDICATOR_ARRIVAL_BLOCKING);
-		return var_for_key(k.raw);
+		return lookup(0, res_id, INDICATOR_ARRIVAL_BLOCKING);
 	}
 
     unsigned int cancellations(unsigned int task_id, unsigned int res_id)
 	{
-		lookup_key_t k;
-
-		k.make_var_for(task_id, res_id, CANCELLATIONS);
-		return var_for_key(k.raw);
+		return lookup(task_id, res_id, CANCELLATIONS);
 	}
 
 	std::string key2str(uint64_t key, unsigned int var) const;
@@ -157,7 +160,22 @@ public:
 		unsigned long interval_length,
         unsigned int cluster);
 
-	unsigned long solve(bool verbose = false);
+	// If a session is given, the LP is solved incrementally within it.
+	unsigned long solve(bool verbose = false,
+	                    LinearProgramSession *session = NULL);
+
+	// Closed-form upper bound on the solution of any PDC-mode LP that
+	// includes the generic constraints: every remote request is counted
+	// in full (Constraint 10), plus the longest local request that can
+	// cause arrival blocking (Constraints 8, 11, and 14).
+	static unsigned long closed_form_bound_PDC(const ResourceSharingInfo& info,
+	                                           unsigned int cluster,
+	                                           unsigned long interval_length);
+
+	// closed_form_bound_PDC(t) <= rate * t + offset for all t
+	static void closed_form_bound_rate_PDC(const ResourceSharingInfo& info,
+	                                       unsigned int cluster,
+	                                       double& rate, double& offset);
 };
 
 #endif
\ No newline at end of file
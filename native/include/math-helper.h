@@ -36,5 +36,29 @@ static inline integral_t round_up(const fractional_t &f)
 	return result;
 }
 
+static inline fixed_integral_t divide_with_ceil(const fixed_integral_t &numer,
+						const fixed_integral_t &denom)
+{
+	fixed_integral_t result = numer / denom;
+	if (numer % denom != 0 && (numer > 0) == (denom > 0))
+		result += 1;
+	return result;
+}
+
+static inline fixed_integral_t round_up(const fixed_fractional_t &f)
+{
+	return divide_with_ceil(f.get_num(), f.get_den());
+}
+
+// integral part, i.e., rounded towards zero
+static inline integral_t truncate_to_integral(const fractional_t &f)
+{
+	return integral_t(f);
+}
+
+static inline fixed_integral_t truncate_to_integral(const fixed_fractional_t &f)
+{
+	return f.get_num() / f.get_den();
+}
 
 #endif
@@ -159,8 +159,12 @@ public:
 
 void dump(const CriticalSectionsOfTaskset &x);
 
+class BlockingThresholds;
+
+// thresholds: see lp_analysis.h
 BlockingBounds* lp_nested_fifo_spinlock_bounds(
 	const ResourceSharingInfo& info,
-	const CriticalSectionsOfTaskset& tsk_cs);
+	const CriticalSectionsOfTaskset& tsk_cs,
+	const BlockingThresholds* thresholds = NULL);
 
 #endif
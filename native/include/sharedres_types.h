@@ -20,6 +20,34 @@ typedef enum {
 
 class TaskInfo;
 
+#ifndef SWIG
+
+// Job counts of a task under partitioned EDF, as functions of the task's
+// parameters so that they can also be evaluated on ClusterIndex arrays.
+static inline unsigned long pedf_max_num_remote_jobs(unsigned long interval,
+                                                     unsigned long period,
+                                                     unsigned long deadline)
+{
+	return divide_with_ceil(interval + (long)deadline, (long)period);
+}
+
+static inline unsigned long pedf_PDC_max_num_local_jobs(unsigned long interval,
+                                                        unsigned long period,
+                                                        unsigned long deadline)
+{
+	unsigned long num_jobs;
+	num_jobs = divide_with_floor(interval + (long)period - (long)deadline, (long)period);
+	return (num_jobs > 0 ? num_jobs : 0);
+}
+
+static inline unsigned long pedf_AC_max_num_local_jobs(unsigned long interval,
+                                                       unsigned long period)
+{
+	return divide_with_ceil(interval, period);
+}
+
+#endif
+
 class RequestBound
 {
 private:
@@ -30,6 +58,8 @@ private:
 	request_type_t request_type;
 	unsigned int request_priority;
 
+	friend class ResourceSharingInfo;
+
 public:
 	RequestBound(unsigned int res_id,
 		     unsigned int num,
@@ -79,6 +109,8 @@ private:
 	unsigned long cost;
 	Requests requests;
 
+	friend class ResourceSharingInfo;
+
 public:
 	// implicit deadline task
 	TaskInfo(unsigned long _period,
@@ -179,23 +211,17 @@ public:
 
 	unsigned long get_pedf_max_num_remote_jobs(unsigned long interval) const
 	{
-		unsigned long num_jobs;
-		num_jobs = divide_with_ceil(interval + (long)get_deadline(), (long)get_period());
-		return num_jobs;
+		return pedf_max_num_remote_jobs(interval, get_period(), get_deadline());
 	}
 
 	unsigned long get_pedf_PDC_max_num_local_jobs(unsigned long interval) const
 	{
-		unsigned long num_jobs;
-		num_jobs = divide_with_floor(interval +(long)get_period() - (long)get_deadline(), (long)get_period());
-		return (num_jobs > 0 ? num_jobs : 0);
+		return pedf_PDC_max_num_local_jobs(interval, get_period(), get_deadline());
 	}
 
 	unsigned long get_pedf_AC_max_num_local_jobs(unsigned long interval) const
 	{
-		unsigned long num_jobs;
-		num_jobs = divide_with_ceil(interval, get_period());
-		return num_jobs;
+		return pedf_AC_max_num_local_jobs(interval, get_period());
 	}
 
 	// uniprocessor fixed-priority scheduling, only valid for local tasks
@@ -260,10 +286,142 @@ public:
 
 typedef std::vector<TaskInfo> TaskInfos;
 
+#ifndef SWIG
+
+// A sequence of tasks given by their ids, which iterates like a TaskInfos
+// range (i.e., 'it->get_id()').
+class TaskIdRange
+{
+private:
+	const TaskInfo *tasks;
+	const std::vector<unsigned int> &ids;
+
+public:
+	class const_iterator
+	{
+	private:
+		const TaskInfo *tasks;
+		std::vector<unsigned int>::const_iterator pos;
+
+	public:
+		const_iterator(const TaskInfo *tasks,
+		               std::vector<unsigned int>::const_iterator pos)
+			: tasks(tasks), pos(pos)
+		{}
+
+		const TaskInfo& operator*() const { return tasks[*pos]; }
+		const TaskInfo* operator->() const { return &tasks[*pos]; }
+
+		const_iterator& operator++()
+		{
+			++pos;
+			return *this;
+		}
+
+		const_iterator operator++(int)
+		{
+			const_iterator old = *this;
+			++pos;
+			return old;
+		}
+
+		bool operator==(const const_iterator &other) const { return pos == other.pos; }
+		bool operator!=(const const_iterator &other) const { return pos != other.pos; }
+	};
+
+	TaskIdRange(const TaskInfos &all_tasks, const std::vector<unsigned int> &ids)
+		: tasks(all_tasks.data()), ids(ids)
+	{}
+
+	const_iterator begin() const { return const_iterator(tasks, ids.begin()); }
+	const_iterator end() const { return const_iterator(tasks, ids.end()); }
+	unsigned int size() const { return ids.size(); }
+};
+
+// The tasks of a task set grouped by cluster, maintained incrementally by
+// ResourceSharingInfo::add_task(). The per-cluster analyses consult it
+// instead of scanning (and filtering) the whole task set over and over.
+// Per cluster, it stores the ids of the local and of the remote tasks (both
+// in order of task id), and the parameters that the demand computations
+// need of the local tasks as contiguous arrays.
+class ClusterIndex
+{
+public:
+	struct Cluster
+	{
+		std::vector<unsigned int> local_ids;
+		std::vector<unsigned int> remote_ids;
+
+		// parameters of the local tasks, in the order of local_ids
+		std::vector<unsigned long> periods;
+		std::vector<unsigned long> deadlines;
+		std::vector<unsigned long> costs;
+	};
+
+private:
+	std::vector<Cluster> clusters;
+	unsigned int num_tasks;
+
+public:
+	ClusterIndex() : num_tasks(0) {}
+
+	// tasks must be added in order of their ids
+	void add_task(const TaskInfo &tsk)
+	{
+		const unsigned int c = tsk.get_cluster();
+		assert(tsk.get_id() == num_tasks);
+
+		// a new cluster is remote to all previously added tasks
+		while (clusters.size() <= c)
+		{
+			clusters.push_back(Cluster());
+			for (unsigned int id = 0; id < num_tasks; id++)
+				clusters.back().remote_ids.push_back(id);
+		}
+
+		foreach(clusters, it)
+			if (it != clusters.begin() + c)
+				it->remote_ids.push_back(tsk.get_id());
+
+		Cluster &local = clusters[c];
+		local.local_ids.push_back(tsk.get_id());
+		local.periods.push_back(tsk.get_period());
+		local.deadlines.push_back(tsk.get_deadline());
+		local.costs.push_back(tsk.get_cost());
+
+		num_tasks++;
+	}
+
+	// tsk's cost has changed
+	void update_cost(const TaskInfo &tsk)
+	{
+		Cluster &local = clusters[tsk.get_cluster()];
+		std::vector<unsigned int>::const_iterator pos =
+			std::lower_bound(local.local_ids.begin(), local.local_ids.end(),
+			                 tsk.get_id());
+		assert(pos != local.local_ids.end() && *pos == tsk.get_id());
+		local.costs[pos - local.local_ids.begin()] = tsk.get_cost();
+	}
+
+	unsigned int get_num_clusters() const
+	{
+		return clusters.size();
+	}
+
+	const Cluster& get_cluster(unsigned int c) const
+	{
+		assert(c < clusters.size());
+		return clusters[c];
+	}
+};
+
+#endif
+
 class ResourceSharingInfo
 {
 private:
 	TaskInfos tasks;
+	ClusterIndex cluster_index;
 
 public:
 	ResourceSharingInfo(unsigned int num_tasks)
@@ -290,6 +448,23 @@ public:
 		if (!deadline)
 			deadline = period;
 		tasks.push_back(TaskInfo(period, deadline, response, cluster, priority, id, cost));
+		cluster_index.add_task(tasks.back());
+	}
+
+	const ClusterIndex& get_cluster_index() const
+	{
+		return cluster_index;
+	}
+
+	// the tasks assigned to (or not assigned to) the given cluster
+	TaskIdRange get_tasks_in_cluster(unsigned int cluster) const
+	{
+		return TaskIdRange(tasks, cluster_index.get_cluster(cluster).local_ids);
+	}
+
+	TaskIdRange get_tasks_not_in_cluster(unsigned int cluster) const
+	{
+		return TaskIdRange(tasks, cluster_index.get_cluster(cluster).remote_ids);
 	}
 
 	void add_request(unsigned int resource_id,
@@ -316,6 +491,32 @@ public:
 		last_added.add_request(resource_id, max_num, max_length, (request_type_t) type, locking_priority);
 	}
 
+#ifndef SWIG
+	// Set the costs and request lengths to those of base, multiplied by
+	// cost_factor and length_factor, respectively, and rounded up. Apart
+	// from that, base must consist of the same tasks with the same
+	// requests (e.g., this is a copy of base). Used to re-run an analysis
+	// on a scaled task set without building a new one.
+	void set_scaled_parameters(const ResourceSharingInfo& base,
+	                           double cost_factor, double length_factor)
+	{
+		assert(base.tasks.size() == tasks.size());
+
+		for (unsigned int i = 0; i < tasks.size(); i++)
+		{
+			TaskInfo& tsk = tasks[i];
+			const TaskInfo& orig = base.tasks[i];
+
+			tsk.cost = (unsigned long) ceil(orig.cost * cost_factor);
+			cluster_index.update_cost(tsk);
+
+			assert(orig.requests.size() == tsk.requests.size());
+			for (unsigned int j = 0; j < tsk.requests.size(); j++)
+				tsk.requests[j].request_length = (unsigned int)
+					ceil(orig.requests[j].request_length * length_factor);
+		}
+	}
+#endif
 };
 
 
@@ -12,6 +12,8 @@
 
 #endif
 
+class AnalysisBudget;
+
 class Task
 {
   private:
@@ -104,6 +106,19 @@ class Task
     }
 
     void bound_demand(const integral_t &time, integral_t &demand) const
+    {
+        bound_demand_generic(time, demand);
+    }
+
+#ifndef SWIG
+    // throws fixed_width_overflow if the demand does not fit
+    void bound_demand(const fixed_integral_t &time, fixed_integral_t &demand) const
+    {
+        bound_demand_generic(time, demand);
+    }
+
+    template <typename Int>
+    void bound_demand_generic(const Int &time, Int &demand) const
     {
         demand = time - deadline;
         if (demand < 0)
@@ -115,6 +130,7 @@ class Task
             demand *= wcet;
         }
     }
+#endif
 
     // rely on return value optimization
     integral_t dbf(integral_t t) const
@@ -226,7 +242,13 @@ class TaskSet
     void get_max_density(fractional_t &max_density) const;
 
     void bound_demand(const integral_t &time, integral_t &demand) const;
-    void approx_load(fractional_t &load, const fractional_t &epsilon = 0.1) const;
+#ifndef SWIG
+    void bound_demand(const fixed_integral_t &time, fixed_integral_t &demand) const;
+#endif
+    // Polls the budget (if any) once per test point. If it runs out, the
+    // load is bounded by the density instead, which is still safe.
+    void approx_load(fractional_t &load, const fractional_t &epsilon = 0.1,
+                     AnalysisBudget *budget = NULL) const;
 
     /* wrapper for Python access */
     unsigned long get_period(unsigned int idx) const
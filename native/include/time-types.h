@@ -5,6 +5,10 @@
 #include <string.h>
 #include <gmpxx.h>
 
+#include <stdint.h>
+#include <stdexcept>
+#include <utility>
+
 typedef mpz_class integral_t;
 typedef mpq_class fractional_t;
 
@@ -14,4 +18,317 @@ static inline void truncate_fraction(fractional_t &val)
     val.canonicalize();
 }
 
+/* Fixed-width counterparts of integral_t and fractional_t. Every operation
+ * checks whether its result fits into 64 bits (numerator and denominator,
+ * in the case of fractions) and throws fixed_width_overflow if it does not.
+ * The tests that are written for both kinds of types run on these first,
+ * which keeps GMP's memory management out of their inner loops, and repeat
+ * the analysis with integral_t and fractional_t only if some intermediate
+ * value overflowed. The semantics match those of GMP's C++ classes, e.g.,
+ * division truncates towards zero. */
+
+class fixed_width_overflow : public std::overflow_error
+{
+  public:
+    fixed_width_overflow() : std::overflow_error("fixed-width overflow") {}
+};
+
+class fixed_integral_t
+{
+  private:
+    int64_t val;
+
+  public:
+    static int64_t checked(__int128 v)
+    {
+        if (v > INT64_MAX || v < INT64_MIN)
+            throw fixed_width_overflow();
+        return (int64_t) v;
+    }
+
+    fixed_integral_t() : val(0) {}
+    fixed_integral_t(int v) : val(v) {}
+    fixed_integral_t(unsigned int v) : val(v) {}
+    fixed_integral_t(long v) : val(v) {}
+    fixed_integral_t(unsigned long v) : val(checked(v)) {}
+
+    explicit fixed_integral_t(const integral_t &v)
+    {
+        if (!v.fits_slong_p())
+            throw fixed_width_overflow();
+        val = v.get_si();
+    }
+
+    long get_si() const { return val; }
+    unsigned long get_ui() const { return val < 0 ? -(unsigned long) val : val; }
+    double get_d() const { return val; }
+
+    fixed_integral_t& operator+=(const fixed_integral_t &o)
+    {
+        if (__builtin_add_overflow(val, o.val, &val))
+            throw fixed_width_overflow();
+        return *this;
+    }
+
+    fixed_integral_t& operator-=(const fixed_integral_t &o)
+    {
+        if (__builtin_sub_overflow(val, o.val, &val))
+            throw fixed_width_overflow();
+        return *this;
+    }
+
+    fixed_integral_t& operator*=(const fixed_integral_t &o)
+    {
+        if (__builtin_mul_overflow(val, o.val, &val))
+            throw fixed_width_overflow();
+        return *this;
+    }
+
+    fixed_integral_t& operator/=(const fixed_integral_t &o)
+    {
+        if (o.val == -1 && val == INT64_MIN)
+            throw fixed_width_overflow();
+        val /= o.val;
+        return *this;
+    }
+
+    fixed_integral_t& operator%=(const fixed_integral_t &o)
+    {
+        val = (o.val == -1) ? 0 : val % o.val;
+        return *this;
+    }
+
+    fixed_integral_t operator-() const
+    {
+        return fixed_integral_t() -= *this;
+    }
+
+#define FIXED_INTEGRAL_OP(op)                                               \
+    friend fixed_integral_t operator op(const fixed_integral_t &a,          \
+                                        const fixed_integral_t &b)          \
+    {                                                                       \
+        fixed_integral_t r(a);                                              \
+        r op##= b;                                                          \
+        return r;                                                           \
+    }
+
+    FIXED_INTEGRAL_OP(+)
+    FIXED_INTEGRAL_OP(-)
+    FIXED_INTEGRAL_OP(*)
+    FIXED_INTEGRAL_OP(/)
+    FIXED_INTEGRAL_OP(%)
+#undef FIXED_INTEGRAL_OP
+
+#define FIXED_INTEGRAL_CMP(op)                                              \
+    friend bool operator op(const fixed_integral_t &a,                      \
+                            const fixed_integral_t &b)                      \
+    {                                                                       \
+        return a.val op b.val;                                              \
+    }
+
+    FIXED_INTEGRAL_CMP(==)
+    FIXED_INTEGRAL_CMP(!=)
+    FIXED_INTEGRAL_CMP(<)
+    FIXED_INTEGRAL_CMP(<=)
+    FIXED_INTEGRAL_CMP(>)
+    FIXED_INTEGRAL_CMP(>=)
+#undef FIXED_INTEGRAL_CMP
+};
+
+class fixed_fractional_t
+{
+  private:
+    // canonical form: den > 0 and gcd(num, den) == 1
+    int64_t num, den;
+
+    static unsigned __int128 gcd(unsigned __int128 a, unsigned __int128 b)
+    {
+        // binary GCD, in 64 bits once both operands fit
+        if (!a || !b)
+            return a | b;
+        unsigned int shift = 0;
+        while (!((a | b) & 1))
+        {
+            a >>= 1;
+            b >>= 1;
+            shift++;
+        }
+        while (!(a & 1))
+            a >>= 1;
+        while ((a >> 64) || (b >> 64))
+        {
+            while (!(b & 1))
+                b >>= 1;
+            if (a > b)
+                std::swap(a, b);
+            b -= a;
+            if (!b)
+                return a << shift;
+        }
+        uint64_t x = a, y = b;
+        while (y)
+        {
+            y >>= __builtin_ctzll(y);
+            if (x > y)
+                std::swap(x, y);
+            y -= x;
+        }
+        return (unsigned __int128) x << shift;
+    }
+
+    void set(__int128 n, __int128 d)
+    {
+        if (d < 0)
+        {
+            n = -n;
+            d = -d;
+        }
+        if (d != 1)
+        {
+            const __int128 g = gcd(n < 0 ? -n : n, d);
+            if (g > 1)
+            {
+                n /= g;
+                d /= g;
+            }
+        }
+        num = fixed_integral_t::checked(n);
+        den = fixed_integral_t::checked(d);
+    }
+
+    // The products of two 64-bit values always fit into 128 bits, but the
+    // sums and differences of such products need not.
+    static __int128 checked_add(__int128 a, __int128 b)
+    {
+        __int128 r;
+        if (__builtin_add_overflow(a, b, &r))
+            throw fixed_width_overflow();
+        return r;
+    }
+
+    static __int128 checked_sub(__int128 a, __int128 b)
+    {
+        __int128 r;
+        if (__builtin_sub_overflow(a, b, &r))
+            throw fixed_width_overflow();
+        return r;
+    }
+
+  public:
+    fixed_fractional_t() : num(0), den(1) {}
+    fixed_fractional_t(int v) : num(v), den(1) {}
+    fixed_fractional_t(unsigned int v) : num(v), den(1) {}
+    fixed_fractional_t(long v) : num(v), den(1) {}
+    fixed_fractional_t(unsigned long v) : num(fixed_integral_t::checked(v)), den(1) {}
+    fixed_fractional_t(const fixed_integral_t &v) : num(v.get_si()), den(1) {}
+
+    fixed_fractional_t(const fixed_integral_t &n, const fixed_integral_t &d)
+    {
+        set(n.get_si(), d.get_si());
+    }
+
+    explicit fixed_fractional_t(const fractional_t &v)
+    {
+        if (!v.get_num().fits_slong_p() || !v.get_den().fits_slong_p())
+            throw fixed_width_overflow();
+        num = v.get_num().get_si();
+        den = v.get_den().get_si();
+    }
+
+    fixed_integral_t get_num() const { return fixed_integral_t(num); }
+    fixed_integral_t get_den() const { return fixed_integral_t(den); }
+    double get_d() const { return num / (double) den; }
+
+    fixed_fractional_t& operator+=(const fixed_fractional_t &o)
+    {
+        if (den == o.den)
+            set(checked_add(num, o.num), den);
+        else
+            set(checked_add((__int128) num * o.den, (__int128) o.num * den),
+                (__int128) den * o.den);
+        return *this;
+    }
+
+    fixed_fractional_t& operator-=(const fixed_fractional_t &o)
+    {
+        if (den == o.den)
+            set(checked_sub(num, o.num), den);
+        else
+            set(checked_sub((__int128) num * o.den, (__int128) o.num * den),
+                (__int128) den * o.den);
+        return *this;
+    }
+
+    fixed_fractional_t& operator*=(const fixed_fractional_t &o)
+    {
+        set((__int128) num * o.num, (__int128) den * o.den);
+        return *this;
+    }
+
+    fixed_fractional_t& operator/=(const fixed_fractional_t &o)
+    {
+        set((__int128) num * o.den, (__int128) den * o.num);
+        return *this;
+    }
+
+    fixed_fractional_t operator-() const
+    {
+        return fixed_fractional_t() -= *this;
+    }
+
+#define FIXED_FRACTIONAL_OP(op)                                             \
+    friend fixed_fractional_t operator op(const fixed_fractional_t &a,      \
+                                          const fixed_fractional_t &b)      \
+    {                                                                       \
+        fixed_fractional_t r(a);                                            \
+        r op##= b;                                                          \
+        return r;                                                           \
+    }
+
+    FIXED_FRACTIONAL_OP(+)
+    FIXED_FRACTIONAL_OP(-)
+    FIXED_FRACTIONAL_OP(*)
+    FIXED_FRACTIONAL_OP(/)
+#undef FIXED_FRACTIONAL_OP
+
+    // the cross products of two 64-bit fractions fit into 128 bits
+#define FIXED_FRACTIONAL_CMP(op)                                            \
+    friend bool operator op(const fixed_fractional_t &a,                    \
+                            const fixed_fractional_t &b)                    \
+    {                                                                       \
+        if (a.den == b.den)                                                 \
+            return a.num op b.num;                                          \
+        return (__int128) a.num * b.den op (__int128) b.num * a.den;        \
+    }
+
+    FIXED_FRACTIONAL_CMP(==)
+    FIXED_FRACTIONAL_CMP(!=)
+    FIXED_FRACTIONAL_CMP(<)
+    FIXED_FRACTIONAL_CMP(<=)
+    FIXED_FRACTIONAL_CMP(>)
+    FIXED_FRACTIONAL_CMP(>=)
+#undef FIXED_FRACTIONAL_CMP
+};
+
+static inline void truncate_fraction(fixed_fractional_t &val)
+{
+    val = fixed_fractional_t(val.get_num() / val.get_den());
+}
+
+/* Selects the instantiation used by the tests that are written for both
+ * kinds of types (QPA, Baruah, LA and FFDBF). FIXED_WIDTH_FIRST, the
+ * default, falls back to GMP on overflow as described above. GMP_ONLY skips
+ * the fixed-width attempt, and FIXED_WIDTH_ONLY lets fixed_width_overflow
+ * propagate to the caller instead of falling back; both exist to
+ * cross-check the two instantiations. The mode is process-wide. */
+enum fixed_width_mode_t
+{
+    FIXED_WIDTH_FIRST,
+    GMP_ONLY,
+    FIXED_WIDTH_ONLY
+};
+
+void set_fixed_width_mode(fixed_width_mode_t mode);
+fixed_width_mode_t get_fixed_width_mode();
+
 #endif
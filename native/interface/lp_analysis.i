@@ -2,7 +2,10 @@
 %{
 #define SWIG_FILE_WITH_INIT
 #include "lp_analysis.h"
+#include "analysis_budget.h"
 #include "nested_cs.h"
+#include "linprog/dispatch.h"
+#include "linprog/stats.h"
 %}
 
 %newobject lp_dpcp_bounds;
@@ -29,10 +32,21 @@
 
 %newobject dummy_bounds;
 
+%newobject lp_pedf_msrp_sensitivity;
+%newobject lp_pedf_fifo_preempt_sensitivity;
+%newobject lp_pedf_lockfree_preempt_sensitivity;
+%newobject lp_pedf_lockfree_NP_sensitivity;
+
 %include "sharedres_types.i"
 
+%include "analysis_budget.h"
+
 %include "lp_analysis.h"
 
+%include "linprog/dispatch.h"
+
+%include "linprog/stats.h"
+
 %ignore CriticalSectionsOfTaskset::get_transitive_nesting_relationship;
 
 %include "nested_cs.h"
@@ -3,6 +3,7 @@
 #define SWIG_FILE_WITH_INIT
 #include "tasks.h"
 #include "schedulability.h"
+#include "analysis_budget.h"
 #include "edf/baker.h"
 #include "edf/gfb.h"
 #include "edf/baruah.h"
@@ -41,6 +42,7 @@
 
 #include "tasks.h"
 #include "schedulability.h"
+#include "analysis_budget.h"
 #include "edf/baker.h"
 #include "edf/gfb.h"
 #include "edf/baruah.h"
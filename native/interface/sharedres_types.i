@@ -3,6 +3,9 @@
 %ignore TaskInfo;
 
 %ignore ResourceSharingInfo::get_tasks;
+%ignore ResourceSharingInfo::get_cluster_index;
+%ignore ResourceSharingInfo::get_tasks_in_cluster;
+%ignore ResourceSharingInfo::get_tasks_not_in_cluster;
 
 %ignore BlockingBounds::raise_request_span;
 %ignore BlockingBounds::get_max_request_span;
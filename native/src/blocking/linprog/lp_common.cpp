@@ -1,5 +1,6 @@
 #include <sstream>
 #include <iostream>
+#include <algorithm>
 
 #include "lp_common.h"
 
@@ -38,6 +39,21 @@ std::string VarMapper::key2str(uint64_t key, unsigned int var) const
 	return buf.str();
 }
 
+void VarMapper::reserve(const ResourceSharingInfo& info)
+{
+	unsigned int num_tasks = 0, num_resources = 0;
+
+	foreach(info.get_tasks(), tx)
+	{
+		num_tasks = std::max(num_tasks, tx->get_id() + 1);
+		foreach(tx->get_requests(), req)
+			num_resources = std::max(num_resources,
+			                         req->get_resource_id() + 1);
+	}
+
+	set_dense_extents(BLOCKING_TOKEN + 1, num_tasks, num_resources);
+}
+
 // LP-based analysis of semaphore protocols.
 // Based on the paper:
 // B. Brandenburg, "Improved Analysis and Evaluation of Real-Time Semaphore
@@ -97,11 +113,9 @@ void set_blocking_objective(
 			}
 		}
 	}
-#ifndef CONFIG_MERGED_LINPROGS
 	// We have enumerated all relevant variables. Do not allow any more to
 	// be created.
 	vars.seal();
-#endif
 }
 
 // This version is for partitioned shared-memory protocols where each
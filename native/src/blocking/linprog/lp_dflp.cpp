@@ -5,6 +5,7 @@
 #include "stl-hashmap.h"
 
 #include "cpu_time.h"
+#include "lp_parallel.h"
 
 // Constraint 5
 // only one blocking request each time a job of T_i
@@ -110,106 +111,18 @@ void add_dflp_constraints(
 	add_fifo_cluster_constraints(vars, info, locality, ti, lp);
 }
 
-#ifdef CONFIG_MERGED_LINPROGS
-
-static BlockingBounds* _lp_dflp_bounds(const ResourceSharingInfo& info,
-				       const ResourceLocality& locality)
-{
-	BlockingBounds *results = new BlockingBounds(info);
-	const unsigned int num_tasks = info.get_tasks().size();
-	LinearExpression *local_obj = new LinearExpression[num_tasks];
-	LinearExpression *remote_obj = new LinearExpression[num_tasks];
-
-	LinearProgram lp;
-	unsigned int var_idx = 0;
-
-#if DEBUG_LP_OVERHEADS >= 2
-	static DEFINE_CPU_CLOCK(model_gen_cost);
-	static DEFINE_CPU_CLOCK(solver_cost);
-	static DEFINE_CPU_CLOCK(extract_cost);
-	static DEFINE_CPU_CLOCK(total_cost);
-
-	std::cout << "---- " << __FUNCTION__ << " ----" << std::endl;
-
-	model_gen_cost.start();
-	total_cost.start();
-#endif
-
-	// Generate a "merged" LP.
-	for (unsigned int i = 0; i < num_tasks; i++)
-	{
-		const TaskInfo &ti = info.get_tasks()[i];
-		VarMapper vars = VarMapper(var_idx);
-
-		set_blocking_objective(vars, info, locality, ti, lp,
-				       local_obj + i, remote_obj + i);
-		add_dflp_constraints(vars, info, locality, ti, lp);
-
-		var_idx = vars.get_next_var();
-	}
-
-#if DEBUG_LP_OVERHEADS >= 2
-	model_gen_cost.stop();
-	solver_cost.start();
-#endif
-
-	// Solve the big, combined LP.
-	Solution *sol = linprog_solve(lp, var_idx);
-
-	assert(sol != NULL);
-
-#if DEBUG_LP_OVERHEADS >= 2
-	solver_cost.stop();
-	extract_cost.start();
-#endif
-
-	// Extract each task's solution.
-	for (unsigned int i = 0; i < num_tasks; i++)
-	{
-		Interference total, remote, local;
-
-		local.total_length = lrint(sol->evaluate(local_obj[i]));
-		remote.total_length = lrint(sol->evaluate(remote_obj[i]));
-		total.total_length = local.total_length + remote.total_length;
-
-		(*results)[i] = total;
-		results->set_remote_blocking(i, remote);
-		results->set_local_blocking(i, local);
-	}
-
-#if DEBUG_LP_OVERHEADS >= 2
-	extract_cost.stop();
-	total_cost.stop();
-	std::cout << model_gen_cost << std::endl;
-	std::cout << solver_cost << std::endl;
-	std::cout << extract_cost << std::endl;
-	std::cout << total_cost << std::endl;
-#endif
-
-	delete sol;
-	delete[] local_obj;
-	delete[] remote_obj;
-
-	return results;
-}
-
-
-#else // per-task LPs
-
-static void apply_dflp_bounds_for_task(
-	unsigned int i,
-	BlockingBounds& bounds,
+static unsigned int build_dflp_lp(
+	LinearProgram& lp,
 	const ResourceSharingInfo& info,
-	const ResourceLocality& locality)
+	const ResourceLocality& locality,
+	const TaskInfo& ti,
+	LinearExpression *local_obj)
 {
-	LinearProgram lp;
 	VarMapper vars;
-	const TaskInfo& ti = info.get_tasks()[i];
-	LinearExpression *local_obj = new LinearExpression();
+	vars.reserve(info);
 
 #if DEBUG_LP_OVERHEADS >= 2
 	static DEFINE_CPU_CLOCK(model_gen_cost);
-	static DEFINE_CPU_CLOCK(solver_cost);
 
 	std::cout << "---- " << __FUNCTION__ << " ----" << std::endl;
 
@@ -223,48 +136,48 @@ static void apply_dflp_bounds_for_task(
 #if DEBUG_LP_OVERHEADS >=2
 	model_gen_cost.stop();
 	std::cout << model_gen_cost << std::endl;
-	solver_cost.start();
 #endif
 
-	Solution *sol = linprog_solve(lp, vars.get_num_vars());
-
-#if DEBUG_LP_OVERHEADS >=2
-	solver_cost.stop();
-	std::cout << solver_cost << std::endl;
-#endif
-
-	assert(sol != NULL);
-
-	Interference total, remote, local;
-
-	total.total_length = sol->evaluate(*lp.get_objective());
-	local.total_length = sol->evaluate(*local_obj);
-	remote.total_length = total.total_length - local.total_length;
-
-	bounds[i] = total;
-	bounds.set_remote_blocking(i, remote);
-	bounds.set_local_blocking(i, local);
-
-	delete local_obj;
-	delete sol;
+	return vars.get_num_vars();
 }
 
 static BlockingBounds* _lp_dflp_bounds(const ResourceSharingInfo& info,
 				       const ResourceLocality& locality)
 {
 	BlockingBounds *results = new BlockingBounds(info);
+	std::vector<LinearExpression*> local_obj(info.get_tasks().size());
 
-	for (unsigned int i = 0; i < info.get_tasks().size(); i++)
-		apply_dflp_bounds_for_task(i, *results, info, locality);
+	solve_task_lps(info.get_tasks().size(),
+		[&](unsigned int i, LinearProgram& lp)
+		{
+			local_obj[i] = new LinearExpression();
+			return build_dflp_lp(lp, info, locality, info.get_tasks()[i],
+					     local_obj[i]);
+		},
+		[&](unsigned int i, LinearProgram& lp, const Solution& sol)
+		{
+			Interference total, remote, local;
+
+			total.total_length = sol.evaluate(*lp.get_objective());
+			local.total_length = sol.evaluate(*local_obj[i]);
+			remote.total_length = total.total_length - local.total_length;
+
+			(*results)[i] = total;
+			results->set_remote_blocking(i, remote);
+			results->set_local_blocking(i, local);
+
+			delete local_obj[i];
+			return false;
+		});
 
 	return results;
 }
 
-#endif
-
 BlockingBounds* lp_dflp_bounds(const ResourceSharingInfo& info,
 				const ResourceLocality& locality)
 {
+	LinearProgramOriginScope origin(__func__);
+
 #if DEBUG_LP_OVERHEADS >= 1
 	static DEFINE_CPU_CLOCK(cpu_costs);
 
@@ -8,6 +8,7 @@
 #include "stl-hashmap.h"
 
 #include "cpu_time.h"
+#include "lp_parallel.h"
 
 typedef hashmap<unsigned int, unsigned int> BlockingLimits;
 
@@ -210,19 +211,17 @@ static void add_fmlp_constraints(
 	add_fifo_cluster_constraints(vars, info, ti, lp);
 }
 
-static void apply_fmlp_bounds_for_task(
-	unsigned int i,
-	BlockingBounds& bounds,
-	const ResourceSharingInfo& info)
+static unsigned int build_fmlp_lp(
+	LinearProgram& lp,
+	const ResourceSharingInfo& info,
+	const TaskInfo& ti,
+	LinearExpression *local_obj)
 {
-	LinearProgram lp;
 	VarMapper vars;
-	const TaskInfo& ti = info.get_tasks()[i];
-	LinearExpression *local_obj = new LinearExpression();
+	vars.reserve(info);
 
 #if DEBUG_LP_OVERHEADS >= 2
 	static DEFINE_CPU_CLOCK(model_gen_cost);
-	static DEFINE_CPU_CLOCK(solver_cost);
 
 	std::cout << "---- " << __FUNCTION__ << " ----" << std::endl;
 
@@ -237,44 +236,47 @@ static void apply_fmlp_bounds_for_task(
 #if DEBUG_LP_OVERHEADS >= 2
 	model_gen_cost.stop();
 	std::cout << model_gen_cost << std::endl;
-	solver_cost.start();
-#endif
-
-	Solution *sol = linprog_solve(lp, vars.get_num_vars());
-
-#if DEBUG_LP_OVERHEADS >= 2
-	solver_cost.stop();
-	std::cout << solver_cost << std::endl;
 #endif
-	assert(sol != NULL);
-
-	Interference total, remote, local;
 
-	total.total_length = lrint(sol->evaluate(*lp.get_objective()));
-	local.total_length = lrint(sol->evaluate(*local_obj));
-	remote.total_length = total.total_length - local.total_length;
-
-	bounds[i] = total;
-	bounds.set_remote_blocking(i, remote);
-	bounds.set_local_blocking(i, local);
-
-	delete local_obj;
-	delete sol;
+	return vars.get_num_vars();
 }
 
 
 static BlockingBounds* _lp_fmlp_bounds(const ResourceSharingInfo& info)
 {
 	BlockingBounds* results = new BlockingBounds(info);
+	std::vector<LinearExpression*> local_obj(info.get_tasks().size());
+
+	solve_task_lps(info.get_tasks().size(),
+		[&](unsigned int i, LinearProgram& lp)
+		{
+			local_obj[i] = new LinearExpression();
+			return build_fmlp_lp(lp, info, info.get_tasks()[i],
+					     local_obj[i]);
+		},
+		[&](unsigned int i, LinearProgram& lp, const Solution& sol)
+		{
+			Interference total, remote, local;
+
+			total.total_length = lrint(sol.evaluate(*lp.get_objective()));
+			local.total_length = lrint(sol.evaluate(*local_obj[i]));
+			remote.total_length = total.total_length - local.total_length;
 
-	for (unsigned int i = 0; i < info.get_tasks().size(); i++)
-		apply_fmlp_bounds_for_task(i, *results, info);
+			(*results)[i] = total;
+			results->set_remote_blocking(i, remote);
+			results->set_local_blocking(i, local);
+
+			delete local_obj[i];
+			return false;
+		});
 
 	return results;
 }
 
 BlockingBounds* lp_part_fmlp_bounds(const ResourceSharingInfo& info)
 {
+	LinearProgramOriginScope origin(__func__);
+
 #if DEBUG_LP_OVERHEADS >= 1
 	static DEFINE_CPU_CLOCK(cpu_costs);
 
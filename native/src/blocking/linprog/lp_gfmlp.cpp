@@ -8,6 +8,7 @@
 #include "stl-hashmap.h"
 
 #include "cpu_time.h"
+#include "lp_parallel.h"
 
 typedef hashmap<unsigned int, unsigned int> BlockingLimits;
 
@@ -189,6 +190,7 @@ static void apply_gfmlp_bounds_for_task(
 {
 	LinearProgram lp;
 	VarMapper vars;
+	vars.reserve(info);
 	const TaskInfo& ti = info.get_tasks()[i];
 	LinearExpression *local_obj = new LinearExpression();
 
@@ -243,8 +245,10 @@ static BlockingBounds* _lp_gfmlp_bounds(
 {
 	BlockingBounds* results = new BlockingBounds(info);
 
-	for (unsigned int i = 0; i < info.get_tasks().size(); i++)
+	foreach_task_parallel(info.get_tasks().size(), [&](unsigned int i)
+	{
 		apply_gfmlp_bounds_for_task(i, *results, info, cluster_size, using_edf);
+	});
 
 	return results;
 }
@@ -254,6 +258,8 @@ BlockingBounds* lp_gfmlp_bounds(
 	unsigned int cluster_size,
 	bool using_edf)
 {
+	LinearProgramOriginScope origin(__func__);
+
 #if DEBUG_LP_OVERHEADS >= 1
 	static DEFINE_CPU_CLOCK(cpu_costs);
 
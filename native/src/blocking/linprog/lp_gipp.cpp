@@ -1,6 +1,7 @@
 #include "lp_common.h"
 #include "blocking.h"
 #include "nested_cs.h"
+#include "lp_parallel.h"
 
 typedef std::vector<LockSet> ResourceGroup;
 typedef std::vector<CriticalSections > OutermostCS;
@@ -114,6 +115,7 @@ ClusteredGIPPLP::ClusteredGIPPLP(
         res_acquired_by_other(),
         length_outermost_cs(l_ocs)
 {
+    vars.reserve(tsk);
 
     compute_token_waiting_times();
 
@@ -1013,6 +1015,7 @@ BlockingBounds* lp_gipp_bounds(
         unsigned int c_size,
         bool apply_to_rnlp = false)
 {
+    LinearProgramOriginScope origin(__func__);
 
     BlockingBounds* results = new BlockingBounds(info);
 
@@ -1048,11 +1051,11 @@ BlockingBounds* lp_gipp_bounds(
 
     /* Tests are performed, group computation is
      * done exactly once per taskset. */
-    for (unsigned int i = 0; i < info.get_tasks().size(); i++)
+    foreach_task_parallel(info.get_tasks().size(), [&](unsigned int i)
     {
         ClusteredGIPPLP lp(info, cst, r_group, outer_cs, (int) i, cpu_num, c_size, phi, beta, task_to_group, l_ocs);
         (*results)[i] = lp.solve();
-    }
+    });
 
     return results;
 }
@@ -96,6 +96,9 @@ GlobalSuspensionAwareLP::GlobalSuspensionAwareLP(
 		assert(info.get_tasks()[j].get_priority() == j);
 	}
 
+	vars.reserve(taskset.size(),
+	             all_resources.empty() ? 0 : *all_resources.rbegin() + 1);
+
 	set_objective();
 
 	// Constraint 1
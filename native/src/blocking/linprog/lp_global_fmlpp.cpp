@@ -20,6 +20,7 @@
 #include "linprog/io.h"
 
 #include "lp_global.h"
+#include "lp_parallel.h"
 
 class GlobalFMLPPlusAnalysis : public GlobalRestrictedSegmentBoostingLP, public GlobalFIFOQueuesLP
 {
@@ -168,12 +169,14 @@ BlockingBounds* lp_global_fmlpp_bounds(
 	const ResourceSharingInfo& info,
 	unsigned int number_of_cpus)
 {
+	LinearProgramOriginScope origin(__func__);
+
 	BlockingBounds* results = new BlockingBounds(info);
 
-	for (unsigned int i = 0; i < info.get_tasks().size(); i++)
+	foreach_task_parallel(info.get_tasks().size(), [&](unsigned int i)
 	{
 		GlobalFMLPPlusAnalysis lp(info, i, number_of_cpus);
 		(*results)[i] = lp.solve();
-	}
+	});
 	return results;
 }
@@ -19,6 +19,7 @@
 #include "linprog/io.h"
 
 #include "lp_global.h"
+#include "lp_parallel.h"
 
 
 class GlobalPIPAnalysis : public GlobalPrioInheritanceLP, public GlobalPriorityQueuesLP
@@ -46,13 +47,15 @@ BlockingBounds* lp_global_pip_bounds(
 	const ResourceSharingInfo& info,
 	unsigned int number_of_cpus)
 {
+	LinearProgramOriginScope origin(__func__);
+
 	BlockingBounds* results = new BlockingBounds(info);
 
-	for (unsigned int i = 0; i < info.get_tasks().size(); i++)
+	foreach_task_parallel(info.get_tasks().size(), [&](unsigned int i)
 	{
 		GlobalPIPAnalysis lp(info, i, number_of_cpus);
 		(*results)[i] = lp.solve();
-	}
+	});
 
 	return results;
 }
@@ -2,6 +2,7 @@
 #include <set>
 #include <algorithm>
 #include <cmath>
+#include <mutex>
 
 #include "lp_common.h"
 #include "blocking.h"
@@ -10,6 +11,7 @@
 #include "cpu_time.h"
 
 #include "mpcp.h"
+#include "lp_parallel.h"
 
 #define NO_BOUND (-1)
 
@@ -26,6 +28,9 @@ private:
 
 	hashmap< unsigned long, hashmap< unsigned int, unsigned long> > gcs_response;
 
+	// remote_delay is filled lazily, possibly by several analysis threads
+	std::mutex remote_delay_lock;
+
 	const ResourceSharingInfo &info;
 	const MPCPCeilings &prio_ceilings;
 
@@ -46,6 +51,8 @@ public:
 
 	long get_max_remote_delay(const TaskInfo &ti, unsigned int res_id)
 	{
+		std::lock_guard<std::mutex> guard(remote_delay_lock);
+
 		if (remote_delay.find(ti.get_id()) == remote_delay.end())
 			remote_delay[ti.get_id()] = hashmap<unsigned int, long>();
 
@@ -482,23 +489,20 @@ static void add_mpcp_constraints(
 	add_remote_blocking_constraint(vars, info, gcs_response, ti, lp);
 }
 
-static void apply_mpcp_bounds_for_task(
-	unsigned int i,
-	BlockingBounds& bounds,
+static unsigned int build_mpcp_lp(
+	LinearProgram& lp,
 	const ResourceSharingInfo& info,
+	const TaskInfo& ti,
 	const MPCPCeilings& prio_ceilings,
-	GcsResponseTimes &gcs_response)
+	GcsResponseTimes &gcs_response,
+	LinearExpression *local_obj,
+	LinearExpression *remote_obj)
 {
-	LinearProgram lp;
 	VarMapper vars;
-	const TaskInfo& ti = info.get_tasks()[i];
-	LinearExpression *local_obj = new LinearExpression();
-	LinearExpression *remote_obj = new LinearExpression();
+	vars.reserve(info);
 
 #if DEBUG_LP_OVERHEADS >= 2
 	static DEFINE_CPU_CLOCK(model_gen_cost);
-	static DEFINE_CPU_CLOCK(solver_cost);
-	static DEFINE_CPU_CLOCK(remote_cost);
 
 	std::cout << "---- " << __FUNCTION__ << " ----" << std::endl;
 
@@ -515,64 +519,67 @@ static void apply_mpcp_bounds_for_task(
 #if DEBUG_LP_OVERHEADS >= 2
 	model_gen_cost.stop();
 	std::cout << model_gen_cost << std::endl;
-	solver_cost.start();
-#endif
-
-	Solution *sol = linprog_solve(lp, vars.get_num_vars());
-
-#if DEBUG_LP_OVERHEADS >= 2
-	solver_cost.stop();
-	std::cout << solver_cost << std::endl;
 #endif
-	assert(sol != NULL);
-
-	Interference total, remote, local;
-
-	total.total_length = lrint(sol->evaluate(*lp.get_objective()));
-	local.total_length = lrint(sol->evaluate(*local_obj));
-
-	bounds[i] = total;
-	bounds.set_local_blocking(i, local);
-
-	delete local_obj;
-	delete sol;
-
-#if DEBUG_LP_OVERHEADS >= 2
-	remote_cost.start();
-#endif
-
-	// compute remote blocking maximum
-	lp.set_objective(remote_obj);
-	sol = linprog_solve(lp, vars.get_num_vars());
 
-	assert(sol != NULL);
-
-	remote.total_length = lrint(sol->evaluate(*lp.get_objective()));
-	bounds.set_remote_blocking(i, remote);
-
-#if DEBUG_LP_OVERHEADS >= 2
-	remote_cost.stop();
-	std::cout << remote_cost << std::endl;
-#endif
-	delete sol;
+	return vars.get_num_vars();
 }
 
 
 static BlockingBounds* _lp_mpcp_bounds(const ResourceSharingInfo& info)
 {
 	BlockingBounds* results = new BlockingBounds(info);
+	const unsigned int num_tasks = info.get_tasks().size();
+	std::vector<LinearExpression*> local_obj(num_tasks);
+	std::vector<LinearExpression*> remote_obj(num_tasks);
 
 	MPCPCeilings prio_ceilings = get_mpcp_ceilings(info);
-	GcsResponseTimes gcs_response = GcsResponseTimes(info, prio_ceilings);
+	GcsResponseTimes gcs_response(info, prio_ceilings);
+
+	solve_task_lps(num_tasks,
+		[&](unsigned int i, LinearProgram& lp)
+		{
+			local_obj[i] = new LinearExpression();
+			remote_obj[i] = new LinearExpression();
+			return build_mpcp_lp(lp, info, info.get_tasks()[i],
+					     prio_ceilings, gcs_response,
+					     local_obj[i], remote_obj[i]);
+		},
+		[&](unsigned int i, LinearProgram& lp, const Solution& sol)
+		{
+			if (local_obj[i])
+			{
+				Interference total, local;
+
+				total.total_length = lrint(sol.evaluate(*lp.get_objective()));
+				local.total_length = lrint(sol.evaluate(*local_obj[i]));
 
-	for (unsigned int i = 0; i < info.get_tasks().size(); i++)
-		apply_mpcp_bounds_for_task(i, *results, info, prio_ceilings, gcs_response);
+				(*results)[i] = total;
+				results->set_local_blocking(i, local);
+
+				delete local_obj[i];
+				local_obj[i] = NULL;
+
+				// compute remote blocking maximum
+				lp.set_objective(remote_obj[i]);
+				return true;
+			}
+			else
+			{
+				Interference remote;
+
+				remote.total_length = lrint(sol.evaluate(*lp.get_objective()));
+				results->set_remote_blocking(i, remote);
+				return false;
+			}
+		});
 
 	return results;
 }
 
 BlockingBounds* lp_mpcp_bounds(const ResourceSharingInfo& info)
 {
+	LinearProgramOriginScope origin(__func__);
+
 #if DEBUG_LP_OVERHEADS >= 1
 	static DEFINE_CPU_CLOCK(cpu_costs);
 
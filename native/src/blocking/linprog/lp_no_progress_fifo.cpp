@@ -19,6 +19,7 @@
 #include "linprog/io.h"
 
 #include "lp_global.h"
+#include "lp_parallel.h"
 
 class GlobalFIFONoProgressAnalysis
 	: public GlobalNoProgressMechanismLP, public GlobalFIFOQueuesLP
@@ -39,13 +40,15 @@ BlockingBounds* lp_no_progress_fifo_bounds(
 	const ResourceSharingInfo& info,
 	unsigned int number_of_cpus)
 {
+	LinearProgramOriginScope origin(__func__);
+
 	BlockingBounds* results = new BlockingBounds(info);
 
-	for (unsigned int i = 0; i < info.get_tasks().size(); i++)
+	foreach_task_parallel(info.get_tasks().size(), [&](unsigned int i)
 	{
 		GlobalFIFONoProgressAnalysis lp(info, i, number_of_cpus);
 		(*results)[i] = lp.solve();
-	}
+	});
 
 	return results;
 }
@@ -8,6 +8,7 @@
 #include "stl-hashmap.h"
 
 #include "cpu_time.h"
+#include "lp_parallel.h"
 
 // Per-cluster, per-resource access counts.
 typedef hashmap<unsigned int, unsigned int> AccessCounts;
@@ -185,6 +186,7 @@ static void apply_omip_bounds_for_task(
 {
 	LinearProgram lp;
 	VarMapper vars;
+	vars.reserve(info);
 	const TaskInfo& ti = info.get_tasks()[i];
 	unsigned int cluster = ti.get_cluster();
 
@@ -237,8 +239,15 @@ static BlockingBounds* _lp_omip_bounds(
 	PerClusterACounts pcacounts;
 	BlockingBounds* results = new BlockingBounds(info);
 
-	for (unsigned int i = 0; i < info.get_tasks().size(); i++)
+	// count accesses up front so that the per-task LPs only read pcacounts
+	foreach(info.get_tasks(), ti)
+		if (pcacounts.find(ti->get_cluster()) == pcacounts.end())
+			pcacounts[ti->get_cluster()] = count_accesses(info, ti->get_cluster());
+
+	foreach_task_parallel(info.get_tasks().size(), [&](unsigned int i)
+	{
 		apply_omip_bounds_for_task(i, *results, info, pcacounts, num_procs, cluster_size);
+	});
 
 	return results;
 }
@@ -248,6 +257,8 @@ BlockingBounds* lp_omip_bounds(
 	unsigned int num_procs,
 	unsigned int cluster_size)
 {
+	LinearProgramOriginScope origin(__func__);
+
 	assert(num_procs >= cluster_size);
 	assert(num_procs % cluster_size == 0);
 
@@ -0,0 +1,47 @@
+#include <algorithm>
+#include <thread>
+
+#include "lp_analysis.h"
+#include "lp_parallel.h"
+
+// 1 = solve per-task LPs sequentially (default), 0 = one worker per
+// hardware thread
+static std::atomic<unsigned int> lp_analysis_num_threads(1);
+
+// false = solve each per-task LP on its own (default)
+static std::atomic<bool> lp_analysis_merge(false);
+
+void set_lp_analysis_num_threads(unsigned int num_threads)
+{
+	lp_analysis_num_threads = num_threads;
+}
+
+unsigned int get_lp_analysis_num_threads()
+{
+	return lp_analysis_num_threads;
+}
+
+unsigned int lp_analysis_workers_for(unsigned int num_jobs)
+{
+	unsigned int num_threads = lp_analysis_num_threads;
+
+	if (!num_threads)
+		num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+	return std::min(num_threads, num_jobs);
+}
+
+void set_lp_merge_task_lps(bool merge)
+{
+	lp_analysis_merge = merge;
+}
+
+bool get_lp_merge_task_lps()
+{
+	return lp_analysis_merge;
+}
+
+bool lp_analysis_merge_task_lps()
+{
+	return lp_analysis_merge;
+}
@@ -1,5 +1,6 @@
 #include <stdint.h>
 #include <cassert>
+#include <algorithm>
 #include <climits>
 #include <cmath>
 
@@ -19,117 +20,345 @@
 #include "linprog/io.h"
 
 #include "lp_pedf_analysis.h"
+#include "lp_analysis.h"
+#include "lp_parallel.h"
 
 // ------------------------------------------------------------------
 // --------------------[ A N A L Y S I S ]---------------------------
 // ------------------------------------------------------------------
 
-#ifdef __PEDF_BLK_ANALYSIS_ENABLE_TIMEOUT__
+// PEDF_HORIZON_NONE = iterate until the busy window converges (default)
+static std::atomic<int> pedf_horizon(PEDF_HORIZON_NONE);
 
-#include <signal.h>
-#include <unistd.h>
+void set_pedf_analysis_horizon(pedf_horizon_t horizon)
+{
+	pedf_horizon = horizon;
+}
 
-bool timeout_fired = false;
-const unsigned TIMEOUT = 60; // seconds
-#endif
+pedf_horizon_t get_pedf_analysis_horizon()
+{
+	return (pedf_horizon_t) pedf_horizon.load();
+}
+
+static std::atomic<bool> pedf_bound_caching(true);
 
-#ifdef __PEDF_BLK_ANALYSIS_ENABLE_HP_STOP__
-unsigned long gcd(unsigned long a, unsigned long b)
+void set_pedf_bound_caching(bool enabled)
 {
-	while(true)
-	{
-		if (a == 0)
-			return b;
-		b %= a;
+	pedf_bound_caching = enabled;
+}
+
+bool get_pedf_bound_caching()
+{
+	return pedf_bound_caching;
+}
 
-		if (b == 0)
-			return a;
-		a %= b;
+static thread_local std::vector<PEDFCheckPoint>* check_point_trace = NULL;
+
+void set_pedf_check_point_trace(std::vector<PEDFCheckPoint>* trace)
+{
+	check_point_trace = trace;
+}
+
+void PEDFBlockingAnalysis::trace(analysis_type_t mode, unsigned long interval_length,
+                                 unsigned long relaxed, bool has_tight,
+                                 unsigned long tight) const
+{
+	if (!check_point_trace)
+		return;
+
+	PEDFCheckPoint cp;
+	cp.cluster = cluster;
+	cp.mode = mode;
+	cp.interval_length = interval_length;
+	cp.relaxed = relaxed;
+	cp.has_tight = has_tight;
+	cp.tight = tight;
+	check_point_trace->push_back(cp);
+}
+
+static unsigned long gcd(unsigned long a, unsigned long b)
+{
+	while (b)
+	{
+		const unsigned long r = a % b;
+		a = b;
+		b = r;
 	}
+	return a;
 }
 
-unsigned long lcm(unsigned long a, unsigned long b)
+// Hyper-period of all tasks in the system, or ULONG_MAX if it does not fit
+unsigned long saturating_hyper_period(const ResourceSharingInfo& info)
 {
-	unsigned long temp = gcd(a, b);
-	return temp ? (a / temp * b) : 0;
+	unsigned __int128 hyper_period = 1;
+
+	foreach(info.get_tasks(), T_i)
+	{
+		const unsigned long period = T_i->get_period();
+		hyper_period = hyper_period / gcd(period, hyper_period % period) * period;
+		if (hyper_period >= ULONG_MAX)
+			return ULONG_MAX;
+	}
+
+	return (unsigned long) hyper_period;
 }
-#endif
 
 PEDFBlockingAnalysis::PEDFBlockingAnalysis(const ResourceSharingInfo& _info, unsigned int _cluster) :
-	info(_info), cluster(_cluster)
+	info(_info), cluster(_cluster),
+	ac_session(linprog_create_session()),
+	pdc_session(linprog_create_session()),
+	tight_pdc_session(linprog_create_session()),
+	cancelled(NULL)
 {
+	const std::vector<unsigned long>& deadlines =
+		info.get_cluster_index().get_cluster(cluster).deadlines;
+
 	max_deadline = 0;
 
-	foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
-	max_deadline = (max_deadline > T_i->get_deadline() ? max_deadline : T_i->get_deadline());
+	foreach(deadlines, D_i)
+	max_deadline = (max_deadline > *D_i ? max_deadline : *D_i);
 
 	min_deadline = max_deadline;
 
-	foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
-	min_deadline = (T_i->get_deadline() < min_deadline ? T_i->get_deadline() : min_deadline);
+	foreach(deadlines, D_i)
+	min_deadline = (*D_i < min_deadline ? *D_i : min_deadline);
+
+	const ClusterIndex::Cluster& local = info.get_cluster_index().get_cluster(cluster);
+	for (unsigned int k = 0; k < local.costs.size(); k++)
+	{
+		// nljobs(T_i,t) steps at D_i + j * T_i, ceil(t / T_i) at 1 + j * T_i
+		local_demand.add(local.deadlines[k], local.periods[k], local.costs[k]);
+		local_arrivals.add(1, local.periods[k], local.costs[k]);
+	}
+
+	foreach_indexed_task_not_in_cluster(info, cluster, T_i)
+	{
+		// nrjobs(T_i,t) steps at j * T_i - D_i + 1 for the j >= 1 for which
+		// this is positive
+		const unsigned long period = T_i->get_period();
+		const unsigned long deadline = T_i->get_deadline();
+		unsigned long first_job = divide_with_ceil(deadline, period);
+		if (first_job < 1)
+			first_job = 1;
+		remote_arrivals.add(first_job * period - deadline + 1, period, 0);
+	}
+}
+
+PEDFBlockingAnalysis::~PEDFBlockingAnalysis()
+{
+	delete ac_session;
+	delete pdc_session;
+	delete tight_pdc_session;
 }
 
-unsigned long PEDFBlockingAnalysis::DBF(unsigned long interval_length)
+void PEDFBlockingAnalysis::parameters_changed()
 {
-	unsigned long retval = 0;
-	foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
-	retval += T_i->get_pedf_PDC_max_num_local_jobs(interval_length) * T_i->get_cost();
+	ac_bounds = PiecewiseBlockingBound();
+	pdc_bounds = PiecewiseBlockingBound();
 
-	return retval;
+	// the step points depend only on the periods and deadlines
+	const ClusterIndex::Cluster& local = info.get_cluster_index().get_cluster(cluster);
+	for (unsigned int k = 0; k < local.costs.size(); k++)
+	{
+		local_demand.set_weight(k, local.costs[k]);
+		local_arrivals.set_weight(k, local.costs[k]);
+	}
+
+	reset_blocking_state();
 }
 
-unsigned long PEDFBlockingAnalysis::arrival_curve(unsigned long interval_length)
+void IncrementalStepSum::add(unsigned long first, unsigned long period, unsigned long weight)
+{
+	Step s;
+	s.first = first;
+	s.period = period;
+	s.weight = weight;
+	s.count = count_at(s, position);
+
+	const unsigned int k = steps.size();
+	steps.push_back(s);
+
+	total += s.count * weight;
+	if (s.count)
+		last_points.insert(std::make_pair(first + (s.count - 1) * period, k));
+	next_points.insert(std::make_pair(first + s.count * period, k));
+}
+
+void IncrementalStepSum::update(unsigned int k, unsigned long t)
 {
-	unsigned long retval = 0;
-	foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
-	retval += T_i->get_pedf_AC_max_num_local_jobs(interval_length) * T_i->get_cost();
+	Step& s = steps[k];
 
-	return retval;
+	if (s.count)
+		last_points.erase(std::make_pair(s.first + (s.count - 1) * s.period, k));
+	next_points.erase(std::make_pair(s.first + s.count * s.period, k));
+
+	total -= s.count * s.weight;
+	s.count = count_at(s, t);
+	total += s.count * s.weight;
+
+	if (s.count)
+		last_points.insert(std::make_pair(s.first + (s.count - 1) * s.period, k));
+	next_points.insert(std::make_pair(s.first + s.count * s.period, k));
 }
 
-#ifdef __PEDF_BLK_ANALYSIS_ENABLE_TIMEOUT__
-void watchdog_handler(int sig)
+void IncrementalStepSum::move_to(unsigned long t)
 {
-	timeout_fired = true;
+	// Every step function whose last point lies above t (or whose next
+	// point is reached by t) changes its count. Its new count is computed
+	// directly, so a large move costs at most one update per function.
+	if (t < position)
+		while (!last_points.empty() && last_points.rbegin()->first > t)
+			update(last_points.rbegin()->second, t);
+	else
+		while (!next_points.empty() && next_points.begin()->first <= t)
+			update(next_points.begin()->second, t);
+
+	position = t;
 }
-#endif
 
-bool PEDFBlockingAnalysis::is_schedulable()
+unsigned long PEDFBlockingAnalysis::DBF(unsigned long interval_length)
 {
+	local_demand.move_to(interval_length);
+	return local_demand.value();
+}
 
-	unsigned long lastBW_Len = 1;
+unsigned long PEDFBlockingAnalysis::arrival_curve(unsigned long interval_length)
+{
+	local_arrivals.move_to(interval_length);
+	return local_arrivals.value();
+}
+
+void PEDFBlockingAnalysis::step_region(unsigned long interval_length,
+                                       PiecewiseBlockingBound::region_t& region) const
+{
+	region.clear();
 
-#ifdef __PEDF_BLK_ANALYSIS_ENABLE_HP_STOP__
-	unsigned long hyper_period = 1;
+	// the LPs of the lock-free analyses drop the blocking lower bound
+	// up to max_deadline
+	region.push_back(interval_length <= max_deadline);
 
 	foreach(info.get_tasks(), T_i)
 	{
-		hyper_period = lcm(hyper_period, T_i->get_period());
+		region.push_back(T_i->get_deadline() <= interval_length);
+		region.push_back(T_i->get_pedf_max_num_remote_jobs(interval_length));
+		region.push_back(T_i->get_pedf_PDC_max_num_local_jobs(interval_length));
+		region.push_back(T_i->get_pedf_AC_max_num_local_jobs(interval_length));
 	}
-#endif
+}
 
-#if defined(__DEBUG_PEDF_BLK_ANALYSIS__) && defined(__PEDF_BLK_ANALYSIS_ENABLE_HP_STOP__)
-	std::cout << "[PEDF-BLK] Hyper-period = " << hyper_period << std::endl;
-#endif
+PiecewiseBlockingBound::Bounds& PEDFBlockingAnalysis::bounds_at(analysis_type_t mode,
+                                                                 unsigned long interval_length)
+{
+	if (!get_pedf_bound_caching())
+	{
+		meter.charge();
+		uncached.relaxed = (mode == AC_MODE)
+			? compute_blocking_AC(interval_length)
+			: compute_blocking_PDC(interval_length);
+		uncached.has_tight = false;
+		return uncached;
+	}
 
-	unsigned long blk_LB_in = 0, blk_LB_out = 0;
+	PiecewiseBlockingBound& cache = (mode == AC_MODE) ? ac_bounds : pdc_bounds;
+	PiecewiseBlockingBound::Bounds* b = cache.lookup(interval_length);
 
-#ifdef __PEDF_BLK_ANALYSIS_ENABLE_TIMEOUT__
+	if (!b)
+	{
+		PiecewiseBlockingBound::region_t region;
 
-	timeout_fired = false;
+		step_region(interval_length, region);
+		b = cache.lookup(region, interval_length);
+		if (!b)
+		{
+			meter.charge();
+			const unsigned long blk = (mode == AC_MODE)
+				? compute_blocking_AC(interval_length)
+				: compute_blocking_PDC(interval_length);
+			b = cache.insert(region, interval_length, blk);
+		}
+	}
 
-	// Setup for the timeout
-	signal(SIGALRM, watchdog_handler);
-	alarm(TIMEOUT);
+	return *b;
+}
 
-	while (!timeout_fired)
-#else
-	while (true)
+unsigned long PEDFBlockingAnalysis::blocking_PDC(unsigned long interval_length)
+{
+	return bounds_at(PDC_MODE, interval_length).relaxed;
+}
+
+unsigned long PEDFBlockingAnalysis::blocking_AC(unsigned long interval_length)
+{
+	return bounds_at(AC_MODE, interval_length).relaxed;
+}
+
+// The lower bound only adds a constraint that is never binding (the
+// blocking is non-negative), so it does not distinguish LPs. The upper
+// bound is an input of the LP; the callers pass the relaxed bound of the
+// same region, which is thus all that the tightened bound depends on.
+unsigned long PEDFBlockingAnalysis::tighter_blocking_PDC(unsigned long interval_length,
+                                                       unsigned long blk_UB,
+                                                       unsigned long blk_LB)
+{
+	if (!get_pedf_bound_caching())
+	{
+		meter.charge();
+		return compute_tighter_blocking_PDC(interval_length, blk_UB, blk_LB);
+	}
+
+	PiecewiseBlockingBound::Bounds& b = bounds_at(PDC_MODE, interval_length);
+
+	if (b.relaxed != blk_UB)
+	{
+		meter.charge();
+		return compute_tighter_blocking_PDC(interval_length, blk_UB, blk_LB);
+	}
+
+	if (!b.has_tight)
+	{
+		meter.charge();
+		b.tight = compute_tighter_blocking_PDC(interval_length, blk_UB, blk_LB);
+		b.has_tight = true;
+	}
+
+	return b.tight;
+}
+
+bool PEDFBlockingAnalysis::is_schedulable()
+{
+
+	unsigned long lastBW_Len = 1;
+
+	// Pre-filter: on an over-utilized processor, the demand exceeds the
+	// interval length eventually, with or without blocking. (Utilizations
+	// that exceed 1 only by rounding are left to the analysis.)
+	const ClusterIndex::Cluster& local = info.get_cluster_index().get_cluster(cluster);
+	double utilization = 0;
+	for (unsigned int k = 0; k < local.costs.size(); k++)
+		utilization += (double) local.costs[k] / local.periods[k];
+	if (utilization > 1 + 1E-9)
+		return false;
+
+	const pedf_horizon_t horizon_mode = get_pedf_analysis_horizon();
+	const unsigned long horizon = (horizon_mode == PEDF_HORIZON_NONE) ? ULONG_MAX : safe_horizon();
+	const unsigned long hyper_period =
+		(horizon_mode == PEDF_HORIZON_HYPERPERIOD) ? saturating_hyper_period(info) : ULONG_MAX;
+
+#ifdef __DEBUG_PEDF_BLK_ANALYSIS__
+	std::cout << "[PEDF-BLK] Horizon = " << horizon << " Hyper-period = " << hyper_period << std::endl;
 #endif
+
+	unsigned long blk_LB_in = 0, blk_LB_out = 0;
+
+	while (true)
 		// Perform PDC until the first idle-time
 	{
+		if (should_stop())
+			return false;
+
 		// Fixed-point iteration step
-		unsigned long newBW_Len = arrival_curve(lastBW_Len) + compute_blocking_AC(lastBW_Len);
+		const unsigned long blk_AC = blocking_AC(lastBW_Len);
+		trace(AC_MODE, lastBW_Len, blk_AC);
+		unsigned long newBW_Len = arrival_curve(lastBW_Len) + blk_AC;
 
 #ifdef __DEBUG_PEDF_BLK_ANALYSIS__
 		std::cout << "[PEDF-BLK] ARRCRV Update : lastBW_Len = " << lastBW_Len << ", newBW_Len=" << newBW_Len << std::endl;
@@ -138,78 +367,102 @@ bool PEDFBlockingAnalysis::is_schedulable()
 		if (newBW_Len == lastBW_Len)
 			break;
 
-#ifdef __PEDF_BLK_ANALYSIS_ENABLE_HP_STOP__
 		if (newBW_Len > hyper_period)
 			return false;
-#endif
 
 		const unsigned long t_LB = (lastBW_Len > min_deadline) ? lastBW_Len : min_deadline;
+		const unsigned long t_UB = (newBW_Len < horizon) ? newBW_Len : horizon;
 
-		//if (!raw_PDC(t_LB, newBW_Len))
-		if (!QPA(t_LB, newBW_Len, blk_LB_in, blk_LB_out))
+		//if (!raw_PDC(t_LB, t_UB))
+		if (!QPA(t_LB, t_UB, blk_LB_in, blk_LB_out))
 			return false;
 
+		// no deadline can be missed beyond the horizon
+		if (newBW_Len >= horizon)
+			break;
+
 		blk_LB_in = blk_LB_out;
 
 		lastBW_Len = newBW_Len;
 	}
 
-#ifdef __PEDF_BLK_ANALYSIS_ENABLE_TIMEOUT__
-	if (timeout_fired)
-	{
-#ifdef __DEBUG_PEDF_BLK_ANALYSIS__
-		std::cout << "[PEDF-BLK] Timeout Fired" << std::endl;
-#endif
 
-		return false;
+	return true;
+}
+
+// Interval length from which on the total demand, bounded by the
+// closed-form blocking bound, never exceeds the interval length. With
+// DBF(t) <= U t + sum_i U_i (T_i - D_i) and blocking <= rate t + offset,
+// this holds for all t >= max(max_deadline, c / (1 - U - rate)) with
+// c = sum_i U_i (T_i - D_i) + offset (as in Zhang and Burns' bound).
+// Likewise, DBF(t) <= U t + sum_i C_i yields the bound
+// (sum_i C_i + offset) / (1 - U - rate), which has the form of the usual
+// bound on the busy window, but, like the first one, bounds the PDC
+// demand (DBF plus PDC blocking) directly. Hence only the closed-form PDC
+// bound is needed, and no bound on the AC blocking (which determines the
+// busy window that is actually iterated): no check point at or beyond the
+// horizon can fail, however long the busy window turns out to be.
+// ULONG_MAX if the analysis has no closed-form bound or if the bounded
+// demand is not below the interval length in the long run.
+unsigned long PEDFBlockingAnalysis::safe_horizon()
+{
+	double rate, offset;
+
+	if (!closed_form_blocking_rate_PDC(rate, offset))
+		return ULONG_MAX;
+
+	const ClusterIndex::Cluster& local = info.get_cluster_index().get_cluster(cluster);
+	double utilization = 0, scaled_slack = 0, total_cost = 0;
+
+	for (unsigned int k = 0; k < local.costs.size(); k++)
+	{
+		const double u = (double) local.costs[k] / local.periods[k];
+		utilization += u;
+		scaled_slack += u * ((double) local.periods[k] - (double) local.deadlines[k]);
+		total_cost += local.costs[k];
 	}
-#endif
 
-	return true;
+	const double slack_rate = 1 - utilization - rate;
+	if (slack_rate < 1E-9)
+		return ULONG_MAX;
+
+	const double zhang_burns = (scaled_slack + offset) / slack_rate;
+	const double busy_window = (total_cost + offset) / slack_rate;
+	const double horizon = ceil(zhang_burns < busy_window ? zhang_burns : busy_window) + 1;
+
+	if (horizon >= (double) ULONG_MAX)
+		return ULONG_MAX;
+
+	return std::max((unsigned long) horizon, (unsigned long) max_deadline + 1);
 }
 
 // Compute the last check-point < interval_length for the PDC
 unsigned long PEDFBlockingAnalysis::last_check_point_before(unsigned long interval_length)
 {
 	unsigned long last_check_point = 0;
+	unsigned long d;
 
-	foreach(info.get_tasks(), T_i)
-	{
-		// Local tasks
-		if (T_i->get_cluster() == cluster && T_i->get_deadline() < interval_length)
-		{
-			// steps of nljobs(T_i,t)
-			unsigned long d = divide_with_floor(interval_length - T_i->get_deadline(), T_i->get_period()) *
-			                  T_i->get_period() + T_i->get_deadline();
-			if (d == interval_length)
-				d = d - T_i->get_period();
-			if (d > last_check_point)
-				last_check_point = d;
-
-			// steps of ceil(T_i,t)
-			const unsigned long njobs = divide_with_ceil(interval_length, T_i->get_period());
-			d = (njobs - 1) * T_i->get_period() + 1;
-			if (d == interval_length)
-				d = d - T_i->get_period();
-			if (d > last_check_point)
-				last_check_point = d;
-		}
+	if (interval_length == 0)
+		return 0;
 
-		// Remote tasks
-		if (T_i->get_cluster() != cluster)
-		{
-			// steps of nrjobs(T_i,t)
-			const unsigned long njobs = divide_with_ceil(interval_length + T_i->get_deadline(), T_i->get_period());
-			if (njobs > 1)
-			{
-				unsigned long d = (njobs - 1) * T_i->get_period() - T_i->get_deadline() + 1;
-				if (d == interval_length)
-					d = d - T_i->get_period();
-				if (d > last_check_point)
-					last_check_point = d;
-			}
-		}
-	}
+	// The check points are the steps of nljobs(T_i,t) and ceil(T_i,t) of
+	// the local tasks and of nrjobs(T_i,t) of the remote tasks, i.e., the
+	// largest step point <= interval_length - 1 of any of these.
+	local_demand.move_to(interval_length - 1);
+	local_arrivals.move_to(interval_length - 1);
+	remote_arrivals.move_to(interval_length - 1);
+
+	if (local_demand.last_point(d) && d > last_check_point)
+		last_check_point = d;
+
+	// The first arrival at 1 only counts for tasks whose deadline lies
+	// before interval_length, in which case the deadline itself is a
+	// later check point.
+	if (local_arrivals.last_point(d) && d > 1 && d > last_check_point)
+		last_check_point = d;
+
+	if (remote_arrivals.last_point(d) && d > last_check_point)
+		last_check_point = d;
 
 	return last_check_point;
 }
@@ -237,25 +490,42 @@ bool PEDFBlockingAnalysis::QPA(unsigned long t_LB, unsigned long t_UB, unsigned
 		if (check_point < t_LB)
 			break;
 
+		if (should_stop())
+			return false;
+
 #ifdef __DEBUG_PEDF_BLK_ANALYSIS__
 		std::cout << "[QPA] Checking t = " << check_point << std::endl;
 #endif
 
-		// First compute a coarse-grain upper-bound with integer relaxation
-		unsigned long blk = compute_blocking_PDC(check_point);
-		total_demand = DBF(check_point) + blk;
+		// Pre-filter: without blocking, the demand is a lower bound on
+		// the total demand, and with the closed-form bound on blocking (if
+		// any) an upper bound. Only check points in between need an LP.
+		const unsigned long demand = DBF(check_point);
+		if (demand > check_point)
+			return false;
+
+		unsigned long blk;
+		if (!closed_form_blocking_PDC(check_point, blk) || demand + blk > check_point)
+			// First compute a coarse-grain upper-bound with integer relaxation
+			blk = blocking_PDC(check_point);
+		total_demand = demand + blk;
 
 #ifdef __DEBUG_PEDF_BLK_ANALYSIS__
 		std::cout << "[QPA] Blk UB = " << blk << " total_demand = " << total_demand << std::endl;
 #endif
 
+		if (total_demand <= check_point)
+			trace(PDC_MODE, check_point, blk);
+
 		if (total_demand < t_LB)
 			break;
 		if (total_demand > check_point)
 		{
 			// Compute the actual upper-bound without integer relaxation
-			blk = compute_tighter_blocking_PDC(check_point, blk, blk_LB_in);
+			const unsigned long blk_UB = blk;
+			blk = tighter_blocking_PDC(check_point, blk, blk_LB_in);
 			total_demand = DBF(check_point) + blk;
+			trace(PDC_MODE, check_point, blk_UB, true, blk);
 
 			if (!found_blk_LB)
 			{
@@ -321,7 +591,7 @@ bool PEDFBlockingAnalysis::raw_PDC(unsigned long t_LB, unsigned long t_UB)
 #endif
 
 			// First compute a coarse-grain upper-bound with integer relaxation
-			unsigned long blk = compute_blocking_PDC(check_point);
+			unsigned long blk = blocking_PDC(check_point);
 			total_demand = DBF(check_point) + blk;
 
 #ifdef __DEBUG_PEDF_BLK_ANALYSIS__
@@ -331,7 +601,7 @@ bool PEDFBlockingAnalysis::raw_PDC(unsigned long t_LB, unsigned long t_UB)
 			if (total_demand > check_point)
 			{
 				// Compute the actual upper-bound without integer relaxation
-				blk = compute_tighter_blocking_PDC(check_point, blk);
+				blk = tighter_blocking_PDC(check_point, blk, 0);
 				total_demand = DBF(check_point) + blk;
 
 #ifdef __DEBUG_PEDF_BLK_ANALYSIS__
@@ -350,4 +620,112 @@ bool PEDFBlockingAnalysis::raw_PDC(unsigned long t_LB, unsigned long t_UB)
 	}
 
 	return true;
-}
\ No newline at end of file
+}
+
+// ------------------------------------------------------------------
+// --------------------[ S E N S I T I V I T Y ]---------------------
+// ------------------------------------------------------------------
+
+static void copy_task_set(const ResourceSharingInfo& from, ResourceSharingInfo& to)
+{
+	foreach(from.get_tasks(), T_i)
+	{
+		to.add_task(T_i->get_period(), T_i->get_response(), T_i->get_cluster(),
+		            T_i->get_priority(), T_i->get_cost(), T_i->get_deadline());
+
+		foreach(T_i->get_requests(), req)
+			to.add_request_rw(req->get_resource_id(), req->get_num_requests(),
+			                  req->get_request_length(), req->get_request_type(),
+			                  req->get_request_priority());
+	}
+}
+
+// Bisection for the critical factor of one processor. probe is a copy of
+// info that is analysed by analysis and rescaled in place for each probe.
+// Sets exhausted if the budget ran out, in which case the returned factor
+// is only a lower bound.
+static double critical_factor(const ResourceSharingInfo& info,
+                              ResourceSharingInfo& probe,
+                              PEDFBlockingAnalysis& analysis,
+                              pedf_sensitivity_param_t param,
+                              double max_factor,
+                              double precision,
+                              AnalysisBudget* budget,
+                              bool& exhausted)
+{
+	// Is the processor schedulable at factor f? Without a verdict (the
+	// budget ran out), sets exhausted and returns false.
+	exhausted = false;
+	auto schedulable_at = [&](double f) -> bool
+	{
+		probe.set_scaled_parameters(info, param == PEDF_SCALE_WCETS ? f : 1, f);
+		analysis.parameters_changed();
+
+		const bool ok = analysis.is_schedulable();
+		exhausted = !ok && budget && budget->is_exhausted();
+		return ok;
+	};
+
+	// lo is schedulable if lo_ok, hi is not schedulable if hi_failed
+	double lo = 0, hi = max_factor;
+	bool lo_ok = false, hi_failed = false;
+
+	// start with the given task set, which is typically not far off
+	double f = (max_factor > 1) ? 1 : max_factor / 2;
+
+	// (stop also once the interval can no longer be split)
+	while (hi - lo > precision && lo < f && f < hi)
+	{
+		if (schedulable_at(f))
+		{
+			lo = f;
+			lo_ok = true;
+		}
+		else if (exhausted)
+			break;
+		else
+		{
+			hi = f;
+			hi_failed = true;
+		}
+		f = (lo + hi) / 2;
+	}
+
+	if (!exhausted && !hi_failed && schedulable_at(hi))
+		return hi;
+
+	if (!lo_ok && (exhausted || !schedulable_at(0)))
+		return -1;
+
+	return lo;
+}
+
+PEDFSensitivity* lp_pedf_sensitivity(const ResourceSharingInfo& info,
+                                     pedf_analysis_factory_t make_analysis,
+                                     pedf_sensitivity_param_t param,
+                                     double max_factor,
+                                     double precision,
+                                     AnalysisBudget* budget)
+{
+	const unsigned int num_clusters = info.get_cluster_index().get_num_clusters();
+	PEDFSensitivity* result = new PEDFSensitivity(num_clusters);
+
+	foreach_cluster_parallel(num_clusters, [&](unsigned int k)
+	{
+		// each processor scales its own copy of the task set
+		ResourceSharingInfo probe(info.get_tasks().size());
+		copy_task_set(info, probe);
+
+		PEDFBlockingAnalysis* analysis = make_analysis(probe, k);
+		analysis->set_budget(budget);
+
+		bool exhausted;
+		const double factor = critical_factor(info, probe, *analysis, param,
+		                                      max_factor, precision, budget,
+		                                      exhausted);
+		result->set_critical_factor(k, factor, exhausted);
+		delete analysis;
+	});
+
+	return result;
+}
@@ -20,6 +20,7 @@
 
 #include "lp_pedf_spinlocks_common.h"
 #include "lp_pedf_analysis.h"
+#include "lp_parallel.h"
 
 
 class FIFO_Preemptive : public PEDFBlockingAnalysisLP_Spinlocks
@@ -68,7 +69,7 @@ public:
 void FIFO_Preemptive::add_no_transitive_arrival_blocking()
 {
 	LinearExpression *exp = new LinearExpression();
-	foreach_task_not_in_cluster(info.get_tasks(), cluster, T_x)
+	foreach_indexed_task_not_in_cluster(info, cluster, T_x)
 	{
 		foreach(all_resources,q_iter)
 		{
@@ -91,7 +92,7 @@ void FIFO_Preemptive::add_max_number_of_cancellations()
 	LinearExpression *exp_no_canc = new LinearExpression();
 
 	// For each local task T_i
-	foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
+	foreach_indexed_task_in_cluster(info, cluster, T_i)
 	{
 		const unsigned int i = T_i->get_id();
 
@@ -115,7 +116,7 @@ void FIFO_Preemptive::add_max_number_of_cancellations()
 		}
 
 		unsigned int RHS = 0;
-		foreach_task_in_cluster_having_lt_dline(info.get_tasks(), cluster, T_i->get_deadline(), T_h)
+		foreach_indexed_task_in_cluster_having_lt_dline(info, cluster, T_i->get_deadline(), T_h)
 		{
 			// Compute Upper-Bound on the maximum number of preemptions on T_i by T_h
 			const long dline_diff = (long)T_i->get_deadline() - (long)T_h->get_deadline();
@@ -143,12 +144,12 @@ void FIFO_Preemptive::add_max_number_of_cancellations()
 void FIFO_Preemptive::add_max_overall_number_of_preemptions()
 {
 	// For each local task T_i
-	foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
+	foreach_indexed_task_in_cluster(info, cluster, T_i)
 	{
 		LinearExpression *exp = new LinearExpression();
 
 		// For each local task T_j having d_j <= d_i
-		foreach_task_in_cluster_having_leq_dline(info.get_tasks(), cluster, T_i->get_deadline(), T_j)
+		foreach_indexed_task_in_cluster_having_leq_dline(info, cluster, T_i->get_deadline(), T_j)
 		{
 			const unsigned int j = T_j->get_id();
 
@@ -162,7 +163,7 @@ void FIFO_Preemptive::add_max_overall_number_of_preemptions()
 		}
 
 		unsigned long RHS = 0;
-		foreach_task_in_cluster_having_lt_dline(info.get_tasks(), cluster, T_i->get_deadline(), T_x)
+		foreach_indexed_task_in_cluster_having_lt_dline(info, cluster, T_i->get_deadline(), T_x)
 		{
 			RHS += divide_with_ceil(interval_length, T_x->get_period());
 		}
@@ -187,7 +188,7 @@ void FIFO_Preemptive::add_at_max_one_request_per_processor_spin()
 			unsigned long RHS = 0;
 
 			// For each task T_x in processor k
-			foreach_task_in_cluster(info.get_tasks(), k, T_x)
+			foreach_indexed_task_in_cluster(info, k, T_x)
 			{
 				const unsigned int x = T_x->get_id();
 				var_t X_SPIN    = vars.spin(x, q);
@@ -195,7 +196,7 @@ void FIFO_Preemptive::add_at_max_one_request_per_processor_spin()
 			}
 
 			// For each task T_i in the processor under observation
-			foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
+			foreach_indexed_task_in_cluster(info, cluster, T_i)
 			{
 				const unsigned int i = T_i->get_id();
 				unsigned long njobs = 0;
@@ -265,10 +266,18 @@ class PEDFBlockingAnalysisFIFO_Preemptive : public PEDFBlockingAnalysis
 private:
 	unsigned long compute_blocking_PDC(unsigned long interval_length);
 	unsigned long compute_blocking_AC (unsigned long interval_length);
+	bool closed_form_blocking_PDC(unsigned long interval_length,
+	                              unsigned long& blk_UB);
+	bool closed_form_blocking_rate_PDC(double& rate, double& offset);
 	unsigned long compute_tighter_blocking_PDC(unsigned long interval_length,
 	        unsigned long blk_UB,
 	        unsigned long blk_LB = 0);
 
+	void reset_blocking_state()
+	{
+		ac_blocking_LB = 0;
+	}
+
 	unsigned long ac_blocking_LB;
 
 public:
@@ -285,7 +294,7 @@ unsigned long PEDFBlockingAnalysisFIFO_Preemptive::compute_blocking_PDC(unsigned
 {
 	FIFO_Preemptive mip(info, PDC_MODE, interval_length, cluster, 0);
 
-	return mip.solve(false);
+	return mip.solve(false, pdc_session);
 }
 
 // No integer relaxation
@@ -302,14 +311,14 @@ unsigned long PEDFBlockingAnalysisFIFO_Preemptive::compute_tighter_blocking_PDC(
 
 	FIFO_Preemptive mip(info, PDC_MODE, interval_length, cluster, pdc_blocking_LB, blk_UB, false);
 
-	return mip.solve(false);
+	return mip.solve(false, tight_pdc_session);
 }
 
 unsigned long PEDFBlockingAnalysisFIFO_Preemptive::compute_blocking_AC (unsigned long interval_length)
 {
 	FIFO_Preemptive mip(info, AC_MODE, interval_length, cluster, ac_blocking_LB, 0, false);
 
-	ac_blocking_LB = mip.solve(false);
+	ac_blocking_LB = mip.solve(false, ac_session);
 
 #ifdef __DEBUG_PEDF_BLK_ANALYSIS__
 	std::cout << "[FIFO-P] BLK AC = " << ac_blocking_LB << std::endl;
@@ -318,13 +327,32 @@ unsigned long PEDFBlockingAnalysisFIFO_Preemptive::compute_blocking_AC (unsigned
 	return ac_blocking_LB;
 }
 
+bool PEDFBlockingAnalysisFIFO_Preemptive::closed_form_blocking_PDC(unsigned long interval_length,
+        unsigned long& blk_UB)
+{
+	blk_UB = PEDFBlockingAnalysisLP_Spinlocks::closed_form_bound_PDC(info, cluster, interval_length);
+	return true;
+}
+
+bool PEDFBlockingAnalysisFIFO_Preemptive::closed_form_blocking_rate_PDC(double& rate, double& offset)
+{
+	PEDFBlockingAnalysisLP_Spinlocks::closed_form_bound_rate_PDC(info, cluster, rate, offset);
+	return true;
+}
+
 // ------------------------------------------------------------------
 // --------------------[ E N T R Y    P O I N T ]--------------------
 // ------------------------------------------------------------------
 
-bool lp_pedf_fifo_preempt_is_schedulable(const ResourceSharingInfo& info)
+bool lp_pedf_fifo_preempt_is_schedulable(const ResourceSharingInfo& info,
+                                         AnalysisBudget* budget)
 {
-	foreach_cluster(info, k)
+	LinearProgramOriginScope origin(__func__);
+
+	const unsigned int num_clusters = info.get_cluster_index().get_num_clusters();
+
+	return forall_clusters_parallel(num_clusters,
+		[&](unsigned int k, const std::atomic<bool>& cancelled)
 	{
 #ifdef __DEBUG_PEDF_BLK_ANALYSIS__
 		std::cout << "[FIFO-P] CPU#" << k << std::endl;
@@ -332,9 +360,26 @@ bool lp_pedf_fifo_preempt_is_schedulable(const ResourceSharingInfo& info)
 
 		// Perform schedulability analysis for each processor k
 		PEDFBlockingAnalysisFIFO_Preemptive analysis(info, k);
-		if (!analysis.is_schedulable())
-			return false;
-	}
+		analysis.set_cancellation_flag(&cancelled);
+		analysis.set_budget(budget);
+		return analysis.is_schedulable();
+	});
+}
 
-	return true;
-}
\ No newline at end of file
+PEDFBlockingAnalysis* make_pedf_fifo_preempt_analysis(const ResourceSharingInfo& info,
+                                                      unsigned int cluster)
+{
+	return new PEDFBlockingAnalysisFIFO_Preemptive(info, cluster);
+}
+
+PEDFSensitivity* lp_pedf_fifo_preempt_sensitivity(const ResourceSharingInfo& info,
+                                                  pedf_sensitivity_param_t param,
+                                                  double max_factor,
+                                                  double precision,
+                                                  AnalysisBudget* budget)
+{
+	LinearProgramOriginScope origin(__func__);
+
+	return lp_pedf_sensitivity(info, make_pedf_fifo_preempt_analysis, param,
+	                           max_factor, precision, budget);
+}
@@ -20,8 +20,9 @@
 
 #include "lp_pedf_lockfree_common.h"
 #include "lp_pedf_analysis.h"
+#include "lp_parallel.h"
 
-#define taskIterator TaskInfos::const_iterator
+#define taskIterator TaskIdRange::const_iterator
 
 class LockFree_NP : public PEDFBlockingAnalysisLP_LockFree
 {
@@ -69,7 +70,7 @@ public:
 void LockFree_NP::add_arrival_blocking_max_one_local_commit()
 {
 	LinearExpression *exp = new LinearExpression();
-	foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
+	foreach_indexed_task_in_cluster(info, cluster, T_i)
 	{
 		const unsigned int i = T_i->get_id();
 
@@ -90,7 +91,7 @@ void LockFree_NP::add_no_arrival_blocking_dline_inside_interval()
 {
 	LinearExpression *exp = new LinearExpression();
 
-	foreach_task_in_cluster_having_leq_dline(taskset, cluster, interval_length, T_i)
+	foreach_indexed_task_in_cluster_having_leq_dline(info, cluster, interval_length, T_i)
 	{
 		const unsigned int i = T_i->get_id();
 
@@ -111,7 +112,7 @@ void LockFree_NP::add_no_arrival_blocking_dline_inside_interval()
 // no commit loops on q
 void LockFree_NP::add_no_commit_no_arrival_blocking()
 {
-	foreach_task_in_cluster_having_leq_dline(taskset, cluster, interval_length, T_i)
+	foreach_indexed_task_in_cluster_having_leq_dline(info, cluster, interval_length, T_i)
 	{
 		const unsigned int i = T_i->get_id();
 
@@ -135,13 +136,13 @@ void LockFree_NP::add_transitive_arrival_blocking_max_one_local_commit()
 {
 	unsigned long bigM = 0;
 
-	foreach_task_not_in_cluster(info.get_tasks(), cluster, T_x)
+	foreach_indexed_task_not_in_cluster(info, cluster, T_x)
 	foreach(all_resources,q_iter)
 		bigM += T_x->get_pedf_max_num_remote_jobs(interval_length) * T_x->get_num_requests(*q_iter);
 
 	unsigned long njobs = 0;
 
-	foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
+	foreach_indexed_task_in_cluster(info, cluster, T_i)
 	{
 
 		if (lp_type == PDC_MODE)
@@ -177,7 +178,7 @@ void LockFree_NP::add_transitive_arrival_blocking_max_one_local_commit()
 void LockFree_NP::add_no_local_conflicts()
 {
 	LinearExpression *exp = new LinearExpression();
-	foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
+	foreach_indexed_task_in_cluster(info, cluster, T_i)
 	{
 		const unsigned int i = T_i->get_id();
 
@@ -185,7 +186,7 @@ void LockFree_NP::add_no_local_conflicts()
 		{
 			const unsigned int q = *q_iter;
 
-			foreach_task_in_cluster(info.get_tasks(), cluster, T_j)
+			foreach_indexed_task_in_cluster(info, cluster, T_j)
 			{
 				const unsigned int j = T_j->get_id();
 
@@ -211,7 +212,7 @@ unsigned long LockFree_NP::compute_NP_commit_response_time(taskIterator T_i, con
 	{
 		W_new = T_i->get_request_length(q);
 
-		foreach_task_not_in_cluster(info.get_tasks(), cluster, T_x)
+		foreach_indexed_task_not_in_cluster(info, cluster, T_x)
 		{
 			W_new += T_x->get_pedf_max_num_remote_jobs(W) * T_x->get_num_requests(q) *
 			         T_i->get_request_length(q);
@@ -229,7 +230,7 @@ unsigned long LockFree_NP::compute_NP_commit_response_time(taskIterator T_i, con
 void LockFree_NP::add_rta_based_bound_on_remote_conflicts()
 {
 
-	foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
+	foreach_indexed_task_in_cluster(info, cluster, T_i)
 	{
 		const unsigned int i = T_i->get_id();
 
@@ -255,7 +256,7 @@ void LockFree_NP::add_rta_based_bound_on_remote_conflicts()
 				njobs = T_i->get_pedf_AC_max_num_local_jobs(interval_length);
 
 			unsigned long RHS = 0;
-			foreach_task_not_in_cluster(info.get_tasks(), cluster, T_x)
+			foreach_indexed_task_not_in_cluster(info, cluster, T_x)
 			{
 				RHS += T_x->get_pedf_max_num_remote_jobs(W) * T_x->get_num_requests(q) *
 				       njobs * T_i->get_num_requests(q);
@@ -279,10 +280,18 @@ class PEDFBlockingAnalysisLockFree_NP : public PEDFBlockingAnalysis
 private:
 	unsigned long compute_blocking_PDC(unsigned long interval_length);
 	unsigned long compute_blocking_AC (unsigned long interval_length);
+	bool closed_form_blocking_PDC(unsigned long interval_length,
+	                              unsigned long& blk_UB);
+	bool closed_form_blocking_rate_PDC(double& rate, double& offset);
 	unsigned long compute_tighter_blocking_PDC(unsigned long interval_length,
 	        unsigned long blk_UB,
 	        unsigned long blk_LB = 0);
 
+	void reset_blocking_state()
+	{
+		ac_blocking_LB = 0;
+	}
+
 	unsigned long ac_blocking_LB;
 
 public:
@@ -300,7 +309,7 @@ unsigned long PEDFBlockingAnalysisLockFree_NP::compute_blocking_PDC(unsigned lon
 
 	LockFree_NP mip(info, PDC_MODE, interval_length, cluster, 0);
 
-	return mip.solve(false);
+	return mip.solve(false, pdc_session);
 }
 
 // No integer relaxation
@@ -317,7 +326,7 @@ unsigned long PEDFBlockingAnalysisLockFree_NP::compute_tighter_blocking_PDC(
 
 	LockFree_NP mip(info, PDC_MODE, interval_length, cluster, pdc_blocking_LB, blk_UB, false);
 
-	pdc_blocking_LB = mip.solve(false);
+	pdc_blocking_LB = mip.solve(false, tight_pdc_session);
 	return pdc_blocking_LB;
 }
 
@@ -325,17 +334,51 @@ unsigned long PEDFBlockingAnalysisLockFree_NP::compute_blocking_AC (unsigned lon
 {
 	LockFree_NP mip(info, AC_MODE, interval_length, cluster, ac_blocking_LB, 0, false);
 
-	ac_blocking_LB = mip.solve(false);
+	ac_blocking_LB = mip.solve(false, ac_session);
 	return ac_blocking_LB;
 }
 
+// Remote commits plus at most one local commit that causes arrival blocking
+bool PEDFBlockingAnalysisLockFree_NP::closed_form_blocking_PDC(unsigned long interval_length,
+        unsigned long& blk_UB)
+{
+	blk_UB = PEDFBlockingAnalysisLP_LockFree::closed_form_remote_bound(info, cluster, interval_length);
+
+	unsigned long max_arrival = 0;
+	foreach_indexed_task_in_cluster(info, cluster, T_i)
+		if (T_i->get_max_request_length() > max_arrival)
+			max_arrival = T_i->get_max_request_length();
+
+	blk_UB += max_arrival;
+	return true;
+}
+
+bool PEDFBlockingAnalysisLockFree_NP::closed_form_blocking_rate_PDC(double& rate, double& offset)
+{
+	PEDFBlockingAnalysisLP_LockFree::closed_form_remote_bound_rate(info, cluster, rate, offset);
+
+	unsigned long max_arrival = 0;
+	foreach_indexed_task_in_cluster(info, cluster, T_i)
+		if (T_i->get_max_request_length() > max_arrival)
+			max_arrival = T_i->get_max_request_length();
+
+	offset += max_arrival;
+	return true;
+}
+
 // ------------------------------------------------------------------
 // --------------------[ E N T R Y    P O I N T ]--------------------
 // ------------------------------------------------------------------
 
-bool lp_pedf_lockfree_NP_is_schedulable(const ResourceSharingInfo& info)
+bool lp_pedf_lockfree_NP_is_schedulable(const ResourceSharingInfo& info,
+                                        AnalysisBudget* budget)
 {
-	foreach_cluster(info, k)
+	LinearProgramOriginScope origin(__func__);
+
+	const unsigned int num_clusters = info.get_cluster_index().get_num_clusters();
+
+	return forall_clusters_parallel(num_clusters,
+		[&](unsigned int k, const std::atomic<bool>& cancelled)
 	{
 #ifdef __DEBUG_PEDF_BLK_ANALYSIS__
 		std::cout << "[LF-NP] CPU#" << k << std::endl;
@@ -343,9 +386,26 @@ bool lp_pedf_lockfree_NP_is_schedulable(const ResourceSharingInfo& info)
 
 		// Perform schedulability analysis for each processor k
 		PEDFBlockingAnalysisLockFree_NP analysis(info, k);
-		if (!analysis.is_schedulable())
-			return false;
-	}
+		analysis.set_cancellation_flag(&cancelled);
+		analysis.set_budget(budget);
+		return analysis.is_schedulable();
+	});
+}
 
-	return true;
-}
\ No newline at end of file
+PEDFBlockingAnalysis* make_pedf_lockfree_NP_analysis(const ResourceSharingInfo& info,
+                                                     unsigned int cluster)
+{
+	return new PEDFBlockingAnalysisLockFree_NP(info, cluster);
+}
+
+PEDFSensitivity* lp_pedf_lockfree_NP_sensitivity(const ResourceSharingInfo& info,
+                                                 pedf_sensitivity_param_t param,
+                                                 double max_factor,
+                                                 double precision,
+                                                 AnalysisBudget* budget)
+{
+	LinearProgramOriginScope origin(__func__);
+
+	return lp_pedf_sensitivity(info, make_pedf_lockfree_NP_analysis, param,
+	                           max_factor, precision, budget);
+}
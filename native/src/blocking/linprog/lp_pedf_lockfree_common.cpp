@@ -70,6 +70,8 @@ PEDFBlockingAnalysisLP_LockFree::PEDFBlockingAnalysisLP_LockFree(
 	  all_resources(get_all_resources(_info))
 {
 	integer_relaxation = relax;
+	vars.reserve(taskset.size(),
+	             all_resources.empty() ? 0 : *all_resources.rbegin() + 1);
 
 	// Add generic constraints
 
@@ -82,8 +84,13 @@ PEDFBlockingAnalysisLP_LockFree::PEDFBlockingAnalysisLP_LockFree(
 
 	set_objective();
 }
-unsigned long PEDFBlockingAnalysisLP_LockFree::solve(bool verbose)
+unsigned long PEDFBlockingAnalysisLP_LockFree::solve(bool verbose, LinearProgramSession *session)
 {
+	// tag captured LPs with the analyzed interval
+	LinearProgramOrigin here = linprog_get_origin();
+	here.interval = interval_length;
+	LinearProgramOriginScope origin(here);
+
 	Solution *sol;
 	double result;
 
@@ -100,7 +107,10 @@ unsigned long PEDFBlockingAnalysisLP_LockFree::solve(bool verbose)
 		std::cout << "LP for t=" << interval_length << ":" << std::endl;
 		pretty_print_linear_program(std::cout, *this, var_map) << std::endl;
 
-		sol = linprog_solve(*this, vars.get_num_vars());
+		if (session)
+			sol = session->solve(*this, vars.get_num_vars());
+		else
+			sol = linprog_solve(*this, vars.get_num_vars());
 		result = floor(sol->evaluate(*get_objective()));
 
 		std::cout << "Solution: " << result << std::endl;
@@ -114,7 +124,10 @@ unsigned long PEDFBlockingAnalysisLP_LockFree::solve(bool verbose)
 	}
 	else
 	{
-		sol = linprog_solve(*this, vars.get_num_vars());
+		if (session)
+			sol = session->solve(*this, vars.get_num_vars());
+		else
+			sol = linprog_solve(*this, vars.get_num_vars());
 		result = floor(sol->evaluate(*get_objective()));
 	}
 
@@ -123,6 +136,61 @@ unsigned long PEDFBlockingAnalysisLP_LockFree::solve(bool verbose)
 	return (unsigned long) result;
 }
 
+unsigned long PEDFBlockingAnalysisLP_LockFree::max_local_commit_length(
+    const ResourceSharingInfo& info,
+    unsigned int cluster,
+    unsigned int q)
+{
+	unsigned long length = 0;
+
+	foreach_indexed_task_in_cluster(info, cluster, T_i)
+		if (T_i->get_request_length(q) > length)
+			length = T_i->get_request_length(q);
+
+	return length;
+}
+
+unsigned long PEDFBlockingAnalysisLP_LockFree::closed_form_remote_bound(
+    const ResourceSharingInfo& info,
+    unsigned int cluster,
+    unsigned long interval_length)
+{
+	unsigned long bound = 0;
+
+	foreach_indexed_task_not_in_cluster(info, cluster, T_x)
+	{
+		const unsigned long nrjobs = T_x->get_pedf_max_num_remote_jobs(interval_length);
+
+		foreach(T_x->get_requests(), request)
+			bound += nrjobs * request->get_num_requests() *
+			         max_local_commit_length(info, cluster, request->get_resource_id());
+	}
+
+	return bound;
+}
+
+// nrjobs(T_x, t) = ceil((t + D_x) / T_x) <= t / T_x + D_x / T_x + 1
+void PEDFBlockingAnalysisLP_LockFree::closed_form_remote_bound_rate(
+    const ResourceSharingInfo& info,
+    unsigned int cluster,
+    double& rate, double& offset)
+{
+	rate = offset = 0;
+
+	foreach_indexed_task_not_in_cluster(info, cluster, T_x)
+	{
+		const double period = T_x->get_period();
+
+		foreach(T_x->get_requests(), request)
+		{
+			const double demand = (double) request->get_num_requests() *
+			                      max_local_commit_length(info, cluster, request->get_resource_id());
+			rate   += demand / period;
+			offset += demand * (T_x->get_deadline() / period + 1);
+		}
+	}
+}
+
 // ------------------------------------------------------------------
 // ----------------------[ O B J E C T I V E ]-----------------------
 // ------------------------------------------------------------------
@@ -130,7 +198,7 @@ void PEDFBlockingAnalysisLP_LockFree::set_objective()
 {
 	LinearExpression *obj = get_objective();
 
-	foreach_task_in_cluster(taskset, cluster, T_i)
+	foreach_indexed_task_in_cluster(info, cluster, T_i)
 	{
 		const unsigned int i = T_i->get_id();
 
@@ -155,7 +223,7 @@ void PEDFBlockingAnalysisLP_LockFree::set_objective()
 			obj->add_term(length, Y_R_i_q);
 			obj->add_term(length, A_i_q);
 
-			foreach_task_in_cluster(taskset, cluster, T_j)
+			foreach_indexed_task_in_cluster(info, cluster, T_j)
 			{
 				const unsigned int j = T_j->get_id();
 				var_t Y_L_i_j_q  = vars.local_conflicts(i, j, q);
@@ -185,7 +253,7 @@ void PEDFBlockingAnalysisLP_LockFree::add_blocking_upper_and_lower_bound(
 	LinearExpression *obj_minus = new LinearExpression();
 	LinearExpression *obj_plus  = new LinearExpression();
 
-	foreach_task_in_cluster(taskset, cluster, T_i)
+	foreach_indexed_task_in_cluster(info, cluster, T_i)
 	{
 		const unsigned int i = T_i->get_id();
 
@@ -203,7 +271,7 @@ void PEDFBlockingAnalysisLP_LockFree::add_blocking_upper_and_lower_bound(
 			obj_minus->sub_term(length, Y_R_i_q);
 			obj_minus->sub_term(length, A_i_q);
 
-			foreach_task_in_cluster(taskset, cluster, T_j)
+			foreach_indexed_task_in_cluster(info, cluster, T_j)
 			{
 				const unsigned int j = T_j->get_id();
 				var_t Y_R_i_j_q  = vars.local_conflicts(i, j, q);
@@ -227,7 +295,7 @@ void PEDFBlockingAnalysisLP_LockFree::add_blocking_upper_and_lower_bound(
 void PEDFBlockingAnalysisLP_LockFree::add_no_retries_for_resources_not_accessed()
 {
 	LinearExpression *exp = new LinearExpression();
-	foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
+	foreach_indexed_task_in_cluster(info, cluster, T_i)
 	{
 		const unsigned int i = T_i->get_id();
 
@@ -243,7 +311,7 @@ void PEDFBlockingAnalysisLP_LockFree::add_no_retries_for_resources_not_accessed(
 
 			exp->add_var(Y_R_i_q);
 
-			foreach_task_in_cluster(info.get_tasks(), cluster, T_j)
+			foreach_indexed_task_in_cluster(info, cluster, T_j)
 			{
 				const unsigned int j = T_j->get_id();
 				var_t Y_L_i_j_q = vars.local_conflicts(i, j, q);
@@ -264,7 +332,7 @@ void PEDFBlockingAnalysisLP_LockFree::add_one_retry_for_at_most_one_remote_commi
 
 		LinearExpression *exp = new LinearExpression();
 
-		foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
+		foreach_indexed_task_in_cluster(info, cluster, T_i)
 		{
 			const unsigned int i = T_i->get_id();
 			var_t Y_R_i_q = vars.remote_conflicts(i, q);
@@ -272,7 +340,7 @@ void PEDFBlockingAnalysisLP_LockFree::add_one_retry_for_at_most_one_remote_commi
 		}
 
 		unsigned long RHS = 0;
-		foreach_task_not_in_cluster(info.get_tasks(), cluster, T_x)
+		foreach_indexed_task_not_in_cluster(info, cluster, T_x)
 		RHS += T_x->get_pedf_max_num_remote_jobs(interval_length) * T_x->get_num_requests(q);
 
 		add_inequality(exp, RHS);
@@ -284,7 +352,7 @@ void PEDFBlockingAnalysisLP_LockFree::add_one_retry_for_at_most_one_remote_commi
 void PEDFBlockingAnalysisLP_LockFree::add_no_arrival_blocking()
 {
 	LinearExpression *exp = new LinearExpression();
-	foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
+	foreach_indexed_task_in_cluster(info, cluster, T_i)
 	{
 		const unsigned int i = T_i->get_id();
 
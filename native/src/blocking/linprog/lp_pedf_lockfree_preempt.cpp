@@ -20,8 +20,9 @@
 
 #include "lp_pedf_lockfree_common.h"
 #include "lp_pedf_analysis.h"
+#include "lp_parallel.h"
 
-#define taskIterator TaskInfos::const_iterator
+#define taskIterator TaskIdRange::const_iterator
 
 class LockFree_Preemptive : public PEDFBlockingAnalysisLP_LockFree
 {
@@ -42,7 +43,7 @@ private:
 	unsigned long get_max_commit_length(const unsigned int k, taskIterator T_i,
 	                                    const unsigned int q, unsigned long t);
 
-	unsigned long get_effective_demand(TaskInfos::const_iterator T_h, taskIterator T_i,
+	unsigned long get_effective_demand(taskIterator T_h, taskIterator T_i,
 	                                   const unsigned int q);
 
 
@@ -78,7 +79,7 @@ public:
 void LockFree_Preemptive::add_no_jobs_no_retry_delay()
 {
 	LinearExpression *exp = new LinearExpression();
-	foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
+	foreach_indexed_task_in_cluster(info, cluster, T_i)
 	{
 		unsigned long njobs = 0;
 
@@ -102,7 +103,7 @@ void LockFree_Preemptive::add_no_jobs_no_retry_delay()
 			var_t Y_R_i_q = vars.remote_conflicts (i,q);
 			exp->add_var(Y_R_i_q);
 
-			foreach_task_in_cluster(info.get_tasks(), cluster, T_j)
+			foreach_indexed_task_in_cluster(info, cluster, T_j)
 			{
 				const unsigned int j = T_j->get_id();
 				var_t Y_L_i_j_q = vars.local_conflicts (i,j,q);
@@ -119,7 +120,7 @@ void LockFree_Preemptive::add_no_jobs_no_retry_delay()
 void LockFree_Preemptive::add_no_requests_no_cause_local_conflict()
 {
 	LinearExpression *exp = new LinearExpression();
-	foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
+	foreach_indexed_task_in_cluster(info, cluster, T_i)
 	{
 		const unsigned int i = T_i->get_id();
 
@@ -127,7 +128,7 @@ void LockFree_Preemptive::add_no_requests_no_cause_local_conflict()
 		{
 			const unsigned int q = *q_iter;
 
-			foreach_task_in_cluster(info.get_tasks(), cluster, T_j)
+			foreach_indexed_task_in_cluster(info, cluster, T_j)
 			{
 				const unsigned int j = T_j->get_id();
 
@@ -148,11 +149,11 @@ void LockFree_Preemptive::add_no_requests_no_cause_local_conflict()
 // "One-to-one mapping" between retries in a task and preempting jobs
 void LockFree_Preemptive::add_at_most_one_retry_per_preempting_job()
 {
-	foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
+	foreach_indexed_task_in_cluster(info, cluster, T_i)
 	{
 		const unsigned int i = T_i->get_id();
 
-		foreach_task_in_cluster(info.get_tasks(), cluster, T_j)
+		foreach_indexed_task_in_cluster(info, cluster, T_j)
 		{
 			const unsigned int j = T_j->get_id();
 
@@ -186,7 +187,7 @@ void LockFree_Preemptive::add_at_most_one_retry_per_preempting_job()
 // Each job can cause at most one retry for each resource
 void LockFree_Preemptive::add_each_job_causes_at_most_one_retry_per_resource()
 {
-	foreach_task_in_cluster(info.get_tasks(), cluster, T_j)
+	foreach_indexed_task_in_cluster(info, cluster, T_j)
 	{
 		const unsigned int j = T_j->get_id();
 
@@ -195,7 +196,7 @@ void LockFree_Preemptive::add_each_job_causes_at_most_one_retry_per_resource()
 			const unsigned int q = *q_iter;
 
 			LinearExpression *exp = new LinearExpression();
-			foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
+			foreach_indexed_task_in_cluster(info, cluster, T_i)
 			{
 				const unsigned int i = T_i->get_id();
 				var_t Y_L_i_j_q = vars.local_conflicts (i,j,q);
@@ -215,7 +216,7 @@ unsigned long LockFree_Preemptive::get_max_commit_length(const unsigned int k, t
 	unsigned long retval = 0;
 
 	// For every task T_x having t < d_x < d_i, compute the max L_{x,k}
-	foreach_task_in_cluster(info.get_tasks(), cluster, T_x)
+	foreach_indexed_task_in_cluster(info, cluster, T_x)
 	{
 		if (t < T_x->get_deadline() && T_x->get_deadline() < T_i->get_deadline())
 			retval = (T_x->get_request_length(q) > retval) ? T_x->get_request_length(q) : retval;
@@ -259,7 +260,7 @@ unsigned long LockFree_Preemptive::compute_preemptive_commit_response_time(
 	{
 		W_new = T_i->get_request_length(q);
 
-		foreach_task_in_cluster_having_lt_dline(info.get_tasks(), cluster, T_i->get_deadline(), T_h)
+		foreach_indexed_task_in_cluster_having_lt_dline(info, cluster, T_i->get_deadline(), T_h)
 		{
 			long dline_difference = (long)T_i->get_deadline() - (long)T_h->get_deadline();
 			dline_difference = (dline_difference < 0) ? 0 : dline_difference;
@@ -269,7 +270,7 @@ unsigned long LockFree_Preemptive::compute_preemptive_commit_response_time(
 			W_new += divide_with_ceil(minval,T_h->get_period()) * get_effective_demand(T_h,T_i,q);
 		}
 
-		foreach_task_not_in_cluster(info.get_tasks(), cluster, T_x)
+		foreach_indexed_task_not_in_cluster(info, cluster, T_x)
 		foreach(all_resources,k_iter)
 			W_new += T_x->get_pedf_max_num_remote_jobs(W) * T_x->get_num_requests(*k_iter) *
 			         get_max_commit_length(*k_iter, T_i, q, 0);
@@ -286,7 +287,7 @@ unsigned long LockFree_Preemptive::compute_preemptive_commit_response_time(
 void LockFree_Preemptive::add_rta_based_bound_on_remote_conflicts()
 {
 
-	foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
+	foreach_indexed_task_in_cluster(info, cluster, T_i)
 	{
 		const unsigned int i = T_i->get_id();
 
@@ -312,7 +313,7 @@ void LockFree_Preemptive::add_rta_based_bound_on_remote_conflicts()
 				njobs = T_i->get_pedf_AC_max_num_local_jobs(interval_length);
 
 			unsigned long RHS = 0;
-			foreach_task_not_in_cluster(info.get_tasks(), cluster, T_x)
+			foreach_indexed_task_not_in_cluster(info, cluster, T_x)
 			{
 				RHS += T_x->get_pedf_max_num_remote_jobs(W) * T_x->get_num_requests(q) *
 				       njobs * T_i->get_num_requests(q);
@@ -336,10 +337,18 @@ class PEDFBlockingAnalysisLockFree_Preemptive : public PEDFBlockingAnalysis
 private:
 	unsigned long compute_blocking_PDC(unsigned long interval_length);
 	unsigned long compute_blocking_AC (unsigned long interval_length);
+	bool closed_form_blocking_PDC(unsigned long interval_length,
+	                              unsigned long& blk_UB);
+	bool closed_form_blocking_rate_PDC(double& rate, double& offset);
 	unsigned long compute_tighter_blocking_PDC(unsigned long interval_length,
 	        unsigned long blk_UB,
 	        unsigned long blk_LB = 0);
 
+	void reset_blocking_state()
+	{
+		ac_blocking_LB = 0;
+	}
+
 	unsigned long ac_blocking_LB;
 
 public:
@@ -355,7 +364,7 @@ unsigned long PEDFBlockingAnalysisLockFree_Preemptive::compute_blocking_PDC(unsi
 {
 	LockFree_Preemptive mip(info, PDC_MODE, interval_length, cluster, 0);
 
-	return mip.solve(false);
+	return mip.solve(false, pdc_session);
 }
 
 // No integer relaxation
@@ -372,14 +381,14 @@ unsigned long PEDFBlockingAnalysisLockFree_Preemptive::compute_tighter_blocking_
 
 	LockFree_Preemptive mip(info, PDC_MODE, interval_length, cluster, pdc_blocking_LB, blk_UB, false);
 
-	return mip.solve(false);
+	return mip.solve(false, tight_pdc_session);
 }
 
 unsigned long PEDFBlockingAnalysisLockFree_Preemptive::compute_blocking_AC (unsigned long interval_length)
 {
 	LockFree_Preemptive mip(info, AC_MODE, interval_length, cluster, ac_blocking_LB, 0, false);
 
-	ac_blocking_LB = mip.solve(false);
+	ac_blocking_LB = mip.solve(false, ac_session);
 
 #ifdef __DEBUG_PEDF_BLK_ANALYSIS__
 	std::cout << "[LF-P] BLK-AC = " << ac_blocking_LB << std::endl;
@@ -388,13 +397,61 @@ unsigned long PEDFBlockingAnalysisLockFree_Preemptive::compute_blocking_AC (unsi
 	return ac_blocking_LB;
 }
 
+// Remote commits plus, for each resource, at most one retry per local job
+bool PEDFBlockingAnalysisLockFree_Preemptive::closed_form_blocking_PDC(unsigned long interval_length,
+        unsigned long& blk_UB)
+{
+	blk_UB = PEDFBlockingAnalysisLP_LockFree::closed_form_remote_bound(info, cluster, interval_length);
+
+	unsigned long local_jobs = 0;
+	foreach_indexed_task_in_cluster(info, cluster, T_j)
+		local_jobs += divide_with_ceil(interval_length, T_j->get_period());
+
+	const std::set<unsigned int> resources = get_all_resources(info);
+	foreach(resources, q)
+		blk_UB += local_jobs *
+		          PEDFBlockingAnalysisLP_LockFree::max_local_commit_length(info, cluster, *q);
+
+	return true;
+}
+
+// ceil(t / T_j) <= t / T_j + 1
+bool PEDFBlockingAnalysisLockFree_Preemptive::closed_form_blocking_rate_PDC(double& rate, double& offset)
+{
+	PEDFBlockingAnalysisLP_LockFree::closed_form_remote_bound_rate(info, cluster, rate, offset);
+
+	double local_rate = 0, local_jobs = 0;
+	foreach_indexed_task_in_cluster(info, cluster, T_j)
+	{
+		local_rate += 1.0 / T_j->get_period();
+		local_jobs += 1;
+	}
+
+	const std::set<unsigned int> resources = get_all_resources(info);
+	foreach(resources, q)
+	{
+		const double length =
+			PEDFBlockingAnalysisLP_LockFree::max_local_commit_length(info, cluster, *q);
+		rate   += local_rate * length;
+		offset += local_jobs * length;
+	}
+
+	return true;
+}
+
 // ------------------------------------------------------------------
 // --------------------[ E N T R Y    P O I N T ]--------------------
 // ------------------------------------------------------------------
 
-bool lp_pedf_lockfree_preempt_is_schedulable(const ResourceSharingInfo& info)
+bool lp_pedf_lockfree_preempt_is_schedulable(const ResourceSharingInfo& info,
+                                             AnalysisBudget* budget)
 {
-	foreach_cluster(info, k)
+	LinearProgramOriginScope origin(__func__);
+
+	const unsigned int num_clusters = info.get_cluster_index().get_num_clusters();
+
+	return forall_clusters_parallel(num_clusters,
+		[&](unsigned int k, const std::atomic<bool>& cancelled)
 	{
 #ifdef __DEBUG_PEDF_BLK_ANALYSIS__
 		std::cout << "[LF-P] CPU#" << k << std::endl;
@@ -402,9 +459,26 @@ bool lp_pedf_lockfree_preempt_is_schedulable(const ResourceSharingInfo& info)
 
 		// Perform schedulability analysis for each processor k
 		PEDFBlockingAnalysisLockFree_Preemptive analysis(info, k);
-		if (!analysis.is_schedulable())
-			return false;
-	}
+		analysis.set_cancellation_flag(&cancelled);
+		analysis.set_budget(budget);
+		return analysis.is_schedulable();
+	});
+}
 
-	return true;
-}
\ No newline at end of file
+PEDFBlockingAnalysis* make_pedf_lockfree_preempt_analysis(const ResourceSharingInfo& info,
+                                                          unsigned int cluster)
+{
+	return new PEDFBlockingAnalysisLockFree_Preemptive(info, cluster);
+}
+
+PEDFSensitivity* lp_pedf_lockfree_preempt_sensitivity(const ResourceSharingInfo& info,
+                                                      pedf_sensitivity_param_t param,
+                                                      double max_factor,
+                                                      double precision,
+                                                      AnalysisBudget* budget)
+{
+	LinearProgramOriginScope origin(__func__);
+
+	return lp_pedf_sensitivity(info, make_pedf_lockfree_preempt_analysis, param,
+	                           max_factor, precision, budget);
+}
@@ -20,6 +20,7 @@
 
 #include "lp_pedf_spinlocks_common.h"
 #include "lp_pedf_analysis.h"
+#include "lp_parallel.h"
 
 
 class MSRP_LP : public PEDFBlockingAnalysisLP_Spinlocks
@@ -65,7 +66,7 @@ void MSRP_LP::add_at_max_one_request_per_processor_spin()
 			unsigned long RHS = 0;
 
 			// For each task T_x in processor k
-			foreach_task_in_cluster(info.get_tasks(), k, T_x)
+			foreach_indexed_task_in_cluster(info, k, T_x)
 			{
 				const unsigned int x = T_x->get_id();
 				var_t X_SPIN    = vars.spin(x, q);
@@ -73,7 +74,7 @@ void MSRP_LP::add_at_max_one_request_per_processor_spin()
 			}
 
 			// For each task T_i in the processor under observation
-			foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
+			foreach_indexed_task_in_cluster(info, cluster, T_i)
 			{
 				unsigned long njobs = 0;
 
@@ -93,7 +94,7 @@ void MSRP_LP::add_at_max_one_request_per_processor_spin()
 // Constraint 16: Per-task bound on spin delay
 void MSRP_LP::add_per_task_bound_spin_delay()
 {
-	foreach_task_not_in_cluster(info.get_tasks(), cluster, T_x)
+	foreach_indexed_task_not_in_cluster(info, cluster, T_x)
 	{
 		foreach(all_resources,q_iter)
 		{
@@ -103,7 +104,7 @@ void MSRP_LP::add_per_task_bound_spin_delay()
 			const unsigned int x = T_x->get_id();
 			var_t X_SPIN = vars.spin(x, q);
 
-			foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
+			foreach_indexed_task_in_cluster(info, cluster, T_i)
 			{
 				const unsigned long nrjobs_T_i = T_i->get_pedf_max_num_remote_jobs(T_x->get_deadline());
 				const unsigned long nrjobs_T_x = T_x->get_pedf_max_num_remote_jobs(interval_length);
@@ -132,7 +133,7 @@ void MSRP_LP::add_at_max_one_request_per_processor_arrival()
 			var_t A_q = vars.indicator_arrival(q);
 
 			// For each task T_x in processor k
-			foreach_task_in_cluster(info.get_tasks(), k, T_x)
+			foreach_indexed_task_in_cluster(info, k, T_x)
 			{
 				const unsigned int x = T_x->get_id();
 
@@ -156,6 +157,9 @@ class PEDFBlockingAnalysisMSRP : public PEDFBlockingAnalysis
 private:
 	unsigned long compute_blocking_PDC(unsigned long interval_length);
 	unsigned long compute_blocking_AC (unsigned long interval_length);
+	bool closed_form_blocking_PDC(unsigned long interval_length,
+	                              unsigned long& blk_UB);
+	bool closed_form_blocking_rate_PDC(double& rate, double& offset);
 
 public:
 	PEDFBlockingAnalysisMSRP(const ResourceSharingInfo& info,
@@ -168,22 +172,41 @@ unsigned long PEDFBlockingAnalysisMSRP::compute_blocking_PDC(unsigned long inter
 {
 	MSRP_LP mip(info, PDC_MODE, interval_length, cluster);
 
-	return mip.solve(false);
+	return mip.solve(false, pdc_session);
 }
 unsigned long PEDFBlockingAnalysisMSRP::compute_blocking_AC (unsigned long interval_length)
 {
 	MSRP_LP mip(info, AC_MODE, interval_length, cluster);
 
-	return mip.solve(false);
+	return mip.solve(false, ac_session);
+}
+
+bool PEDFBlockingAnalysisMSRP::closed_form_blocking_PDC(unsigned long interval_length,
+        unsigned long& blk_UB)
+{
+	blk_UB = PEDFBlockingAnalysisLP_Spinlocks::closed_form_bound_PDC(info, cluster, interval_length);
+	return true;
+}
+
+bool PEDFBlockingAnalysisMSRP::closed_form_blocking_rate_PDC(double& rate, double& offset)
+{
+	PEDFBlockingAnalysisLP_Spinlocks::closed_form_bound_rate_PDC(info, cluster, rate, offset);
+	return true;
 }
 
 // ------------------------------------------------------------------
 // --------------------[ E N T R Y    P O I N T ]--------------------
 // ------------------------------------------------------------------
 
-bool lp_pedf_msrp_is_schedulable(const ResourceSharingInfo& info)
+bool lp_pedf_msrp_is_schedulable(const ResourceSharingInfo& info,
+                                 AnalysisBudget* budget)
 {
-	foreach_cluster(info, k)
+	LinearProgramOriginScope origin(__func__);
+
+	const unsigned int num_clusters = info.get_cluster_index().get_num_clusters();
+
+	return forall_clusters_parallel(num_clusters,
+		[&](unsigned int k, const std::atomic<bool>& cancelled)
 	{
 #ifdef __DEBUG_PEDF_BLK_ANALYSIS__
 		std::cout << "[MSRP] CPU#" << k << std::endl;
@@ -191,9 +214,26 @@ bool lp_pedf_msrp_is_schedulable(const ResourceSharingInfo& info)
 
 		// Perform schedulability analysis for each processor k
 		PEDFBlockingAnalysisMSRP analysis(info, k);
-		if (!analysis.is_schedulable())
-			return false;
-	}
+		analysis.set_cancellation_flag(&cancelled);
+		analysis.set_budget(budget);
+		return analysis.is_schedulable();
+	});
+}
 
-	return true;
-}
\ No newline at end of file
+PEDFBlockingAnalysis* make_pedf_msrp_analysis(const ResourceSharingInfo& info,
+                                              unsigned int cluster)
+{
+	return new PEDFBlockingAnalysisMSRP(info, cluster);
+}
+
+PEDFSensitivity* lp_pedf_msrp_sensitivity(const ResourceSharingInfo& info,
+                                          pedf_sensitivity_param_t param,
+                                          double max_factor,
+                                          double precision,
+                                          AnalysisBudget* budget)
+{
+	LinearProgramOriginScope origin(__func__);
+
+	return lp_pedf_sensitivity(info, make_pedf_msrp_analysis, param,
+	                           max_factor, precision, budget);
+}
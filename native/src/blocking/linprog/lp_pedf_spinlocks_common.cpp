@@ -68,6 +68,9 @@ PEDFBlockingAnalysisLP_Spinlocks::PEDFBlockingAnalysisLP_Spinlocks(
 	  cluster(_cluster),
 	  all_resources(get_all_resources(_info))
 {
+	vars.reserve(taskset.size(),
+	             all_resources.empty() ? 0 : *all_resources.rbegin() + 1);
+
 	// Add generic constraints
 	add_no_arrival_blocking_dline_inside_interval();
 	add_no_spin_delay_local_requests();
@@ -84,8 +87,13 @@ PEDFBlockingAnalysisLP_Spinlocks::PEDFBlockingAnalysisLP_Spinlocks(
 
 	set_objective();
 }
-unsigned long PEDFBlockingAnalysisLP_Spinlocks::solve(bool verbose)
+unsigned long PEDFBlockingAnalysisLP_Spinlocks::solve(bool verbose, LinearProgramSession *session)
 {
+	// tag captured LPs with the analyzed interval
+	LinearProgramOrigin here = linprog_get_origin();
+	here.interval = interval_length;
+	LinearProgramOriginScope origin(here);
+
 	Solution *sol;
 	double result;
 
@@ -102,7 +110,10 @@ unsigned long PEDFBlockingAnalysisLP_Spinlocks::solve(bool verbose)
 		std::cout << "LP for t=" << interval_length << ":" << std::endl;
 		pretty_print_linear_program(std::cout, *this, var_map) << std::endl;
 
-		sol = linprog_solve(*this, vars.get_num_vars());
+		if (session)
+			sol = session->solve(*this, vars.get_num_vars());
+		else
+			sol = linprog_solve(*this, vars.get_num_vars());
 		result = floor(sol->evaluate(*get_objective()));
 
 		std::cout << "Solution: " << result << std::endl;
@@ -116,7 +127,10 @@ unsigned long PEDFBlockingAnalysisLP_Spinlocks::solve(bool verbose)
 	}
 	else
 	{
-		sol = linprog_solve(*this, vars.get_num_vars());
+		if (session)
+			sol = session->solve(*this, vars.get_num_vars());
+		else
+			sol = linprog_solve(*this, vars.get_num_vars());
 
 		result = floor(sol->evaluate(*get_objective()));
 	}
@@ -126,6 +140,61 @@ unsigned long PEDFBlockingAnalysisLP_Spinlocks::solve(bool verbose)
 	return (unsigned long) result;
 }
 
+unsigned long PEDFBlockingAnalysisLP_Spinlocks::closed_form_bound_PDC(
+    const ResourceSharingInfo& info,
+    unsigned int cluster,
+    unsigned long interval_length)
+{
+	unsigned long bound = 0;
+
+	foreach_indexed_task_not_in_cluster(info, cluster, T_x)
+	{
+		const unsigned long nrjobs = T_x->get_pedf_max_num_remote_jobs(interval_length);
+
+		foreach(T_x->get_requests(), request)
+			bound += nrjobs * request->get_num_requests() * request->get_request_length();
+	}
+
+	unsigned long max_arrival = 0;
+	foreach_indexed_task_in_cluster_having_gt_dline(info, cluster, interval_length, T_i)
+	{
+		const unsigned long length = T_i->get_max_request_length();
+		if (length > max_arrival)
+			max_arrival = length;
+	}
+
+	return bound + max_arrival;
+}
+
+// nrjobs(T_x, t) = ceil((t + D_x) / T_x) <= t / T_x + D_x / T_x + 1
+void PEDFBlockingAnalysisLP_Spinlocks::closed_form_bound_rate_PDC(
+    const ResourceSharingInfo& info,
+    unsigned int cluster,
+    double& rate, double& offset)
+{
+	rate = offset = 0;
+
+	foreach_indexed_task_not_in_cluster(info, cluster, T_x)
+	{
+		const double period = T_x->get_period();
+
+		foreach(T_x->get_requests(), request)
+		{
+			const double demand = (double) request->get_num_requests() *
+			                      request->get_request_length();
+			rate   += demand / period;
+			offset += demand * (T_x->get_deadline() / period + 1);
+		}
+	}
+
+	unsigned long max_arrival = 0;
+	foreach_indexed_task_in_cluster(info, cluster, T_i)
+		if (T_i->get_max_request_length() > max_arrival)
+			max_arrival = T_i->get_max_request_length();
+
+	offset += max_arrival;
+}
+
 // ------------------------------------------------------------------
 // ----------------------[ O B J E C T I V E ]-----------------------
 // ------------------------------------------------------------------
@@ -165,7 +234,7 @@ void PEDFBlockingAnalysisLP_Spinlocks::set_objective()
 // Constraint 8: No arrival blocking from tasks with d_i <= t
 void PEDFBlockingAnalysisLP_Spinlocks::add_no_arrival_blocking_dline_inside_interval()
 {
-	foreach_task_in_cluster_having_leq_dline(taskset, cluster, interval_length, T_i)
+	foreach_indexed_task_in_cluster_having_leq_dline(info, cluster, interval_length, T_i)
 	{
 		const unsigned int i = T_i->get_id();
 
@@ -187,7 +256,7 @@ void PEDFBlockingAnalysisLP_Spinlocks::add_no_spin_delay_local_requests()
 {
 	LinearExpression *exp = new LinearExpression();
 
-	foreach_task_in_cluster(taskset, cluster, T_i)
+	foreach_indexed_task_in_cluster(info, cluster, T_i)
 	{
 		const unsigned int i = T_i->get_id();
 
@@ -206,7 +275,7 @@ void PEDFBlockingAnalysisLP_Spinlocks::add_no_spin_delay_local_requests()
 // Constraint 10: Joint upper-bound for remote requests
 void PEDFBlockingAnalysisLP_Spinlocks::add_joint_upper_bound_remote_requests()
 {
-	foreach_task_not_in_cluster(taskset, cluster, T_i)
+	foreach_indexed_task_not_in_cluster(info, cluster, T_i)
 	{
 		const unsigned int i = T_i->get_id();
 		unsigned int nrjobs = T_i->get_pedf_max_num_remote_jobs(interval_length);
@@ -271,7 +340,7 @@ void PEDFBlockingAnalysisLP_Spinlocks::add_exclude_non_conflicting_local_resourc
 
 	// Compute the maximum preemption level for tasks having dline <= t
 	unsigned int max_preemption_level = 0;
-	foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
+	foreach_indexed_task_in_cluster(info, cluster, T_i)
 	{
 		if (T_i->get_deadline() <= interval_length)
 			if (T_i->get_priority() > max_preemption_level)
@@ -306,7 +375,7 @@ void PEDFBlockingAnalysisLP_Spinlocks::add_no_requests_no_arrival_blocking()
 		const unsigned int q = *q_iter;
 		unsigned int n_reqs = 0;
 
-		foreach_task_in_cluster_having_gt_dline(info.get_tasks(), cluster, interval_length, T_i)
+		foreach_indexed_task_in_cluster_having_gt_dline(info, cluster, interval_length, T_i)
 		n_reqs += T_i->get_num_requests(q);
 
 		var_t A_q = vars.indicator_arrival(q);
@@ -329,7 +398,7 @@ void PEDFBlockingAnalysisLP_Spinlocks::add_arrival_blocking_max_one_local_reques
 		LinearExpression *exp = new LinearExpression();
 		var_t A_q = vars.indicator_arrival(q);
 
-		foreach_task_in_cluster(info.get_tasks(), cluster, T_i)
+		foreach_indexed_task_in_cluster(info, cluster, T_i)
 		{
 			const unsigned int i = T_i->get_id();
 
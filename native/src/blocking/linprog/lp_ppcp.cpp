@@ -19,6 +19,7 @@
 #include "linprog/io.h"
 
 #include "lp_global.h"
+#include "lp_parallel.h"
 
 
 class GlobalPPCPAnalysis : public GlobalPrioInheritanceLP, public GlobalPriorityQueuesLP
@@ -431,13 +432,15 @@ BlockingBounds* lp_ppcp_bounds(
 	unsigned int number_of_cpus,
 	bool reasonable_priority_assignment)
 {
+	LinearProgramOriginScope origin(__func__);
+
 	BlockingBounds* results = new BlockingBounds(info);
 
-	for (unsigned int i = 0; i < info.get_tasks().size(); i++)
+	foreach_task_parallel(info.get_tasks().size(), [&](unsigned int i)
 	{
 		GlobalPPCPAnalysis lp(info, i, number_of_cpus, reasonable_priority_assignment);
 		(*results)[i] = lp.solve();
-	}
+	});
 
 	return results;
 }
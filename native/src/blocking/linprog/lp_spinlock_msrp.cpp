@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <climits>
 #include "cpu_time.h"
+#include "lp_parallel.h"
 
 // Constraint 21: Limit the number of preemptions that Ti can incur to
 // the number of releases of local higher-priority jobs while Ti's job
@@ -163,19 +164,18 @@ static void add_msrp_constraints(
 	 add_msrp_atmostonce_remote_arrival_constraints(vars, info, ti, lp);
 }
 
-unsigned long apply_msrp_bounds_for_task(
-	unsigned int i,
-	BlockingBounds& bounds,
+static unsigned int build_msrp_lp(
+	LinearProgram& lp,
 	const ResourceSharingInfo& info,
+	const TaskInfo& ti,
 	bool preemptive)
 {
 #if DEBUG_LP_OVERHEADS >= 1
 	static DEFINE_CPU_CLOCK(build_model);
 	build_model.start();
 #endif
-	LinearProgram lp;
 	VarMapperSpinlocks vars;
-	const TaskInfo& ti = info.get_tasks()[i];
+	vars.reserve(info);
 
 	if (preemptive)
 		add_preemptive_fifo_constraints(vars, info, ti, lp);
@@ -187,31 +187,8 @@ unsigned long apply_msrp_bounds_for_task(
 #if DEBUG_LP_OVERHEADS >= 1
 	build_model.stop();
 	std::cout << build_model << std::endl;
-	static DEFINE_CPU_CLOCK(solve_model);
-	solve_model.start();
-#endif
-	Solution *sol = linprog_solve(lp, vars.get_num_vars());
-#if DEBUG_LP_OVERHEADS >= 1
-	solve_model.stop();
-	std::cout << solve_model << std::endl;
-	static DEFINE_CPU_CLOCK(parse_result);
-	parse_result.start();
 #endif
-
-	assert(sol != NULL);
-	Interference total;
-	total.total_length = lrint(sol->evaluate(*lp.get_objective()));
-	bounds[i] = total;
-
-
-#if DEBUG_LP_OVERHEADS >= 1
-	parse_result.stop();
-	std::cout << parse_result << std::endl;
-#endif
-
-	delete sol;
-	return total.total_length;
-
+	return vars.get_num_vars();
 }
 
 unsigned long lp_preemptive_fifo_bounds_single(
@@ -221,21 +198,23 @@ unsigned long lp_preemptive_fifo_bounds_single(
 	BlockingBounds* results = new BlockingBounds(info);
 	PriorityCeilings prio_ceilings = get_priority_ceilings(info);
 
-	apply_msrp_bounds_for_task(task_index, *results, info, true);
+	apply_spinlock_bounds_for_task(task_index, *results, info,
+				       build_msrp_lp, true);
 	unsigned long blocking_term = results->get_blocking_term(task_index);
 
 	delete results;
 	return blocking_term;
 }
 
-BlockingBounds* lp_pfp_preemptive_fifo_spinlock_bounds(const ResourceSharingInfo& info)
+BlockingBounds* lp_pfp_preemptive_fifo_spinlock_bounds(
+	const ResourceSharingInfo& info,
+	const BlockingThresholds* thresholds)
 {
+	LinearProgramOriginScope origin(__func__);
+
 	BlockingBounds* results = new BlockingBounds(info);
 
-	for (unsigned int i=0; i<info.get_tasks().size(); i++)
-	{
-		apply_msrp_bounds_for_task(i, *results, info, true);
-	}
+	apply_spinlock_bounds(*results, info, build_msrp_lp, true, thresholds);
 	return results;
 }
 
@@ -246,15 +225,20 @@ unsigned long lp_msrp_bounds_single(
 	BlockingBounds* results = new BlockingBounds(info);
 	PriorityCeilings prio_ceilings = get_priority_ceilings(info);
 
-	apply_msrp_bounds_for_task(task_index, *results, info, false);
+	apply_spinlock_bounds_for_task(task_index, *results, info,
+				       build_msrp_lp, false);
 	unsigned long blocking_term = results->get_blocking_term(task_index);
 
 	delete results;
 	return blocking_term;
 }
 
-BlockingBounds* lp_pfp_msrp_bounds(const ResourceSharingInfo& info)
+BlockingBounds* lp_pfp_msrp_bounds(
+	const ResourceSharingInfo& info,
+	const BlockingThresholds* thresholds)
 {
+	LinearProgramOriginScope origin(__func__);
+
 #if DEBUG_LP_OVERHEADS >= 1
 	static DEFINE_CPU_CLOCK(solve_full_ts);
 	solve_full_ts.start();
@@ -263,10 +247,7 @@ BlockingBounds* lp_pfp_msrp_bounds(const ResourceSharingInfo& info)
 	BlockingBounds* results = new BlockingBounds(info);
 	PriorityCeilings prio_ceilings = get_priority_ceilings(info);
 
-	for (unsigned int i=0; i<info.get_tasks().size(); i++)
-	{
-		apply_msrp_bounds_for_task(i, *results, info, false);
-	}
+	apply_spinlock_bounds(*results, info, build_msrp_lp, false, thresholds);
 
 #if DEBUG_LP_OVERHEADS >= 1
 	solve_full_ts.stop();
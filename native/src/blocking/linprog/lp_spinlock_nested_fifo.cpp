@@ -17,11 +17,13 @@
 #include "stl-io-helper.h"
 
 #include "nested_cs.h"
+#include "lp_analysis.h"
 
 #include <iostream>
 #include <sstream>
 #include "res_io.h"
 #include "linprog/io.h"
+#include "lp_parallel.h"
 
 void dump(const CriticalSectionsOfTaskset &x)
 {
@@ -293,7 +295,7 @@ public:
 		const CriticalSectionsOfTaskset& tsk_cs,
 		const int task_under_analysis);
 
-	unsigned long solve();
+	unsigned long solve(const BlockingThresholds* thresholds = NULL);
 };
 
 NestedFifoILP::NestedFifoILP(
@@ -326,7 +328,7 @@ NestedFifoILP::NestedFifoILP(
 	assert(vars.get_num_vars() == get_binary_variables().size());
 }
 
-unsigned long NestedFifoILP::solve()
+unsigned long NestedFifoILP::solve(const BlockingThresholds* thresholds)
 {
 	Solution *sol;
 	double result;
@@ -335,7 +337,12 @@ unsigned long NestedFifoILP::solve()
 
 	var_map = vars.get_translation_table();
 
-	sol = linprog_solve(*this, vars.get_num_vars());
+	// the result is rounded up below, which keeps a relaxed bound safe
+	if (thresholds && thresholds->has_threshold(i))
+		sol = linprog_solve_relaxed_first(*this, vars.get_num_vars(),
+						  thresholds->get_threshold(i));
+	else
+		sol = linprog_solve(*this, vars.get_num_vars());
 
 	result = ceil(sol->evaluate(*get_objective()));
 
@@ -829,15 +836,18 @@ void NestedFifoILP::add_local_resource_constraints()
 
 BlockingBounds* lp_nested_fifo_spinlock_bounds(
 	const ResourceSharingInfo& info,
-	const CriticalSectionsOfTaskset& tsk_cs)
+	const CriticalSectionsOfTaskset& tsk_cs,
+	const BlockingThresholds* thresholds)
 {
+	LinearProgramOriginScope origin(__func__);
+
 	BlockingBounds* results = new BlockingBounds(info);
 
-	for (unsigned int i=0; i<info.get_tasks().size(); i++)
+	foreach_task_parallel(info.get_tasks().size(), [&](unsigned int i)
 	{
 		NestedFifoILP ilp(info, tsk_cs, i);
-		(*results)[i] = ilp.solve();
-	}
+		(*results)[i] = ilp.solve(thresholds);
+	});
 
 	return results;
 }
@@ -1,5 +1,6 @@
 #include "lp_common.h"
 #include "math-helper.h"
+#include "lp_parallel.h"
 #include <set>
 #include <map>
 #include <cmath>
@@ -448,40 +449,35 @@ bool add_prio_constraints(
 }
 
 
-bool apply_prio_bounds_for_task(
-	unsigned int i,
-	BlockingBounds& bounds,
+static unsigned int build_prio_lp(
+	LinearProgram& lp,
 	const ResourceSharingInfo& info,
+	const TaskInfo& ti,
 	bool preemptive)
 {
-	LinearProgram lp;
 	VarMapperSpinlocks vars;
-	const TaskInfo& ti = info.get_tasks()[i];
+	vars.reserve(info);
 
 	add_prio_constraints(vars, info, ti, lp, preemptive);
 
 	set_spinlock_blocking_objective(vars, info, ti, lp);
 	vars.seal();
-	Solution *sol = linprog_solve(lp, vars.get_num_vars());
 
-	assert(sol != NULL);
-	Interference total;
-	total.total_length = lrint(sol->evaluate(*lp.get_objective()));
-	bounds[i] = total;
-
-	delete sol;
-	return true;
+	return vars.get_num_vars();
 }
 
-BlockingBounds* lp_pfp_prio_spinlock_bounds(const ResourceSharingInfo& info, bool preemptive)
+BlockingBounds* lp_pfp_prio_spinlock_bounds(
+	const ResourceSharingInfo& info,
+	bool preemptive,
+	const BlockingThresholds* thresholds)
 {
+	LinearProgramOriginScope origin(__func__);
+
 	BlockingBounds* results = new BlockingBounds(info);
 	PriorityCeilings prio_ceilings = get_priority_ceilings(info);
 
-	for (unsigned int i=0; i<info.get_tasks().size(); i++)
-	{
-		apply_prio_bounds_for_task(i, *results, info, preemptive);
-	}
+	apply_spinlock_bounds(*results, info, build_prio_lp, preemptive,
+			      thresholds);
 
 	return results;
 }
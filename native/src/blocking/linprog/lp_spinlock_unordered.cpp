@@ -1,5 +1,6 @@
 #include "lp_common.h"
 #include "cpu_time.h"
+#include "lp_parallel.h"
 #include <set>
 #include <map>
 #include <cmath>
@@ -164,51 +165,45 @@ void add_unordered_constraints(
 	add_unordered_direct_blocking_constraints(vars, info, ti, lp, preemptive);
 }
 
-bool apply_unordered_bounds_for_task(
-	unsigned int i,
-	BlockingBounds& bounds,
+static unsigned int build_unordered_lp(
+	LinearProgram& lp,
 	const ResourceSharingInfo& info,
+	const TaskInfo& ti,
 	bool preemptive)
 {
 #if DEBUG_LP_OVERHEADS >= 1
-	static DEFINE_CPU_CLOCK(unordered_bounds);
-	unordered_bounds.start();
+	static DEFINE_CPU_CLOCK(unordered_model);
+	unordered_model.start();
 #endif
 
-	LinearProgram lp;
 	VarMapperSpinlocks vars;
-	const TaskInfo& ti = info.get_tasks()[i];
+	vars.reserve(info);
 
 	add_unordered_constraints(vars, info, ti, lp, preemptive);
 	set_spinlock_blocking_objective(vars, info, ti, lp);
 	vars.seal();
-	Solution *sol = linprog_solve(lp, vars.get_num_vars());
-
-	assert(sol != NULL);
-	Interference total;
-	total.total_length = lrint(sol->evaluate(*lp.get_objective()));
-	bounds[i] = total;
 
-	delete sol;
 #if DEBUG_LP_OVERHEADS >= 1
-	unordered_bounds.stop();
-	std::cout << unordered_bounds << std::endl;
+	unordered_model.stop();
+	std::cout << unordered_model << std::endl;
 #endif
 
-	return true;
+	return vars.get_num_vars();
 }
 
-
-BlockingBounds* lp_pfp_unordered_spinlock_bounds(const ResourceSharingInfo& info, bool preemptive)
+BlockingBounds* lp_pfp_unordered_spinlock_bounds(
+	const ResourceSharingInfo& info,
+	bool preemptive,
+	const BlockingThresholds* thresholds)
 {
+	LinearProgramOriginScope origin(__func__);
+
 	BlockingBounds* results = new BlockingBounds(info);
 
 	PriorityCeilings prio_ceilings = get_priority_ceilings(info);
 
-	for (unsigned int i=0; i<info.get_tasks().size(); i++)
-	{
-		apply_unordered_bounds_for_task(i, *results, info, preemptive);
-	}
+	apply_spinlock_bounds(*results, info, build_unordered_lp, preemptive,
+			      thresholds);
 
 	return results;
 }
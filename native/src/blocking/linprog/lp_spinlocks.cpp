@@ -1,5 +1,7 @@
 #include "lp_common.h"
+#include "lp_analysis.h"
 #include "math-helper.h"
+#include "lp_parallel.h"
 #include <set>
 #include <map>
 #include <cmath>
@@ -618,29 +620,76 @@ void add_common_preemptive_spinlock_constraints(
 	add_common_preemptive_no_remote_arrival_blocking_constraints(vars, info, ti, lp);
 }
 
-unsigned long apply_baseline_bounds_for_task(
-	unsigned int i,
-	BlockingBounds& bounds,
+static unsigned int build_baseline_lp(
+	LinearProgram& lp,
 	const ResourceSharingInfo& info,
+	const TaskInfo& ti,
 	bool preemptive)
 {
-	LinearProgram lp;
 	VarMapperSpinlocks vars;
-	const TaskInfo& ti = info.get_tasks()[i];
+	vars.reserve(info);
 
 	add_common_spinlock_constraints(vars, info, ti, lp);
 
 	set_spinlock_blocking_objective(vars, info, ti, lp);
 	vars.seal();
 
-	Solution *sol = linprog_solve(lp, vars.get_num_vars());
+	return vars.get_num_vars();
+}
 
-	assert(sol != NULL);
+static bool extract_spinlock_bounds(
+	unsigned int i,
+	BlockingBounds& bounds,
+	const LinearProgram& lp,
+	const Solution& sol,
+	bool exact = true)
+{
 	Interference total;
-	total.total_length = lrint(sol->evaluate(*lp.get_objective()));
+	const double objective = sol.evaluate(*lp.get_objective());
+	// the optimum of a relaxation is fractional in general
+	total.total_length = exact ? lrint(objective) : ceil(objective);
 	bounds[i] = total;
-	delete sol;
-	return total.total_length;
+	return false;
+}
+
+void apply_spinlock_bounds(
+	BlockingBounds& bounds,
+	const ResourceSharingInfo& info,
+	spinlock_lp_builder_t build_lp,
+	bool preemptive,
+	const BlockingThresholds* thresholds)
+{
+	solve_task_lps(info.get_tasks().size(),
+		[&](unsigned int i, LinearProgram& lp)
+		{
+			return build_lp(lp, info, info.get_tasks()[i], preemptive);
+		},
+		[&](unsigned int i, LinearProgram& lp, const Solution& sol,
+		    bool exact)
+		{
+			return extract_spinlock_bounds(i, bounds, lp, sol, exact);
+		},
+		thresholds);
+}
+
+unsigned long apply_spinlock_bounds_for_task(
+	unsigned int i,
+	BlockingBounds& bounds,
+	const ResourceSharingInfo& info,
+	spinlock_lp_builder_t build_lp,
+	bool preemptive)
+{
+	LinearProgram lp;
+	unsigned int num_vars = build_lp(lp, info, info.get_tasks()[i], preemptive);
+
+	auto extract = [&](unsigned int t, LinearProgram& task_lp,
+	                   const Solution& sol, bool exact)
+	{
+		return extract_spinlock_bounds(t, bounds, task_lp, sol, exact);
+	};
+	solve_task_lp(i, lp, num_vars, extract, NULL);
+
+	return bounds[i].total_length;
 }
 
 unsigned long lp_baseline_bounds_single(
@@ -649,21 +698,24 @@ unsigned long lp_baseline_bounds_single(
 {
 	BlockingBounds* results = new BlockingBounds(info);
 
-	apply_baseline_bounds_for_task(task_index, *results, info, false);
+	apply_spinlock_bounds_for_task(task_index, *results, info,
+				       build_baseline_lp, false);
 	unsigned long blocking_term = results->get_blocking_term(task_index);
 
 	delete results;
 	return blocking_term;
 }
 
-BlockingBounds* lp_pfp_baseline_spinlock_bounds(const ResourceSharingInfo& info)
+BlockingBounds* lp_pfp_baseline_spinlock_bounds(
+	const ResourceSharingInfo& info,
+	const BlockingThresholds* thresholds)
 {
+	LinearProgramOriginScope origin(__func__);
+
 	BlockingBounds* results = new BlockingBounds(info);
 
-	for (unsigned int i=0; i<info.get_tasks().size(); i++)
-	{
-		apply_baseline_bounds_for_task(i, *results, info, false);
-	}
+	apply_spinlock_bounds(*results, info, build_baseline_lp, false,
+			      thresholds);
 
 	return results;
 }
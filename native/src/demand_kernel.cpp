@@ -0,0 +1,403 @@
+#include <stdlib.h>
+#include <math.h>
+
+#include <algorithm>
+#include <new>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "demand_kernel.h"
+
+// all integers up to 2^53 are exactly representable as doubles
+static const double EXACT_LIMIT = 9007199254740992.0;
+static const double MAX_PARAMETER = EXACT_LIMIT / 2;
+
+// deadline of the padding tasks: beyond any time the kernel accepts
+static const double NEVER = EXACT_LIMIT * 128;
+
+/* Thin wrappers around the vector registers of the targeted instruction
+ * set, so that the kernels below are written only once. */
+
+#if defined(__AVX512F__)
+
+struct Lanes
+{
+	enum { WIDTH = 8 };
+
+	__m512d v;
+
+	Lanes(__m512d v) : v(v) {}
+
+	static Lanes load(const double *p) { return _mm512_load_pd(p); }
+	static Lanes all(double x) { return _mm512_set1_pd(x); }
+	void store(double *p) const { _mm512_store_pd(p, v); }
+
+	Lanes operator+(const Lanes &b) const { return _mm512_add_pd(v, b.v); }
+	Lanes operator-(const Lanes &b) const { return _mm512_sub_pd(v, b.v); }
+	Lanes operator*(const Lanes &b) const { return _mm512_mul_pd(v, b.v); }
+	Lanes operator/(const Lanes &b) const { return _mm512_div_pd(v, b.v); }
+
+	// The masked forms avoid _mm512_undefined_pd(), which GCC 12 wrongly
+	// reports as uninitialized.
+	static const __mmask8 ALL = 0xff;
+
+	Lanes floor() const
+	{
+		return _mm512_mask_roundscale_pd(v, ALL, v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+	}
+
+	Lanes ceil() const
+	{
+		return _mm512_mask_roundscale_pd(v, ALL, v, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC);
+	}
+
+	static Lanes min(const Lanes &a, const Lanes &b) { return _mm512_mask_min_pd(a.v, ALL, a.v, b.v); }
+	static Lanes max(const Lanes &a, const Lanes &b) { return _mm512_mask_max_pd(a.v, ALL, a.v, b.v); }
+
+	// a < b ? x : y, per lane
+	static Lanes if_less(const Lanes &a, const Lanes &b,
+	                     const Lanes &x, const Lanes &y)
+	{
+		return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ),
+		                            y.v, x.v);
+	}
+
+	// a == b ? x : y, per lane
+	static Lanes if_equal(const Lanes &a, const Lanes &b,
+	                      const Lanes &x, const Lanes &y)
+	{
+		return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(a.v, b.v, _CMP_EQ_OQ),
+		                            y.v, x.v);
+	}
+
+	double sum() const
+	{
+		__m256d h = _mm256_add_pd(_mm512_maskz_extractf64x4_pd(0xf, v, 0),
+		                          _mm512_maskz_extractf64x4_pd(0xf, v, 1));
+		__m128d s = _mm_add_pd(_mm256_castpd256_pd128(h),
+		                       _mm256_extractf128_pd(h, 1));
+		return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+	}
+
+	double max() const
+	{
+		__m256d h = _mm256_max_pd(_mm512_maskz_extractf64x4_pd(0xf, v, 0),
+		                          _mm512_maskz_extractf64x4_pd(0xf, v, 1));
+		__m128d s = _mm_max_pd(_mm256_castpd256_pd128(h),
+		                       _mm256_extractf128_pd(h, 1));
+		return _mm_cvtsd_f64(_mm_max_sd(s, _mm_unpackhi_pd(s, s)));
+	}
+};
+
+#elif defined(__AVX2__)
+
+struct Lanes
+{
+	enum { WIDTH = 4 };
+
+	__m256d v;
+
+	Lanes(__m256d v) : v(v) {}
+
+	static Lanes load(const double *p) { return _mm256_load_pd(p); }
+	static Lanes all(double x) { return _mm256_set1_pd(x); }
+	void store(double *p) const { _mm256_store_pd(p, v); }
+
+	Lanes operator+(const Lanes &b) const { return _mm256_add_pd(v, b.v); }
+	Lanes operator-(const Lanes &b) const { return _mm256_sub_pd(v, b.v); }
+	Lanes operator*(const Lanes &b) const { return _mm256_mul_pd(v, b.v); }
+	Lanes operator/(const Lanes &b) const { return _mm256_div_pd(v, b.v); }
+
+	Lanes floor() const { return _mm256_floor_pd(v); }
+	Lanes ceil() const { return _mm256_ceil_pd(v); }
+
+	static Lanes min(const Lanes &a, const Lanes &b) { return _mm256_min_pd(a.v, b.v); }
+	static Lanes max(const Lanes &a, const Lanes &b) { return _mm256_max_pd(a.v, b.v); }
+
+	// a < b ? x : y, per lane
+	static Lanes if_less(const Lanes &a, const Lanes &b,
+	                     const Lanes &x, const Lanes &y)
+	{
+		return _mm256_blendv_pd(y.v, x.v, _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ));
+	}
+
+	// a == b ? x : y, per lane
+	static Lanes if_equal(const Lanes &a, const Lanes &b,
+	                      const Lanes &x, const Lanes &y)
+	{
+		return _mm256_blendv_pd(y.v, x.v, _mm256_cmp_pd(a.v, b.v, _CMP_EQ_OQ));
+	}
+
+	double sum() const
+	{
+		__m128d s = _mm_add_pd(_mm256_castpd256_pd128(v),
+		                       _mm256_extractf128_pd(v, 1));
+		return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+	}
+
+	double max() const
+	{
+		__m128d s = _mm_max_pd(_mm256_castpd256_pd128(v),
+		                       _mm256_extractf128_pd(v, 1));
+		return _mm_cvtsd_f64(_mm_max_sd(s, _mm_unpackhi_pd(s, s)));
+	}
+};
+
+#else
+
+struct Lanes
+{
+	enum { WIDTH = 1 };
+
+	double v;
+
+	Lanes(double v) : v(v) {}
+
+	static Lanes load(const double *p) { return *p; }
+	static Lanes all(double x) { return x; }
+	void store(double *p) const { *p = v; }
+
+	Lanes operator+(const Lanes &b) const { return v + b.v; }
+	Lanes operator-(const Lanes &b) const { return v - b.v; }
+	Lanes operator*(const Lanes &b) const { return v * b.v; }
+	Lanes operator/(const Lanes &b) const { return v / b.v; }
+
+	Lanes floor() const { return ::floor(v); }
+	Lanes ceil() const { return ::ceil(v); }
+
+	static Lanes min(const Lanes &a, const Lanes &b) { return a.v < b.v ? a : b; }
+	static Lanes max(const Lanes &a, const Lanes &b) { return a.v < b.v ? b : a; }
+
+	static Lanes if_less(const Lanes &a, const Lanes &b,
+	                     const Lanes &x, const Lanes &y)
+	{
+		return a.v < b.v ? x : y;
+	}
+
+	static Lanes if_equal(const Lanes &a, const Lanes &b,
+	                      const Lanes &x, const Lanes &y)
+	{
+		return a.v == b.v ? x : y;
+	}
+
+	double sum() const { return v; }
+	double max() const { return v; }
+};
+
+#endif
+
+// floor(a / p) for integral a and p > 0 with |a| + p <= 2^53: the rounded
+// quotient is off by at most one, which the exact products reveal
+static inline Lanes floor_div(const Lanes &a, const Lanes &p)
+{
+	const Lanes one = Lanes::all(1);
+	Lanes q = (a / p).floor();
+	q = Lanes::if_less(a, q * p, q - one, q);
+	q = Lanes::if_less(a, q * p + p, q, q + one);
+	return q;
+}
+
+// ceil(a / p), under the same conditions
+static inline Lanes ceil_div(const Lanes &a, const Lanes &p)
+{
+	const Lanes one = Lanes::all(1);
+	Lanes q = (a / p).ceil();
+	q = Lanes::if_less(q * p, a, q + one, q);
+	q = Lanes::if_less(q * p - p, a, q, q - one);
+	return q;
+}
+
+DemandKernel::DemandKernel(const TaskSet &ts)
+	: num_tasks(ts.get_task_count()), buffer(NULL), max_time(-1),
+	  can_approximate(false)
+{
+	num_lanes = (num_tasks + Lanes::WIDTH - 1) / Lanes::WIDTH * Lanes::WIDTH;
+
+	if (num_lanes)
+	{
+		void *mem;
+		if (posix_memalign(&mem, 64, 4 * num_lanes * sizeof(double)))
+			throw std::bad_alloc();
+		buffer = (double*) mem;
+	}
+
+	period      = buffer;
+	deadline    = buffer + num_lanes;
+	wcet        = buffer + 2 * num_lanes;
+	exact_until = buffer + 3 * num_lanes;
+
+	bool fits = true;
+	double util = 0, total_wcet = 0;
+
+	for (unsigned int i = 0; i < num_tasks; i++)
+	{
+		period[i]      = ts[i].get_period();
+		deadline[i]    = ts[i].get_deadline();
+		wcet[i]        = ts[i].get_wcet();
+		exact_until[i] = deadline[i];
+
+		fits = fits && period[i] <= MAX_PARAMETER
+		            && deadline[i] <= MAX_PARAMETER
+		            && wcet[i] <= MAX_PARAMETER;
+
+		util       += wcet[i] / period[i];
+		total_wcet += wcet[i];
+	}
+
+	for (unsigned int i = num_tasks; i < num_lanes; i++)
+	{
+		period[i]      = 1;
+		deadline[i]    = NEVER;
+		wcet[i]        = 0;
+		exact_until[i] = NEVER;
+	}
+
+	if (!fits)
+		return;
+
+	// Any demand or request bound is at most t * U + sum C_i, plus less
+	// than one per task in the case of the approximation. The margin
+	// covers the rounding errors of util.
+	double limit = MAX_PARAMETER;
+	if (util > 0)
+		limit = std::min(limit, (EXACT_LIMIT - total_wcet - num_tasks)
+		                        / (util * (1 + 1E-9)));
+
+	if (limit >= 0)
+		max_time = fixed_integral_t((long) limit);
+}
+
+DemandKernel::~DemandKernel()
+{
+	free(buffer);
+}
+
+double DemandKernel::checked_time(const fixed_integral_t &time) const
+{
+	if (time > max_time || -time > max_time)
+		throw fixed_width_overflow();
+	return time.get_si();
+}
+
+fixed_integral_t DemandKernel::dbf(const fixed_integral_t &time) const
+{
+	const Lanes t = Lanes::all(checked_time(time));
+	const Lanes zero = Lanes::all(0), one = Lanes::all(1);
+	Lanes demand = zero;
+
+	for (unsigned int i = 0; i < num_lanes; i += Lanes::WIDTH)
+	{
+		const Lanes p = Lanes::load(period + i);
+		const Lanes jobs = floor_div(t - Lanes::load(deadline + i), p) + one;
+		demand = demand + Lanes::max(jobs, zero) * Lanes::load(wcet + i);
+	}
+
+	return fixed_integral_t((long) demand.sum());
+}
+
+fixed_integral_t DemandKernel::rbf(const fixed_integral_t &time) const
+{
+	const Lanes t = Lanes::all(checked_time(time));
+	const Lanes zero = Lanes::all(0);
+	Lanes requests = zero;
+
+	for (unsigned int i = 0; i < num_lanes; i += Lanes::WIDTH)
+	{
+		const Lanes jobs = ceil_div(t, Lanes::load(period + i));
+		requests = requests + Lanes::max(jobs, zero) * Lanes::load(wcet + i);
+	}
+
+	return fixed_integral_t((long) requests.sum());
+}
+
+fixed_integral_t DemandKernel::last_deadline_before(const fixed_integral_t &time) const
+{
+	const Lanes t = Lanes::all(checked_time(time));
+	const Lanes zero = Lanes::all(0);
+	Lanes latest = zero;
+
+	for (unsigned int i = 0; i < num_lanes; i += Lanes::WIDTH)
+	{
+		const Lanes p = Lanes::load(period + i);
+		const Lanes d = Lanes::load(deadline + i);
+
+		// latest deadline at or before t, and the one before if it is t
+		Lanes dl = floor_div(t - d, p) * p + d;
+		dl = Lanes::if_equal(dl, t, dl - p, dl);
+		// tasks without a deadline before t do not count
+		latest = Lanes::max(latest, Lanes::if_less(d, t, dl, zero));
+	}
+
+	return fixed_integral_t((long) latest.max());
+}
+
+void DemandKernel::task_dbf(const fixed_integral_t &time,
+                            fixed_integral_t dbf[],
+                            fixed_integral_t carry_in_dbf[]) const
+{
+	const Lanes t = Lanes::all(checked_time(time));
+	const Lanes zero = Lanes::all(0), one = Lanes::all(1);
+
+	alignas(64) double out[Lanes::WIDTH], carry_in_out[Lanes::WIDTH];
+
+	for (unsigned int i = 0; i < num_lanes; i += Lanes::WIDTH)
+	{
+		const Lanes p = Lanes::load(period + i);
+		const Lanes c = Lanes::load(wcet + i);
+
+		const Lanes jobs = floor_div(t - Lanes::load(deadline + i), p) + one;
+		(Lanes::max(jobs, zero) * c).store(out);
+
+		const Lanes periods = floor_div(t, p);
+		(periods * c + Lanes::min(c, t - periods * p)).store(carry_in_out);
+
+		for (unsigned int j = 0; j < Lanes::WIDTH && i + j < num_tasks; j++)
+		{
+			dbf[i + j] = fixed_integral_t((long) out[j]);
+			carry_in_dbf[i + j] = fixed_integral_t((long) carry_in_out[j]);
+		}
+	}
+}
+
+void DemandKernel::set_approximation(const unsigned long k[])
+{
+	can_approximate = true;
+	for (unsigned int i = 0; i < num_tasks; i++)
+	{
+		exact_until[i] = k[i] * period[i] + deadline[i];
+		// the corrected quotient in approx_dbf() is within two periods
+		// of (t - D_i) mod P_i * C_i
+		can_approximate = can_approximate &&
+			period[i] * (wcet[i] + 2) <= EXACT_LIMIT;
+	}
+}
+
+fixed_integral_t DemandKernel::approx_dbf(const fixed_integral_t &time) const
+{
+	if (!can_approximate)
+		throw fixed_width_overflow();
+
+	const Lanes t = Lanes::all(checked_time(time));
+	const Lanes zero = Lanes::all(0), one = Lanes::all(1);
+	Lanes demand = zero;
+
+	for (unsigned int i = 0; i < num_lanes; i += Lanes::WIDTH)
+	{
+		const Lanes p = Lanes::load(period + i);
+		const Lanes c = Lanes::load(wcet + i);
+		const Lanes a = t - Lanes::load(deadline + i);
+
+		const Lanes q = floor_div(a, p);
+		const Lanes exact = Lanes::max(q + one, zero) * c;
+		// C_i + ceil((t - D_i) * C_i / P_i), split into whole periods
+		// and the remainder to keep the product exact
+		const Lanes approx = c + q * c + ceil_div((a - q * p) * c, p);
+
+		demand = demand + Lanes::if_less(t, Lanes::load(exact_until + i),
+		                                 exact, approx);
+	}
+
+	return fixed_integral_t((long) demand.sum());
+}
@@ -3,6 +3,7 @@
 #include <vector>
 
 #include "tasks.h"
+#include "demand_kernel.h"
 #include "schedulability.h"
 
 #include "edf/baruah.h"
@@ -10,16 +11,17 @@
 #include <iostream>
 #include "task_io.h"
 
-#include "cpu_time.h"
+#include "analysis_budget.h"
 
 using namespace std;
 
 const double BaruahGedf::MAX_RUNTIME = 5.0; /* seconds */
 
 
+template <typename Int>
 static void demand_bound_function(const Task &tsk,
-                                  const integral_t &t,
-                                  integral_t &db)
+                                  const Int &t,
+                                  Int &db)
 {
     db = t;
     db -= tsk.get_deadline();
@@ -33,10 +35,11 @@ static void demand_bound_function(const Task &tsk,
         db = 0;
 }
 
+template <typename Int>
 class DBFPointsOfChange
 {
 private:
-    integral_t     cur;
+    Int           cur;
     unsigned long pi; // period
 
 public:
@@ -56,7 +59,7 @@ public:
             next();
     }
 
-    const integral_t& get_cur() const
+    const Int& get_cur() const
     {
         return cur;
     }
@@ -67,31 +70,35 @@ public:
     }
 };
 
+template <typename Int>
 class DBFComparator {
 public:
-    bool operator() (DBFPointsOfChange *a, DBFPointsOfChange *b)
+    bool operator() (DBFPointsOfChange<Int> *a, DBFPointsOfChange<Int> *b)
     {
         return b->get_cur() < a->get_cur();
     }
 };
 
-typedef priority_queue<DBFPointsOfChange*,
-                       vector<DBFPointsOfChange*>,
-                       DBFComparator> DBFQueue;
-
+template <typename Int>
 class AllDBFPointsOfChange
 {
 private:
-    DBFPointsOfChange *dbf;
+    typedef priority_queue<DBFPointsOfChange<Int>*,
+                           vector<DBFPointsOfChange<Int>*>,
+                           DBFComparator<Int> > DBFQueue;
+
+    DBFPointsOfChange<Int> *dbf;
     DBFQueue           queue;
-    integral_t          last;
-    integral_t         *upper_bound;
+    Int                last;
+    Int               *upper_bound;
 
 public:
-    void init(const TaskSet &ts, int k, integral_t* bound)
+    AllDBFPointsOfChange() : dbf(NULL) {}
+
+    void init(const TaskSet &ts, int k, Int* bound)
     {
         last = -1;
-        dbf = new DBFPointsOfChange[ts.get_task_count()];
+        dbf = new DBFPointsOfChange<Int>[ts.get_task_count()];
         for (unsigned int i = 0; i < ts.get_task_count(); i++)
         {
             dbf[i].init(ts[i], ts[k]);
@@ -105,12 +112,12 @@ public:
         delete[] dbf;
     }
 
-    bool get_next(integral_t &t)
+    bool get_next(Int &t)
     {
         if (last > *upper_bound)
             return false;
 
-        DBFPointsOfChange* pt;
+        DBFPointsOfChange<Int>* pt;
         do // avoid duplicates
         {
             pt = queue.top();
@@ -125,77 +132,99 @@ public:
     }
 };
 
-static
-void interval1(unsigned int i, unsigned int k, const TaskSet &ts,
-               const integral_t &ilen, integral_t &i1)
-{
-    integral_t dbf, tmp;
-    tmp = ilen + ts[k].get_deadline();
-    demand_bound_function(ts[i], tmp, dbf);
-    if (i == k)
-        i1 = min(integral_t(dbf - ts[k].get_wcet()), ilen);
-    else
-        i1 = min(dbf,
-                 integral_t(ilen + ts[k].get_deadline() -
-                           (ts[k].get_wcet() - 1)));
-}
-
-
+template <typename Int>
 static void demand_bound_function_prime(const Task &tsk,
-                                        const integral_t &t,
-                                        integral_t &db)
+                                        const Int &t,
+                                        Int &db)
 // carry-in scenario
 {
     db = t;
     db /= tsk.get_period();
     db *= tsk.get_wcet();
-    db += min(integral_t(tsk.get_wcet()), integral_t(t % tsk.get_period()));
+    db += min(Int(tsk.get_wcet()), Int(t % tsk.get_period()));
 }
 
-static void interval2(unsigned int i, unsigned int k, const TaskSet &ts,
-                       const integral_t &ilen, integral_t &i2)
+static void task_demands(const TaskSet &ts, const DemandKernel &kernel,
+                         const fixed_integral_t &t,
+                         fixed_integral_t *dbf, fixed_integral_t *dbf_prime)
+{
+    kernel.task_dbf(t, dbf, dbf_prime);
+}
+
+static void task_demands(const TaskSet &ts, const DemandKernel &kernel,
+                         const integral_t &t,
+                         integral_t *dbf, integral_t *dbf_prime)
+{
+    for (unsigned int i = 0; i < ts.get_task_count(); i++)
+    {
+        demand_bound_function(ts[i], t, dbf[i]);
+        demand_bound_function_prime(ts[i], t, dbf_prime[i]);
+    }
+}
+
+template <typename Int>
+static
+void interval1(unsigned int i, unsigned int k, const TaskSet &ts,
+               const Int &ilen, const Int &dbf, Int &i1)
 {
-    integral_t dbf, tmp;
+    if (i == k)
+        i1 = min(Int(dbf - ts[k].get_wcet()), ilen);
+    else
+        i1 = min(dbf,
+                 Int(ilen + ts[k].get_deadline() -
+                    (ts[k].get_wcet() - 1)));
+}
 
-    tmp = ilen + ts[k].get_deadline();
-    demand_bound_function_prime(ts[i], tmp, dbf);
+template <typename Int>
+static void interval2(unsigned int i, unsigned int k, const TaskSet &ts,
+                       const Int &ilen, const Int &dbf_prime, Int &i2)
+{
     if (i == k)
-        i2 = min(integral_t(dbf - ts[k].get_wcet()), ilen);
+        i2 = min(Int(dbf_prime - ts[k].get_wcet()), ilen);
     else
-        i2 = min(dbf,
-                 integral_t(ilen + ts[k].get_deadline() -
-                           (ts[k].get_wcet() - 1)));
+        i2 = min(dbf_prime,
+                 Int(ilen + ts[k].get_deadline() -
+                    (ts[k].get_wcet() - 1)));
 }
 
+template <typename Int>
 class MPZComparator {
 public:
-    bool operator() (integral_t *a, integral_t *b)
+    bool operator() (Int *a, Int *b)
     {
         return *b < *a;
     }
 };
 
+template <typename Int>
 bool BaruahGedf::is_task_schedulable(unsigned int k,
                                      const TaskSet &ts,
-                                     const integral_t &ilen,
-                                     integral_t &i1,
-                                     integral_t &sum,
-                                     integral_t *idiff,
-                                     integral_t **ptr)
+                                     const DemandKernel &kernel,
+                                     const Int &ilen,
+                                     Int &i1,
+                                     Int &sum,
+                                     Int *dbf,
+                                     Int *dbf_prime,
+                                     Int *idiff,
+                                     Int **ptr)
 {
-    integral_t bound;
+    Int bound;
     sum = 0;
 
+    // demand of all tasks in an interval of length ilen + D_k
+    const Int len(ilen + ts[k].get_deadline());
+    task_demands(ts, kernel, len, dbf, dbf_prime);
+
     for (unsigned int i = 0; i < ts.get_task_count(); i++)
     {
-        interval1(i, k, ts, ilen, i1);
-        interval2(i, k, ts, ilen, idiff[i]);
+        interval1(i, k, ts, ilen, dbf[i], i1);
+        interval2(i, k, ts, ilen, dbf_prime[i], idiff[i]);
         sum      += i1;
         idiff[i] -= i1;
     }
 
     /* sort pointers to idiff to find largest idiff values */
-    sort(ptr, ptr + ts.get_task_count(), MPZComparator());
+    sort(ptr, ptr + ts.get_task_count(), MPZComparator<Int>());
 
     for (unsigned int i = 0; i < m - 1 && i < ts.get_task_count(); i++)
         sum += *ptr[i];
@@ -268,27 +297,58 @@ bool BaruahGedf::is_schedulable(const TaskSet &ts,
         return false;
     }
 
-    double start_time = get_cpu_usage();
+    AnalysisBudget default_budget(0, MAX_RUNTIME);
+    AnalysisBudget &run_budget = budget ? *budget : default_budget;
 
-    integral_t i1, sum;
-    integral_t *max_test_point, *idiff;
-    integral_t** ptr; // indirect access to idiff
+    std::vector<integral_t> max_test_point(ts.get_task_count());
+    get_max_test_points(ts, m_minus_u, max_test_point.data());
 
-    idiff          = new integral_t[ts.get_task_count()];
-    max_test_point = new integral_t[ts.get_task_count()];
-    ptr            = new integral_t*[ts.get_task_count()];
-    for (unsigned int i = 0; i < ts.get_task_count(); i++)
-        ptr[i] = idiff + i;
+    DemandKernel kernel(ts);
+
+    // The test points and demands usually fit into 64 bits, and the kernel
+    // evaluates them for all tasks at once.
+    if (get_fixed_width_mode() != GMP_ONLY)
+    {
+        try
+        {
+            std::vector<fixed_integral_t> fixed_max_test_point;
+            for (unsigned int i = 0; i < ts.get_task_count(); i++)
+                fixed_max_test_point.push_back(
+                    fixed_integral_t(max_test_point[i]));
+            return check_test_points(ts, kernel, fixed_max_test_point.data(),
+                                     run_budget);
+        }
+        catch (const fixed_width_overflow &)
+        {
+            if (get_fixed_width_mode() == FIXED_WIDTH_ONLY)
+                throw;
+        }
+    }
+    return check_test_points(ts, kernel, max_test_point.data(), run_budget);
+}
+
+template <typename Int>
+bool BaruahGedf::check_test_points(const TaskSet &ts,
+                                   const DemandKernel &kernel,
+                                   Int *max_test_point,
+                                   AnalysisBudget &budget)
+{
+    AnalysisBudget::Meter meter(&budget);
 
-    get_max_test_points(ts, m_minus_u, max_test_point);
+    Int i1, sum;
+    std::vector<Int> dbf(ts.get_task_count());
+    std::vector<Int> dbf_prime(ts.get_task_count());
+    std::vector<Int> idiff(ts.get_task_count());
+    std::vector<Int*> ptr(ts.get_task_count()); // indirect access to idiff
 
-    integral_t ilen;
+    for (unsigned int i = 0; i < ts.get_task_count(); i++)
+        ptr[i] = &idiff[i];
+
+    Int ilen;
     bool point_in_range = true;
     bool schedulable = true;
 
-    AllDBFPointsOfChange *all_pts;
-
-    all_pts = new AllDBFPointsOfChange[ts.get_task_count()];
+    std::vector<AllDBFPointsOfChange<Int> > all_pts(ts.get_task_count());
     for (unsigned int k = 0; k < ts.get_task_count(); k++)
         all_pts[k].init(ts, k, max_test_point + k);
 
@@ -298,7 +358,7 @@ bool BaruahGedf::is_schedulable(const TaskSet &ts,
     {
         point_in_range = false;
         // check for excessive run time every 10 iterations
-        if (++iter_count % 10 == 0 && get_cpu_usage() > start_time + MAX_RUNTIME)
+        if (++iter_count % 10 == 0 && meter.exhausted())
         {
              // This is taking too long. Give up.
              schedulable = false;
@@ -307,18 +367,14 @@ bool BaruahGedf::is_schedulable(const TaskSet &ts,
         for (unsigned int k = 0; k < ts.get_task_count() && schedulable; k++)
             if (all_pts[k].get_next(ilen))
             {
-                schedulable = is_task_schedulable(k, ts, ilen, i1, sum,
-                                                  idiff, ptr);
+                meter.charge();
+                schedulable = is_task_schedulable(k, ts, kernel, ilen, i1,
+                                                  sum, dbf.data(),
+                                                  dbf_prime.data(),
+                                                  idiff.data(), ptr.data());
                 point_in_range = true;
             }
     }
 
-
-    delete[] all_pts;
-    delete[] max_test_point;
-    delete[] idiff;
-    delete[] ptr;
-
     return schedulable;
 }
-
@@ -11,33 +11,38 @@
 #include <iostream>
 #include "task_io.h"
 
+#include "analysis_budget.h"
+
 using namespace std;
 
-static void get_q_r(const Task &t_i, const fractional_t &time,
-                    integral_t &q_i, fractional_t &r_i)
+template <typename Int, typename Frac>
+static void get_q_r(const Task &t_i, const Frac &time,
+                    Int &q_i, Frac &r_i)
 {
     // compute q_i -- floor(time / period)
     //         r_i -- time % period
 
     r_i = time / t_i.get_period();
-    q_i = r_i; // truncate, i.e. implicit floor
+    q_i = truncate_to_integral(r_i); // i.e. implicit floor
 
     r_i  = time;
     r_i -= q_i * t_i.get_period();
 }
 
-static void compute_q_r(const TaskSet &ts, const fractional_t &time,
-                        integral_t q[], fractional_t r[])
+template <typename Int, typename Frac>
+static void compute_q_r(const TaskSet &ts, const Frac &time,
+                        Int q[], Frac r[])
 {
     for (unsigned int i = 0; i < ts.get_task_count(); i++)
         get_q_r(ts[i], time, q[i], r[i]);
 }
 
+template <typename Int, typename Frac>
 static void ffdbf(const Task &t_i,
-                  const fractional_t &time, const fractional_t &speed,
-                  const integral_t &q_i, const fractional_t &r_i,
-                  fractional_t &demand,
-                  fractional_t &tmp)
+                  const Frac &time, const Frac &speed,
+                  const Int &q_i, const Frac &r_i,
+                  Frac &demand,
+                  Frac &tmp)
 {
     /* this is the cost in all three cases */
     demand += q_i * t_i.get_wcet();
@@ -63,10 +68,11 @@ static void ffdbf(const Task &t_i,
     }
 }
 
+template <typename Int, typename Frac>
 static void ffdbf_ts(const TaskSet &ts,
-                     const integral_t q[], const fractional_t r[],
-                     const fractional_t &time, const fractional_t &speed,
-                     fractional_t &demand, fractional_t &tmp)
+                     const Int q[], const Frac r[],
+                     const Frac &time, const Frac &speed,
+                     Frac &demand, Frac &tmp)
 {
     demand = 0;
     for (unsigned int i = 0; i < ts.get_task_count(); i++)
@@ -74,18 +80,19 @@ static void ffdbf_ts(const TaskSet &ts,
 }
 
 
+template <typename Frac>
 class TestPoints
 {
 private:
-    fractional_t     time;
-    fractional_t     with_offset;
+    Frac          time;
+    Frac          with_offset;
     unsigned long period;
     bool          first_point;
 
 public:
     void init(const Task& t_i,
-              const fractional_t& speed,
-              const fractional_t& min_time)
+              const Frac& speed,
+              const Frac& min_time)
     {
         period = t_i.get_period();
         with_offset = t_i.get_wcet() / speed;
@@ -107,7 +114,7 @@ public:
             next();
     }
 
-    const fractional_t& get_cur() const
+    const Frac& get_cur() const
     {
         if (first_point)
             return with_offset;
@@ -128,35 +135,37 @@ public:
     }
 };
 
+template <typename Frac>
 class TimeComparator {
 public:
-    bool operator() (TestPoints *a, TestPoints *b)
+    bool operator() (TestPoints<Frac> *a, TestPoints<Frac> *b)
     {
         return b->get_cur() < a->get_cur();
     }
 };
 
-typedef priority_queue<TestPoints*,
-                       vector<TestPoints*>,
-                       TimeComparator> TimeQueue;
-
+template <typename Frac>
 class AllTestPoints
 {
 private:
-    TestPoints *pts;
+    typedef priority_queue<TestPoints<Frac>*,
+                           vector<TestPoints<Frac>*>,
+                           TimeComparator<Frac> > TimeQueue;
+
+    TestPoints<Frac> *pts;
     TimeQueue   queue;
-    fractional_t   last;
+    Frac        last;
     TaskSet const &ts;
 
 public:
     AllTestPoints(const TaskSet &ts)
         : ts(ts)
     {
-        pts = new TestPoints[ts.get_task_count()];
+        pts = new TestPoints<Frac>[ts.get_task_count()];
     }
 
-    void init(const fractional_t &speed,
-              const fractional_t &min_time)
+    void init(const Frac &speed,
+              const Frac &min_time)
     {
         last = -1;
         // clean out queue
@@ -175,9 +184,9 @@ public:
         delete[] pts;
     }
 
-    void get_next(fractional_t &t)
+    void get_next(Frac &t)
     {
-        TestPoints* pt;
+        TestPoints<Frac>* pt;
         do // avoid duplicates
         {
             pt = queue.top();
@@ -190,12 +199,13 @@ public:
     }
 };
 
+template <typename Int, typename Frac>
 bool FFDBFGedf::witness_condition(const TaskSet &ts,
-                                  const integral_t q[], const fractional_t r[],
-                                  const fractional_t &time,
-                                  const fractional_t &speed)
+                                  const Int q[], const Frac r[],
+                                  const Frac &time,
+                                  const Frac &speed)
 {
-    fractional_t demand, bound;
+    Frac demand, bound;
 
     ffdbf_ts(ts, q, r, time, speed, demand, bound);
 
@@ -222,23 +232,49 @@ bool FFDBFGedf::is_schedulable(const TaskSet &ts,
             return false;
     }
 
+    // The test points and demands usually fit into 64 bits.
+    if (get_fixed_width_mode() != GMP_ONLY)
+    {
+        try
+        {
+            return check_test_points<fixed_integral_t, fixed_fractional_t>(ts);
+        }
+        catch (const fixed_width_overflow &)
+        {
+            if (get_fixed_width_mode() == FIXED_WIDTH_ONLY)
+                throw;
+        }
+    }
+    return check_test_points<integral_t, fractional_t>(ts);
+}
+
+template <typename Int, typename Frac>
+bool FFDBFGedf::check_test_points(const TaskSet &ts)
+{
+    AnalysisBudget::Meter meter(budget);
+    unsigned long iter_count = 0;
+
     // allocate helpers
-    AllTestPoints testing_set(ts);
-    integral_t *q = new integral_t[ts.get_task_count()];
-    fractional_t *r = new fractional_t[ts.get_task_count()];
+    AllTestPoints<Frac> testing_set(ts);
+    std::vector<Int> q(ts.get_task_count());
+    std::vector<Frac> r(ts.get_task_count());
+
+    fractional_t utilization, max_density;
+    ts.get_utilization(utilization);
+    ts.get_max_density(max_density);
 
-    fractional_t sigma_bound;
-    fractional_t time_bound;
-    fractional_t tmp(1, epsilon_denom);
+    Frac sigma_bound;
+    Frac time_bound;
+    Frac tmp(1, epsilon_denom);
 
     // compute sigma bound
     tmp = 1;
     tmp /= epsilon_denom;
-    ts.get_utilization(sigma_bound);
+    sigma_bound = Frac(utilization);
     sigma_bound -= m;
     sigma_bound /= - ((int) (m - 1)); // neg. to flip sign
     sigma_bound -= tmp; // epsilon
-    sigma_bound = min(sigma_bound, fractional_t(1));
+    sigma_bound = min(sigma_bound, Frac(1));
 
     // compute time bound
     time_bound = 0;
@@ -246,8 +282,9 @@ bool FFDBFGedf::is_schedulable(const TaskSet &ts,
         time_bound += ts[i].get_wcet();
     time_bound /= tmp; // epsilon
 
-    fractional_t t_cur;
-    fractional_t sigma_cur, sigma_nxt;
+    const Frac sigma_step(this->sigma_step);
+    Frac t_cur;
+    Frac sigma_cur, sigma_nxt;
     bool schedulable;
 
     t_cur = 0;
@@ -255,7 +292,7 @@ bool FFDBFGedf::is_schedulable(const TaskSet &ts,
 
     // Start with minimum possible sigma value, then try
     // multiples of sigma_step.
-    ts.get_max_density(sigma_cur);
+    sigma_cur = Frac(max_density);
 
     // setup brute force sigma value range
     sigma_nxt = sigma_cur / sigma_step;
@@ -269,11 +306,18 @@ bool FFDBFGedf::is_schedulable(const TaskSet &ts,
     {
         testing_set.init(sigma_cur, t_cur);
         do {
+            // check for excessive run time every 10 test points
+            if (++iter_count % 10 == 0 && meter.exhausted())
+                // Give up.
+                return false;
+            meter.charge();
+
             testing_set.get_next(t_cur);
             if (t_cur <= time_bound)
             {
-                compute_q_r(ts, t_cur, q, r);
-                schedulable = witness_condition(ts, q, r, t_cur, sigma_cur);
+                compute_q_r(ts, t_cur, q.data(), r.data());
+                schedulable = witness_condition(ts, q.data(), r.data(),
+                                                t_cur, sigma_cur);
             }
             else
                 // exceeded testing interval
@@ -288,12 +332,10 @@ bool FFDBFGedf::is_schedulable(const TaskSet &ts,
                 sigma_cur = sigma_nxt;
                 sigma_nxt += sigma_step;
             } while (sigma_cur <= sigma_bound &&
-                     !witness_condition(ts, q, r, t_cur, sigma_cur));
+                     !witness_condition(ts, q.data(), r.data(),
+                                        t_cur, sigma_cur));
         }
     }
 
-    delete [] q;
-    delete [] r;
-
     return schedulable;
 }
@@ -1,3 +1,13 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <math.h>
+
 #include "tasks.h"
 #include "schedulability.h"
 
@@ -12,6 +22,181 @@
 #include "edf/la.h"
 #include "edf/gedf.h"
 
+#include "analysis_budget.h"
+#include "cpu_time.h"
+
+// updated without a lock, each counter on its own
+struct GEDFTestCounters
+{
+    std::atomic<unsigned long> runs;
+    std::atomic<unsigned long> accepted;
+    std::atomic<unsigned long> cpu_nanos;
+};
+
+static GEDFTestCounters counters[GEDF_NUM_TESTS];
+
+GEDFTestStats get_gedf_test_stats(gedf_test_t test)
+{
+    GEDFTestStats s;
+    if (test < GEDF_NUM_TESTS)
+    {
+        s.runs = counters[test].runs;
+        s.accepted = counters[test].accepted;
+        s.cpu_time = counters[test].cpu_nanos / 1E9;
+    }
+    return s;
+}
+
+void reset_gedf_test_stats()
+{
+    for (unsigned int i = 0; i < GEDF_NUM_TESTS; i++)
+    {
+        counters[i].runs = 0;
+        counters[i].accepted = 0;
+        counters[i].cpu_nanos = 0;
+    }
+}
+
+static void record_outcome(gedf_test_t test, bool accepted, double cpu_time)
+{
+    counters[test].runs++;
+    counters[test].accepted += accepted;
+    counters[test].cpu_nanos += (unsigned long) (cpu_time * 1E9);
+}
+
+// Acceptances per CPU second, smoothed so that a single run does not
+// decide the order. Tests that have not run yet come first.
+static double acceptance_per_cpu_second(const GEDFTestStats &s)
+{
+    if (!s.runs)
+        return HUGE_VAL;
+
+    const double mean_cpu_time = std::max(s.cpu_time / s.runs, 1E-9);
+    return (s.accepted + 1.0) / (s.runs + 2.0) / mean_cpu_time;
+}
+
+static void order_by_stats(gedf_test_t *tests, unsigned int num_tests)
+{
+    double score[GEDF_NUM_TESTS];
+    for (unsigned int i = 0; i < GEDF_NUM_TESTS; i++)
+        score[i] = acceptance_per_cpu_second(
+            get_gedf_test_stats((gedf_test_t) i));
+
+    // ties keep the default order
+    std::stable_sort(tests, tests + num_tests,
+                     [&](gedf_test_t a, gedf_test_t b) {
+                         return score[a] > score[b];
+                     });
+}
+
+bool GlobalEDF::run_test(gedf_test_t test, const TaskSet &ts,
+                         AnalysisBudget *budget)
+{
+    bool ok = false;
+
+    switch (test)
+    {
+    case GEDF_TEST_BAKER:
+        ok = BakerGedf(m).is_schedulable(ts, false);
+        break;
+    case GEDF_TEST_GFB:
+        ok = GFBGedf(m).is_schedulable(ts, false);
+        break;
+    case GEDF_TEST_RTA:
+        ok = RTAGedf(m, rta_step, 25, budget).is_schedulable(ts, false);
+        break;
+    case GEDF_TEST_BARUAH:
+        ok = BaruahGedf(m, budget).is_schedulable(ts, false);
+        break;
+    case GEDF_TEST_FFDBF:
+        ok = FFDBFGedf(m, 10, 50, budget).is_schedulable(ts, false);
+        break;
+    case GEDF_TEST_LA:
+        ok = LAGedf(m, budget).is_schedulable(ts, false);
+        break;
+    case GEDF_TEST_LOAD:
+        ok = LoadGedf(m, 100, budget).is_schedulable(ts, false);
+        break;
+    default:
+        break;
+    }
+
+    return ok;
+}
+
+bool GlobalEDF::run_tests_concurrently(const gedf_test_t *tests,
+                                       unsigned int num_tests,
+                                       const TaskSet &ts)
+{
+    // The budgets only serve to cancel the tests, except that Baruah's and
+    // the LA test keep the CPU time limits that apply without a budget
+    // (summed over all tasks in the case of the LA test).
+    std::vector<std::unique_ptr<AnalysisBudget> > budgets;
+    for (unsigned int i = 0; i < num_tests; i++)
+        if (tests[i] == GEDF_TEST_BARUAH)
+            budgets.emplace_back(new AnalysisBudget(0, BaruahGedf::MAX_RUNTIME));
+        else if (tests[i] == GEDF_TEST_LA)
+            budgets.emplace_back(new AnalysisBudget(
+                0, LAGedf::MAX_RUNTIME * ts.get_task_count()));
+        else
+            budgets.emplace_back(new AnalysisBudget());
+
+    std::atomic<bool> accepted(false);
+    std::exception_ptr error;
+    std::mutex error_lock;
+
+    auto run = [&](unsigned int i) {
+        try
+        {
+            bool ok = run_test(tests[i], ts, budgets[i].get());
+
+            if (ok && !accepted.exchange(true))
+                for (unsigned int j = 0; j < num_tests; j++)
+                    if (j != i)
+                        budgets[j]->cancel();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> guard(error_lock);
+            if (!error)
+                error = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    unsigned int started = 1;
+    try
+    {
+        threads.reserve(num_tests);
+        for (; started < num_tests; started++)
+            threads.push_back(std::thread(run, started));
+    }
+    catch (...)
+    {
+        // Out of threads (std::system_error) or memory. The threads that
+        // did start must be joined all the same, and the calling thread
+        // takes over the tests that did not get one.
+    }
+
+    // the calling thread takes the first test
+    if (num_tests)
+        run(0);
+    for (unsigned int i = started; i < num_tests && !accepted; i++)
+        run(i);
+
+    for (unsigned int i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    // Each test is sufficient, so an acceptance stands even if another
+    // test failed; an error only matters if it may have hidden one.
+    if (accepted)
+        return true;
+    if (error)
+        std::rethrow_exception(error);
+
+    return false;
+}
+
 bool GlobalEDF::is_schedulable(const TaskSet &ts,
                                bool check)
 {
@@ -36,27 +221,68 @@ bool GlobalEDF::is_schedulable(const TaskSet &ts,
             return true;
     }
 
+    gedf_test_t tests[GEDF_NUM_TESTS];
+    unsigned int num_tests = 0;
+
     // Baker's test can deal with arbitrary deadlines.
     // It's cheap, so do it first.
-    if (BakerGedf(m).is_schedulable(ts, false))
-        return true;
+    tests[num_tests++] = GEDF_TEST_BAKER;
 
     // Baruah's test and the BCL and GFB tests assume constrained deadlines.
     if (ts.has_only_constrained_deadlines())
-	    if (GFBGedf(m).is_schedulable(ts, false)
-            || (want_rta && RTAGedf(m, rta_step).is_schedulable(ts, false))
-               // The RTA test generalizes the BCL and BCLIterative tests.
-            || (want_baruah && BaruahGedf(m).is_schedulable(ts, false))
-            || (want_ffdbf && FFDBFGedf(m).is_schedulable(ts, false)))
-            return true;
+    {
+        tests[num_tests++] = GEDF_TEST_GFB;
+        // The RTA test generalizes the BCL and BCLIterative tests.
+        if (want_rta)
+            tests[num_tests++] = GEDF_TEST_RTA;
+        if (want_baruah)
+            tests[num_tests++] = GEDF_TEST_BARUAH;
+        if (want_ffdbf)
+            tests[num_tests++] = GEDF_TEST_FFDBF;
+    }
 
     // LA test can handle arbitrary deadlines
-    if (want_la && LAGedf(m).is_schedulable(ts, false))
-        return true;
+    if (want_la)
+        tests[num_tests++] = GEDF_TEST_LA;
 
     // Load-based test can handle arbitrary deadlines.
-    if (want_load && LoadGedf(m).is_schedulable(ts, false))
-        return true;
+    if (want_load)
+        tests[num_tests++] = GEDF_TEST_LOAD;
+
+    unsigned int first = 0;
+
+    if (mode == GEDF_CASCADE_PARALLEL)
+    {
+        // The closed-form tests take less time than starting a thread.
+        while (first < num_tests && (tests[first] == GEDF_TEST_BAKER ||
+                                     tests[first] == GEDF_TEST_GFB))
+        {
+            if (run_test(tests[first], ts, NULL))
+                return true;
+            first++;
+        }
+        return run_tests_concurrently(tests + first, num_tests - first, ts);
+    }
+
+    if (mode == GEDF_CASCADE_ADAPTIVE)
+    {
+        order_by_stats(tests, num_tests);
+
+        for (unsigned int i = 0; i < num_tests; i++)
+        {
+            const double start = get_cpu_usage();
+            bool ok = run_test(tests[i], ts, NULL);
+            record_outcome(tests[i], ok, get_cpu_usage() - start);
+            if (ok)
+                return true;
+        }
+        return false;
+    }
+
+    // Each test is sufficient, so the first one to pass decides.
+    for (unsigned int i = 0; i < num_tests; i++)
+        if (run_test(tests[i], ts, NULL))
+            return true;
 
     return false;
 }
@@ -16,7 +16,7 @@
 #include <iostream>
 #include "task_io.h"
 
-#include "cpu_time.h"
+#include "analysis_budget.h"
 
 using namespace std;
 
@@ -27,10 +27,11 @@ const double LAGedf::MAX_RUNTIME = 1.0; /* second per task per suspension length
 
 namespace LA {
 
+    template <typename Int>
     class DBFPointsOfChange
     {
     private:
-        integral_t     cur;
+        Int           cur;
         unsigned long pi; // period
 
     public:
@@ -49,7 +50,7 @@ namespace LA {
                 next();
         }
 
-        const integral_t& get_cur() const
+        const Int& get_cur() const
         {
             return cur;
         }
@@ -60,32 +61,34 @@ namespace LA {
         }
     };
 
+    template <typename Int>
     class DBFComparator {
     public:
-        bool operator() (DBFPointsOfChange *a, DBFPointsOfChange *b)
+        bool operator() (DBFPointsOfChange<Int> *a, DBFPointsOfChange<Int> *b)
         {
             return b->get_cur() < a->get_cur();
         }
     };
 
-    typedef priority_queue<DBFPointsOfChange*,
-                           vector<DBFPointsOfChange*>,
-                           DBFComparator> DBFQueue;
-
+    template <typename Int>
     class AllTestPoints
     {
     private:
-        DBFPointsOfChange *dbf;
+        typedef priority_queue<DBFPointsOfChange<Int>*,
+                               vector<DBFPointsOfChange<Int>*>,
+                               DBFComparator<Int> > DBFQueue;
+
+        DBFPointsOfChange<Int> *dbf;
         DBFQueue queue;
-        integral_t last;
-        integral_t upper_bound;
+        Int last;
+        Int upper_bound;
 
     public:
-        AllTestPoints(const TaskSet &ts, int k, const integral_t &bound)
+        AllTestPoints(const TaskSet &ts, int k, const Int &bound)
             : upper_bound(bound)
         {
             last = -1;
-            dbf = new DBFPointsOfChange[ts.get_task_count()];
+            dbf = new DBFPointsOfChange<Int>[ts.get_task_count()];
             for (unsigned int i = 0; i < ts.get_task_count(); i++)
             {
                 dbf[i].init(ts[i], ts[k]);
@@ -98,12 +101,12 @@ namespace LA {
             delete[] dbf;
         }
 
-        bool get_next(integral_t &t)
+        bool get_next(Int &t)
         {
             if (last > upper_bound)
                 return false;
 
-            DBFPointsOfChange* pt;
+            DBFPointsOfChange<Int>* pt;
             do // avoid duplicates
             {
                 pt = queue.top();
@@ -120,93 +123,98 @@ namespace LA {
 
 }
 
+template <typename Int>
 static void work_no_carry(
     unsigned int i,
     unsigned int l,
     const TaskSet &ts,
-    const integral_t &ilen,
-    integral_t &wnc,
+    const Int &ilen,
+    Int &wnc,
     unsigned long susp
 )
 {
-    integral_t dbf, tmp;
+    Int dbf, tmp;
     tmp = ilen + ts[l].get_deadline(); /* tmp = xi_l - lambda_l */
-    dbf = ts[i].dbf(tmp);
+    ts[i].bound_demand(tmp, dbf);
     if (i == l)
-        wnc = min(integral_t(dbf - ts[l].get_wcet()),
-                 max(integral_t(tmp - ts[l].get_deadline()),
-                     integral_t((tmp + ts[l].get_tardiness_threshold())
-                                - ts[l].get_period())));
+        wnc = min(Int(dbf - ts[l].get_wcet()),
+                 max(Int(tmp - ts[l].get_deadline()),
+                     Int((tmp + ts[l].get_tardiness_threshold())
+                         - ts[l].get_period())));
     else
         wnc = min(dbf,
-                 integral_t(tmp + ts[l].get_tardiness_threshold()
-                            - ts[l].get_wcet() - susp + 1));
+                 Int(tmp + ts[l].get_tardiness_threshold()
+                     - ts[l].get_wcet() - susp + 1));
 }
 
 
-static integral_t delta(
+template <typename Int>
+static Int delta(
     const Task &tsk,
-    const integral_t &t)
+    const Int &t)
 {
-    integral_t period = tsk.get_period();
-    integral_t wcet   = tsk.get_wcet();
-    integral_t tmp;
+    Int period = tsk.get_period();
+    Int wcet   = tsk.get_wcet();
+    Int tmp;
 
     tmp = divide_with_ceil(t, period);
 
-    integral_t db;
+    Int db;
 
     db  = (tmp - 1) * wcet;
-    db += min(wcet, integral_t(t - tmp * period + period));
+    db += min(wcet, Int(t - tmp * period + period));
 
     return db;
 }
 
+template <typename Int>
 static void work_carry_in(
     unsigned int i,
     unsigned int l,
     const TaskSet &ts,
-    const integral_t &ilen,
-    integral_t &wc,
+    const Int &ilen,
+    Int &wc,
     unsigned long susp)
 {
-    integral_t dbf, tmp;
+    Int dbf, tmp;
 
     tmp = ilen + ts[l].get_deadline(); /* tmp = xi_l - lambda_l */
 
     if (i == l) {
-        dbf = delta(ts[l], tmp + ts[l].get_tardiness_threshold());
-        wc = min(integral_t(dbf - ts[l].get_wcet()),
-                 max(integral_t(tmp - ts[l].get_deadline()),
-                     integral_t((tmp + ts[l].get_tardiness_threshold())
-                                - ts[l].get_period())));
+        dbf = delta(ts[l], Int(tmp + ts[l].get_tardiness_threshold()));
+        wc = min(Int(dbf - ts[l].get_wcet()),
+                 max(Int(tmp - ts[l].get_deadline()),
+                     Int((tmp + ts[l].get_tardiness_threshold())
+                         - ts[l].get_period())));
     } else {
-        dbf = delta(ts[i], tmp + ts[i].get_tardiness_threshold());
+        dbf = delta(ts[i], Int(tmp + ts[i].get_tardiness_threshold()));
         wc = min(dbf,
-                 integral_t(((tmp + ts[l].get_tardiness_threshold()) -
-                             ts[l].get_wcet()) - susp + 1));
+                 Int(((tmp + ts[l].get_tardiness_threshold()) -
+                      ts[l].get_wcet()) - susp + 1));
     }
 }
 
+template <typename Int>
 class MPZComparator {
 public:
-    bool operator() (integral_t *a, integral_t *b)
+    bool operator() (Int *a, Int *b)
     {
         return *b < *a;
     }
 };
 
+template <typename Int>
 bool LAGedf::is_task_schedulable_for_interval(
     const TaskSet &ts,
 	unsigned int l,
 	unsigned long suspend,
-	const integral_t &ilen, /* interval length is xi_l - d_l */
-	integral_t &i1,
-	integral_t &sum,
-	integral_t *idiff,
-	integral_t **ptr)
+	const Int &ilen, /* interval length is xi_l - d_l */
+	Int &i1,
+	Int &sum,
+	Int *idiff,
+	Int **ptr)
 {
-    integral_t bound;
+    Int bound;
     sum = 0;
 
     for (unsigned int i = 0; i < ts.get_task_count(); i++)
@@ -227,7 +235,7 @@ bool LAGedf::is_task_schedulable_for_interval(
     }
 
     /* sort pointers to idiff to find largest idiff values */
-    sort(ptr, ptr + ts.get_task_count(), MPZComparator());
+    sort(ptr, ptr + ts.get_task_count(), MPZComparator<Int>());
 
     /* Get m-1 largest idiff values for compute tasks
      * (self-suspending tasks have zero idiff). */
@@ -278,37 +286,68 @@ bool LAGedf::is_task_schedulable_for_suspension_length(
 	const fractional_t &test_point_sum,
 	const fractional_t &usum)
 {
-    bool schedulable = true;
+    const integral_t max_test_point =
+        get_max_test_point(ts, l, m_minus_u, test_point_sum, usum, suspend);
 
-    integral_t *idiff, i1, sum;
-    integral_t** ptr; // indirect access to idiff
+//    cout << "    up to " << max_test_point << endl;
 
-    idiff          = new integral_t[ts.get_task_count()];
-    ptr            = new integral_t*[ts.get_task_count()];
-    for (unsigned int i = 0; i < ts.get_task_count(); i++)
-        ptr[i] = idiff + i;
+    AnalysisBudget default_budget(0, MAX_RUNTIME);
+    AnalysisBudget &run_budget = budget ? *budget : default_budget;
 
-    LA::AllTestPoints all_pts(ts, l,
-        get_max_test_point(ts, l, m_minus_u, test_point_sum, usum, suspend));
+    // The test points and workloads usually fit into 64 bits.
+    if (get_fixed_width_mode() != GMP_ONLY)
+    {
+        try
+        {
+            return check_test_points(ts, l, suspend,
+                                     fixed_integral_t(max_test_point),
+                                     run_budget);
+        }
+        catch (const fixed_width_overflow &)
+        {
+            if (get_fixed_width_mode() == FIXED_WIDTH_ONLY)
+                throw;
+        }
+    }
+    return check_test_points(ts, l, suspend, max_test_point, run_budget);
+}
 
-//    cout << "    up to " << get_max_test_point(ts, l, m_minus_u, test_point_sum, usum, suspend) << endl;
+template <typename Int>
+bool LAGedf::check_test_points(
+    const TaskSet &ts,
+	unsigned int l,
+	unsigned long suspend,
+	const Int &max_test_point,
+	AnalysisBudget &budget)
+{
+    bool schedulable = true;
+
+    Int i1, sum;
+    std::vector<Int> idiff(ts.get_task_count());
+    std::vector<Int*> ptr(ts.get_task_count()); // indirect access to idiff
+    for (unsigned int i = 0; i < ts.get_task_count(); i++)
+        ptr[i] = &idiff[i];
+
+    LA::AllTestPoints<Int> all_pts(ts, l, max_test_point);
 
     unsigned long iter_count = 0;
-    double start_time = get_cpu_usage();
+    AnalysisBudget::Meter meter(&budget);
 
-    for (integral_t ilen = 0; schedulable && all_pts.get_next(ilen); )
+    for (Int ilen = 0; schedulable && all_pts.get_next(ilen); )
     {
         // check for excessive run time every 10 iterations
-        if (++iter_count % 10 == 0 && get_cpu_usage() > start_time + MAX_RUNTIME)
+        if (++iter_count % 10 == 0 && meter.exhausted())
              // This is taking too long. Give up.
             schedulable = false;
         else
+        {
+            meter.charge();
             schedulable = is_task_schedulable_for_interval(
-                                ts, l, suspend, ilen, i1, sum, idiff, ptr);
+                                ts, l, suspend, ilen, i1, sum,
+                                idiff.data(), ptr.data());
+        }
     }
 
-    delete [] idiff;
-    delete [] ptr;
     return schedulable;
 }
 
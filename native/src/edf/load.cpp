@@ -3,6 +3,8 @@
 
 #include "edf/load.h"
 
+#include "analysis_budget.h"
+
 #include <iostream>
 #include <algorithm>
 
@@ -27,7 +29,9 @@ bool LoadGedf::is_schedulable(const TaskSet &ts, bool check_preconditions)
     integral_t mu_ceil;
 
     // get the load of the task set
-    ts.approx_load(load, epsilon);
+    ts.approx_load(load, epsilon, budget);
+    if (budget && budget->is_exhausted())
+        return false;
 
     // compute bound (corollary 2)
     ts.get_max_density(max_density);
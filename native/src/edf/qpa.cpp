@@ -8,6 +8,7 @@
 #include <limits.h>
 
 #include "tasks.h"
+#include "demand_kernel.h"
 #include "math-helper.h"
 #include "stl-helper.h"
 #include "schedulability.h"
@@ -26,10 +27,11 @@ QPATest::QPATest(unsigned int num_processors)
 	}
 }
 
-static integral_t edf_busy_interval(const TaskSet &ts)
+template <typename Int>
+static Int edf_busy_interval(const TaskSet &ts)
 {
-	integral_t interval = 0;
-	integral_t total_cost = 0;
+	Int interval = 0;
+	Int total_cost = 0;
 
 	// initial guess: sum of all costs.
 	for (unsigned int i = 0; i < ts.get_task_count(); i++)
@@ -41,8 +43,8 @@ static integral_t edf_busy_interval(const TaskSet &ts)
 		total_cost = 0;
 		for (unsigned int i = 0; i < ts.get_task_count(); i++)
 		{
-			integral_t jobs;
-			jobs = divide_with_ceil(interval, ts[i].get_period());
+			Int jobs;
+			jobs = divide_with_ceil(interval, Int(ts[i].get_period()));
 			total_cost += jobs * ts[i].get_wcet();
 		}
 	} while (interval != total_cost);
@@ -50,6 +52,33 @@ static integral_t edf_busy_interval(const TaskSet &ts)
 	return interval;
 }
 
+static fixed_integral_t edf_busy_interval(const DemandKernel &kernel)
+{
+	fixed_integral_t interval;
+	// initial guess: sum of all costs, i.e., the requests at time 1
+	fixed_integral_t total_cost = kernel.rbf(1);
+
+	do {
+		interval = total_cost;
+		total_cost = kernel.rbf(interval);
+	} while (interval != total_cost);
+
+	return interval;
+}
+
+static integral_t edf_busy_interval(const TaskSet &ts)
+{
+	try
+	{
+		DemandKernel kernel(ts);
+		return edf_busy_interval(kernel).get_si();
+	}
+	catch (const fixed_width_overflow &)
+	{
+		return edf_busy_interval<integral_t>(ts);
+	}
+}
+
 static integral_t zhang_burns_interval(const TaskSet &ts)
 {
 	integral_t interval = 0;
@@ -97,10 +126,11 @@ std::set<unsigned long> get_testpoints(const TaskSet &ts,
 	return points;
 }
 
-static integral_t max_deadline(const Task &task,
-                               const integral_t &max_time)
+template <typename Int>
+static Int max_deadline(const Task &task,
+                        const Int &max_time)
 {
-	integral_t dl = max_time - task.get_deadline();
+	Int dl = max_time - task.get_deadline();
 
 	// implicit floor in integer division
 	dl /= task.get_period();
@@ -118,17 +148,18 @@ static unsigned long min_relative_deadline(const TaskSet &ts)
 	return dl;
 }
 
-static integral_t get_largest_testpoint(const TaskSet &ts,
-					const integral_t &max_time)
+template <typename Int>
+static Int get_largest_testpoint(const TaskSet &ts,
+				 const Int &max_time)
 {
-	integral_t point = 0;
+	Int point = 0;
 
 	for (unsigned int i = 0; i < ts.get_task_count(); i++)
 	{
 		unsigned long dl = ts[i].get_deadline();
 		if (dl < max_time)
 		{
-			integral_t max_dl = max_deadline(ts[i], max_time);
+			Int max_dl = max_deadline(ts[i], max_time);
 			if (max_dl == max_time)
 				max_dl -= ts[i].get_period();
 			if (max_dl > point)
@@ -139,6 +170,12 @@ static integral_t get_largest_testpoint(const TaskSet &ts,
 	return point;
 }
 
+static fixed_integral_t get_largest_testpoint(const DemandKernel &kernel,
+                                              const fixed_integral_t &max_time)
+{
+	return kernel.last_deadline_before(max_time);
+}
+
 integral_t QPATest::get_demand(integral_t interval, const TaskSet &ts)
 {
 	integral_t demand;
@@ -146,6 +183,12 @@ integral_t QPATest::get_demand(integral_t interval, const TaskSet &ts)
 	return demand;
 }
 
+fixed_integral_t QPATest::get_demand(fixed_integral_t interval,
+                                     const DemandKernel &kernel)
+{
+	return kernel.dbf(interval);
+}
+
 integral_t QPATest::get_max_interval(const TaskSet &ts, const fractional_t& util)
 {
 	integral_t max_interval = edf_busy_interval(ts);
@@ -171,25 +214,48 @@ bool QPATest::is_schedulable(const TaskSet &ts, bool check_preconditions)
 	if (util > 1)
 		return false;
 
+	integral_t max_interval = get_max_interval(ts, util);
 	unsigned long min_interval = min_relative_deadline(ts);
 
-	integral_t max_interval = get_max_interval(ts, util);
+	// Intervals and demands usually fit into 64 bits, and the kernel
+	// evaluates them for all tasks at once.
+	if (get_fixed_width_mode() != GMP_ONLY)
+	{
+		try
+		{
+			DemandKernel kernel(ts);
+			return check_test_points(kernel, min_interval,
+			                         fixed_integral_t(max_interval));
+		}
+		catch (const fixed_width_overflow &)
+		{
+			if (get_fixed_width_mode() == FIXED_WIDTH_ONLY)
+				throw;
+		}
+	}
+	return check_test_points(ts, min_interval, max_interval);
+}
 
-	integral_t next = get_largest_testpoint(ts, max_interval);
-	integral_t demand;
-	integral_t interval;
+template <typename Int, typename Demand>
+bool QPATest::check_test_points(const Demand &tasks,
+                                unsigned long min_interval,
+                                const Int &max_interval)
+{
+	Int next = get_largest_testpoint(tasks, max_interval);
+	Int demand;
+	Int interval;
 
 	do
 	{
 		interval = next;
 
 
-		demand = get_demand(interval,ts);
+		demand = get_demand(interval, tasks);
 
 		if (demand < interval)
 			next = demand;
 		else
-			next = get_largest_testpoint(ts, interval);
+			next = get_largest_testpoint(tasks, interval);
 
 	} while (demand <= interval && demand > min_interval);
 
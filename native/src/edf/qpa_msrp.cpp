@@ -35,6 +35,17 @@ integral_t QPA_MSRPTest::get_demand(integral_t interval, const TaskSet &ts)
 	return demand;
 }
 
+fixed_integral_t QPA_MSRPTest::get_demand(fixed_integral_t interval,
+                                          const DemandKernel &kernel)
+{
+	fixed_integral_t demand = QPATest::get_demand(interval, kernel);
+
+	if (interval <= max_relative_deadline)
+		demand += get_EDF_arrival_blocking(info, num_cpus, interval.get_ui(), cpu_id);
+
+	return demand;
+}
+
 integral_t QPA_MSRPTest::get_max_interval(const TaskSet &ts, const fractional_t& util)
 {
 	integral_t max_interval = QPATest::get_max_interval(ts, util);
@@ -6,6 +6,8 @@
 
 #include "edf/rta.h"
 
+#include "analysis_budget.h"
+
 #include <iostream>
 #include "task_io.h"
 
@@ -125,11 +127,15 @@ bool RTAGedf::is_schedulable(const TaskSet &ts, bool check_preconditions)
     for (unsigned int i = 0; i < ts.get_task_count(); i++)
         slack[i] = 0;
 
+    AnalysisBudget::Meter meter(budget);
+
     unsigned long round = 0;
     bool schedulable = false;
     bool updated     = true;
+    bool exhausted   = false;
 
-    while (updated && !schedulable && (max_rounds == 0 || round < max_rounds))
+    while (updated && !schedulable && !exhausted
+           && (max_rounds == 0 || round < max_rounds))
     {
         round++;
         schedulable = true;
@@ -137,6 +143,14 @@ bool RTAGedf::is_schedulable(const TaskSet &ts, bool check_preconditions)
         for (unsigned int k = 0; k < ts.get_task_count(); k++)
         {
             unsigned long response, new_slack;
+            if (meter.exhausted())
+            {
+                // Give up.
+                schedulable = false;
+                exhausted   = true;
+                break;
+            }
+            meter.charge();
             if (rta_fixpoint(k, ts, slack, response))
             {
                 new_slack = ts[k].get_deadline() - response;
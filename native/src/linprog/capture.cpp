@@ -0,0 +1,107 @@
+#include <stdio.h>
+
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#include "linprog/capture.h"
+#include "linprog/dispatch.h"
+#include "linprog/export.h"
+#include "linprog/stats.h"
+
+static thread_local LinearProgramOrigin current_origin;
+
+// capture_dir is only accessed with capture_lock held
+static std::atomic<bool> capture_enabled(false);
+static std::mutex capture_lock;
+static std::string capture_dir;
+
+// numbers the captured files in the order in which the LPs were solved
+static std::atomic<unsigned long> capture_seq(0);
+
+const LinearProgramOrigin& linprog_get_origin()
+{
+	return current_origin;
+}
+
+LinearProgramOriginScope::LinearProgramOriginScope(
+	const LinearProgramOrigin &origin)
+	: saved(current_origin)
+{
+	current_origin = origin;
+
+	if (!saved.analysis)
+		linprog_stats_begin_analysis();
+}
+
+LinearProgramOriginScope::~LinearProgramOriginScope()
+{
+	current_origin = saved;
+
+	if (!saved.analysis)
+		linprog_stats_end_analysis();
+}
+
+void set_lp_capture(const char *directory)
+{
+	std::lock_guard<std::mutex> guard(capture_lock);
+
+	if (directory && *directory)
+	{
+		capture_dir = directory;
+		capture_enabled = true;
+	}
+	else
+		capture_enabled = false;
+}
+
+void linprog_capture(const LinearProgram &lp, unsigned int num_vars)
+{
+	if (!capture_enabled)
+		return;
+
+	std::string dir;
+	{
+		std::lock_guard<std::mutex> guard(capture_lock);
+		dir = capture_dir;
+	}
+
+	const LinearProgramOrigin &origin = current_origin;
+	const char *analysis = origin.analysis ? origin.analysis : "unknown";
+
+	LinearProgramTags tags;
+	tags["analysis"] = analysis;
+	if (origin.task >= 0)
+	{
+		std::ostringstream task;
+		task << origin.task;
+		tags["task"] = task.str();
+	}
+	if (origin.interval >= 0)
+	{
+		std::ostringstream interval;
+		interval << origin.interval;
+		tags["interval"] = interval.str();
+	}
+
+	char seq[32];
+	snprintf(seq, sizeof(seq), "%08lu", capture_seq++);
+
+	std::ostringstream path;
+	path << dir << "/" << seq << "-" << analysis;
+	if (origin.task >= 0)
+		path << "-T" << origin.task;
+	if (origin.interval >= 0)
+		path << "-L" << tags["interval"];
+	path << ".mps";
+
+	// MPS, since that is what lpreplay reads back
+	std::ofstream out(path.str().c_str());
+	write_mps(out, lp, num_vars, tags);
+
+	if (!out)
+		std::cerr << "Could not capture LP to " << path.str() << std::endl;
+}
@@ -28,7 +28,7 @@ private:
         IloRangeArray make_constraints(const IloNumVarArray& vars);
 
 	IloRange make_constraint(const IloNumVarArray &vars,
-				 const LinearExpression *exp, double bound,
+				 const SparseRows &rows, unsigned int r,
 				 bool is_exact_bound);
 
 public:
@@ -167,26 +167,33 @@ IloRangeArray CPLEXSolution::make_constraints(const IloNumVarArray &vars)
 {
 	IloRangeArray constraints(get_env());
 
-	foreach (linprog.get_equalities(), exp)
-		constraints.add(make_constraint(vars, exp->first, exp->second, true));
+	const SparseRows &equ = linprog.get_equalities();
+	const SparseRows &inequ = linprog.get_inequalities();
 
-	foreach (linprog.get_inequalities(), exp)
-		constraints.add(make_constraint(vars, exp->first, exp->second, false));
+	for (unsigned int r = 0; r < equ.size(); r++)
+		constraints.add(make_constraint(vars, equ, r, true));
+
+	for (unsigned int r = 0; r < inequ.size(); r++)
+		constraints.add(make_constraint(vars, inequ, r, false));
 
 	return constraints;
 }
 
 IloRange CPLEXSolution::make_constraint(const IloNumVarArray &vars,
-					const LinearExpression *exp, double bound,
+					const SparseRows &rows, unsigned int row,
 					bool is_exact_bound)
 {
+	const double bound = rows.get_bound(row);
+	const int *row_vars = rows.get_row_vars(row);
+	const double *row_coeffs = rows.get_row_coeffs(row);
+
 	IloRange r = IloRange(get_env(), -IloInfinity, bound);
 
 	if (is_exact_bound)
 		r.setLB(bound);
 
-	foreach (exp->get_terms(), term)
-		r.setLinearCoef(vars[term->second], term->first);
+	for (unsigned int k = 0; k < rows.get_row_size(row); k++)
+		r.setLinearCoef(vars[row_vars[k]], row_coeffs[k]);
 
 	return r;
 }
@@ -16,7 +16,6 @@ private:
 	const LinearProgram &linprog;
 	const unsigned int num_cols;
 	const unsigned int num_rows;
-	unsigned int num_coeffs;
 
 	double *values;
 	bool solved;
@@ -24,8 +23,7 @@ private:
 	void solve_model(double var_lb, double var_ub);
 
 	bool setup_objective(double lb, double ub);
-	bool add_rows();
-	bool load_coeffs();
+	bool add_rows(const SparseRows &rows, char sense);
 	bool set_column_types();
 
 public:
@@ -50,9 +48,7 @@ CPXSolution::CPXSolution(const LinearProgram& lp, unsigned int max_num_vars,
 	  lp(0),
 	  linprog(lp),
 	  num_cols(max_num_vars),
-	  num_rows(lp.get_equalities().size() +
-		   lp.get_inequalities().size()),
-	  num_coeffs(0),
+	  num_rows(lp.get_num_rows()),
 	  values(0),
 	  solved(false)
 {
@@ -94,8 +90,8 @@ void CPXSolution::solve_model(double var_lb, double var_ub)
 
 	if (!setup_objective(var_lb, var_ub) ||
 	    !set_column_types() ||
-	    !add_rows() ||
-	    !load_coeffs())
+	    !add_rows(linprog.get_equalities(), 'E') ||
+	    !add_rows(linprog.get_inequalities(), 'L'))
 		return;
 
 
@@ -109,6 +105,12 @@ void CPXSolution::solve_model(double var_lb, double var_ub)
 	if (err != 0)
 		return;
 
+	if (linprog.has_integer_variables() ||
+		linprog.has_binary_variables())
+		linprog_stats_add_iterations(CPXgetmipitcnt(env, lp));
+	else
+		linprog_stats_add_iterations(CPXgetitcnt(env, lp));
+
 #if DEBUG_LP_OVERHEADS >= 3
 	solver_costs.stop();
 	extract_costs.start();
@@ -226,70 +228,30 @@ bool CPXSolution::set_column_types()
 	return true;
 }
 
-bool CPXSolution::add_rows()
+// The CSR arrays of the model are in exactly the format expected by
+// CPXaddrows(), so they are passed on without copying.
+bool CPXSolution::add_rows(const SparseRows &rows, char sense)
 {
-	double *bounds = new double[num_rows];
-	char   *senses = new char[num_rows];
 	int err;
 
-	unsigned int r = 0;
+	if (rows.empty())
+		return true;
 
-	foreach(linprog.get_equalities(), equ)
-	{
-		bounds[r] = equ->second;
-		senses[r] = 'E'; // equality constraint
+	char *senses = new char[rows.size()];
 
-		num_coeffs += equ->first->get_terms().size();
-		r++;
-	}
+	for (unsigned int r = 0; r < rows.size(); r++)
+		senses[r] = sense; // 'E': equality, 'L': less-than-or-equal
 
-	foreach(linprog.get_inequalities(), inequ)
-	{
-		bounds[r] = inequ->second;
-		senses[r] = 'L'; // less-than-or-equal constraint
-
-		num_coeffs += inequ->first->get_terms().size();
-		r++;
-	}
+	err = CPXaddrows(env, lp, 0, rows.size(), rows.get_num_coeffs(),
+	                 rows.get_bounds(), senses,
+	                 rows.get_row_begin(), rows.get_vars(),
+	                 rows.get_coeffs(), NULL, NULL);
 
-	err = CPXnewrows(env, lp, num_rows, bounds, senses, NULL, NULL);
-
-	delete [] bounds;
 	delete [] senses;
 
 	return err == 0;
 }
 
-bool CPXSolution::load_coeffs()
-{
-	unsigned int r = 0;
-	int err;
-
-	foreach(linprog.get_equalities(), equ)
-	{
-		foreach(equ->first->get_terms(), term)
-		{
-			err = CPXchgcoef(env, lp, r, term->second, term->first);
-			if (err != 0)
-				return false;
-		}
-		r++;
-	}
-
-	foreach(linprog.get_inequalities(), inequ)
-	{
-		foreach(inequ->first->get_terms(), term)
-		{
-			err = CPXchgcoef(env, lp, r, term->second, term->first);
-			if (err != 0)
-				return false;
-		}
-		r++;
-	}
-
-	return true;
-}
-
 Solution *cpx_solve(const LinearProgram& lp, unsigned int max_num_vars)
 {
 	CPXSolution *sol =  new CPXSolution(lp, max_num_vars);
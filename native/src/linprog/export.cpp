@@ -0,0 +1,646 @@
+#include <stdlib.h>
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+#include "stl-hashmap.h"
+
+#include "linprog/export.h"
+
+static const double INF = std::numeric_limits<double>::infinity();
+
+typedef std::pair<int, double> Entry;
+typedef std::vector<Entry> Entries;
+
+static bool entry_index_less(const Entry &a, const Entry &b)
+{
+	return a.first < b.first;
+}
+
+// sort entries by index and merge repeated indices
+static void merge_entries(Entries &entries)
+{
+	std::sort(entries.begin(), entries.end(), entry_index_less);
+
+	unsigned int end = 0;
+	for (unsigned int k = 0; k < entries.size(); k++)
+	{
+		if (end && entries[end - 1].first == entries[k].first)
+			entries[end - 1].second += entries[k].second;
+		else
+			entries[end++] = entries[k];
+	}
+	entries.resize(end);
+}
+
+// SparseRows drops zero coefficients, so a row may have no terms left.
+// Such a row gets the placeholder term 0 X0; otherwise, it would vanish
+// from the COLUMNS section (or be a syntax error in an LP file), and the
+// rows after it would be renumbered.
+static Entries get_row(const SparseRows &rows, unsigned int r,
+                       unsigned int num_vars)
+{
+	Entries row;
+	const int *vars = rows.get_row_vars(r);
+	const double *coeffs = rows.get_row_coeffs(r);
+
+	for (unsigned int k = 0; k < rows.get_row_size(r); k++)
+		row.push_back(Entry(vars[k], coeffs[k]));
+
+	merge_entries(row);
+
+	if (row.empty() && num_vars)
+		row.push_back(Entry(0, 0.0));
+
+	return row;
+}
+
+static Entries get_objective(const LinearProgram &lp)
+{
+	Entries obj;
+
+	foreach(lp.get_objective()->get_terms(), term)
+		obj.push_back(Entry(term->second, term->first));
+
+	merge_entries(obj);
+	return obj;
+}
+
+// same conventions as the solver back ends
+static void get_bounds(const LinearProgram &lp, unsigned int num_vars,
+                       std::vector<double> &lb, std::vector<double> &ub)
+{
+	lb.assign(num_vars, 0.0);
+	ub.assign(num_vars, 1.0);
+
+	foreach(lp.get_non_default_variable_ranges(), bnds)
+	{
+		lb[bnds->variable_id] = bnds->has_lower ? bnds->lower_bound : -INF;
+		ub[bnds->variable_id] = bnds->has_upper ? bnds->upper_bound : INF;
+	}
+
+	// integer variables are only bounded from below
+	foreach(lp.get_integer_variables(), var)
+	{
+		lb[*var] = 0.0;
+		ub[*var] = INF;
+	}
+
+	foreach(lp.get_binary_variables(), var)
+	{
+		lb[*var] = 0.0;
+		ub[*var] = 1.0;
+	}
+}
+
+static void write_tags(std::ostream &os, const char *prefix,
+                       const LinearProgramTags &tags)
+{
+	foreach(tags, tag)
+		os << prefix << " " << tag->first << ": " << tag->second << std::endl;
+}
+
+static std::string row_name(const LinearProgram &lp, int r)
+{
+	std::ostringstream name;
+
+	if (r < 0)
+		name << "OBJ";
+	else if ((unsigned int) r < lp.get_equalities().size())
+		name << "E" << r;
+	else
+		name << "L" << r - lp.get_equalities().size();
+
+	return name.str();
+}
+
+void write_mps(std::ostream &os, const LinearProgram &lp,
+               unsigned int num_vars, const LinearProgramTags &tags)
+{
+	const SparseRows &equalities = lp.get_equalities();
+	const SparseRows &inequalities = lp.get_inequalities();
+	const unsigned int num_eq = equalities.size();
+
+	// transpose: column j lists (row, coefficient), objective row is -1
+	std::vector<Entries> columns(num_vars);
+
+	const Entries obj = get_objective(lp);
+	foreach(obj, e)
+		if (e->second != 0.0)
+			columns[e->first].push_back(Entry(-1, e->second));
+
+	for (unsigned int r = 0; r < lp.get_num_rows(); r++)
+	{
+		const Entries row = r < num_eq ?
+			get_row(equalities, r, num_vars) :
+			get_row(inequalities, r - num_eq, num_vars);
+
+		foreach(row, e)
+			columns[e->first].push_back(Entry(r, e->second));
+	}
+
+	std::vector<double> lb, ub;
+	get_bounds(lp, num_vars, lb, ub);
+
+	std::streamsize old_precision =
+		os.precision(std::numeric_limits<double>::max_digits10);
+
+	write_tags(os, "*", tags);
+	os << "NAME" << std::endl;
+	os << "OBJSENSE" << std::endl << "    MAX" << std::endl;
+
+	os << "ROWS" << std::endl;
+	os << " N  OBJ" << std::endl;
+	for (unsigned int r = 0; r < lp.get_num_rows(); r++)
+		os << (r < num_eq ? " E  " : " L  ") << row_name(lp, r) << std::endl;
+
+	os << "COLUMNS" << std::endl;
+	bool in_int_block = false;
+	for (unsigned int j = 0; j < num_vars; j++)
+	{
+		bool is_int = lp.is_integer_variable(j) &&
+		              !lp.is_binary_variable(j);
+
+		if (is_int != in_int_block)
+		{
+			os << "    MARKER  'MARKER'  "
+			   << (is_int ? "'INTORG'" : "'INTEND'") << std::endl;
+			in_int_block = is_int;
+		}
+
+		// unused variables still need a column to keep the numbering
+		if (columns[j].empty())
+			os << "    X" << j << "  OBJ  0" << std::endl;
+
+		foreach(columns[j], e)
+			os << "    X" << j << "  " << row_name(lp, e->first)
+			   << "  " << e->second << std::endl;
+	}
+	if (in_int_block)
+		os << "    MARKER  'MARKER'  'INTEND'" << std::endl;
+
+	os << "RHS" << std::endl;
+	for (unsigned int r = 0; r < lp.get_num_rows(); r++)
+	{
+		double rhs = r < num_eq ?
+			equalities.get_bound(r) : inequalities.get_bound(r - num_eq);
+		if (rhs != 0.0)
+			os << "    RHS  " << row_name(lp, r) << "  " << rhs << std::endl;
+	}
+
+	// MPS defaults to [0, inf); integers inside markers may default to
+	// [0, 1] in some readers, so their upper bound is always given
+	os << "BOUNDS" << std::endl;
+	for (unsigned int j = 0; j < num_vars; j++)
+	{
+		if (lp.is_binary_variable(j))
+			os << " BV BND  X" << j << std::endl;
+		else if (lb[j] == -INF && ub[j] == INF)
+			os << " FR BND  X" << j << std::endl;
+		else if (lb[j] == ub[j])
+			os << " FX BND  X" << j << "  " << lb[j] << std::endl;
+		else
+		{
+			if (lb[j] == -INF)
+				os << " MI BND  X" << j << std::endl;
+			else if (lb[j] != 0.0 || ub[j] < 0.0)
+				os << " LO BND  X" << j << "  " << lb[j] << std::endl;
+
+			if (ub[j] < INF)
+				os << " UP BND  X" << j << "  " << ub[j] << std::endl;
+			else if (lp.is_integer_variable(j))
+				os << " PL BND  X" << j << std::endl;
+		}
+	}
+
+	os << "ENDATA" << std::endl;
+
+	os.precision(old_precision);
+}
+
+static void write_lp_terms(std::ostream &os, const Entries &terms)
+{
+	unsigned int count = 0;
+
+	foreach(terms, e)
+	{
+		// keep lines short; CPLEX limits them to 510 characters
+		if (count && count % 8 == 0)
+			os << std::endl << "   ";
+
+		if (e->second < 0)
+			os << " - " << -e->second;
+		else
+			os << " + " << e->second;
+		os << " X" << e->first;
+		count++;
+	}
+}
+
+static void write_lp_bound(std::ostream &os, double value)
+{
+	if (value == INF)
+		os << "+inf";
+	else if (value == -INF)
+		os << "-inf";
+	else
+		os << value;
+}
+
+void write_cplex_lp(std::ostream &os, const LinearProgram &lp,
+                    unsigned int num_vars, const LinearProgramTags &tags)
+{
+	const SparseRows &equalities = lp.get_equalities();
+	const SparseRows &inequalities = lp.get_inequalities();
+
+	std::vector<double> lb, ub;
+	get_bounds(lp, num_vars, lb, ub);
+
+	std::streamsize old_precision =
+		os.precision(std::numeric_limits<double>::max_digits10);
+
+	write_tags(os, "\\", tags);
+
+	os << "Maximize" << std::endl << " OBJ:";
+	Entries obj = get_objective(lp);
+	if (obj.empty() && num_vars)
+		obj.push_back(Entry(0, 0.0));
+	write_lp_terms(os, obj);
+	os << std::endl;
+
+	os << "Subject To" << std::endl;
+	for (unsigned int r = 0; r < equalities.size(); r++)
+	{
+		os << " E" << r << ":";
+		write_lp_terms(os, get_row(equalities, r, num_vars));
+		os << " = " << equalities.get_bound(r) << std::endl;
+	}
+	for (unsigned int r = 0; r < inequalities.size(); r++)
+	{
+		os << " L" << r << ":";
+		write_lp_terms(os, get_row(inequalities, r, num_vars));
+		os << " <= " << inequalities.get_bound(r) << std::endl;
+	}
+
+	os << "Bounds" << std::endl;
+	for (unsigned int j = 0; j < num_vars; j++)
+	{
+		if (lp.is_binary_variable(j) || lp.is_integer_variable(j))
+			continue;
+
+		if (lb[j] == -INF && ub[j] == INF)
+			os << " X" << j << " free" << std::endl;
+		else
+		{
+			os << " ";
+			write_lp_bound(os, lb[j]);
+			os << " <= X" << j << " <= ";
+			write_lp_bound(os, ub[j]);
+			os << std::endl;
+		}
+	}
+
+	// general integers default to [0, inf) in LP files
+	if (lp.has_integer_variables())
+	{
+		os << "Generals" << std::endl;
+		for (unsigned int j = 0; j < num_vars; j++)
+			if (lp.is_integer_variable(j) && !lp.is_binary_variable(j))
+				os << " X" << j << std::endl;
+	}
+
+	if (lp.has_binary_variables())
+	{
+		os << "Binaries" << std::endl;
+		for (unsigned int j = 0; j < num_vars; j++)
+			if (lp.is_binary_variable(j))
+				os << " X" << j << std::endl;
+	}
+
+	os << "End" << std::endl;
+
+	os.precision(old_precision);
+}
+
+// ------------------------------------------------------------------
+// ---------------------------[ M P S   I N ]------------------------
+// ------------------------------------------------------------------
+
+enum mps_section_t
+{
+	MPS_NONE,
+	MPS_OBJSENSE,
+	MPS_ROWS,
+	MPS_COLUMNS,
+	MPS_RHS,
+	MPS_BOUNDS,
+};
+
+struct MPSRow
+{
+	char type; // 'E', 'L', 'G', or 'N'
+	double rhs;
+	Entries entries;
+};
+
+struct MPSColumn
+{
+	double lb, ub;
+	bool is_integer, is_binary;
+};
+
+static bool parse_number(const std::string &token, double &value)
+{
+	char *end;
+	value = strtod(token.c_str(), &end);
+	return !token.empty() && *end == '\0';
+}
+
+LinearProgram *read_mps(std::istream &in, unsigned int &num_vars,
+                        std::string &error, LinearProgramTags *tags)
+{
+	std::vector<MPSRow> rows;
+	std::vector<MPSColumn> cols;
+	hashmap<std::string, unsigned int> row_index, col_index;
+	int objective_row = -1;
+	bool maximize = false;
+	bool in_int_block = false;
+
+	mps_section_t section = MPS_NONE;
+	std::string line;
+	unsigned int line_no = 0;
+
+	while (std::getline(in, line))
+	{
+		line_no++;
+
+		std::ostringstream where;
+		where << "line " << line_no << ": ";
+
+		if (!line.empty() && line[line.size() - 1] == '\r')
+			line.erase(line.size() - 1);
+
+		if (line.empty())
+			continue;
+
+		if (line[0] == '*')
+		{
+			size_t colon = line.find(':');
+			if (tags && colon != std::string::npos)
+			{
+				size_t key_start = line.find_first_not_of(" \t", 1);
+				size_t val_start = line.find_first_not_of(" \t", colon + 1);
+				if (key_start < colon)
+					(*tags)[line.substr(key_start, colon - key_start)] =
+						val_start == std::string::npos ?
+						"" : line.substr(val_start);
+			}
+			continue;
+		}
+
+		std::vector<std::string> tokens;
+		std::istringstream fields(line);
+		std::string token;
+		while (fields >> token)
+			tokens.push_back(token);
+
+		if (tokens.empty())
+			continue;
+
+		// section headers start in the first column
+		if (line[0] != ' ' && line[0] != '\t')
+		{
+			const std::string &name = tokens[0];
+
+			if (name == "NAME")
+				section = MPS_NONE;
+			else if (name == "OBJSENSE")
+			{
+				section = MPS_OBJSENSE;
+				if (tokens.size() > 1)
+					maximize = tokens[1] == "MAX" || tokens[1] == "MAXIMIZE";
+			}
+			else if (name == "ROWS")
+				section = MPS_ROWS;
+			else if (name == "COLUMNS")
+				section = MPS_COLUMNS;
+			else if (name == "RHS")
+				section = MPS_RHS;
+			else if (name == "BOUNDS")
+				section = MPS_BOUNDS;
+			else if (name == "ENDATA")
+				break;
+			else
+			{
+				error = where.str() + "unsupported section " + name;
+				return NULL;
+			}
+			continue;
+		}
+
+		switch (section)
+		{
+			case MPS_OBJSENSE:
+				maximize = tokens[0] == "MAX" || tokens[0] == "MAXIMIZE";
+				break;
+
+			case MPS_ROWS:
+			{
+				if (tokens.size() != 2 || tokens[0].size() != 1 ||
+				    std::string("ELGN").find(tokens[0][0]) == std::string::npos)
+				{
+					error = where.str() + "malformed row";
+					return NULL;
+				}
+
+				MPSRow row;
+				row.type = tokens[0][0];
+				row.rhs = 0;
+
+				// only the first objective row is used
+				if (row.type == 'N' && objective_row >= 0)
+					break;
+				if (row.type == 'N')
+					objective_row = rows.size();
+
+				row_index[tokens[1]] = rows.size();
+				rows.push_back(row);
+				break;
+			}
+
+			case MPS_COLUMNS:
+			{
+				if (tokens.size() == 3 && tokens[1] == "'MARKER'")
+				{
+					in_int_block = tokens[2] == "'INTORG'";
+					break;
+				}
+
+				if (tokens.size() != 3 && tokens.size() != 5)
+				{
+					error = where.str() + "malformed column entry";
+					return NULL;
+				}
+
+				unsigned int j;
+				if (col_index.find(tokens[0]) == col_index.end())
+				{
+					MPSColumn col;
+					col.lb = 0;
+					col.ub = INF;
+					col.is_integer = in_int_block;
+					col.is_binary = false;
+
+					j = cols.size();
+					col_index[tokens[0]] = j;
+					cols.push_back(col);
+				}
+				else
+					j = col_index[tokens[0]];
+
+				for (unsigned int k = 1; k + 1 < tokens.size(); k += 2)
+				{
+					double value;
+					if (!parse_number(tokens[k + 1], value))
+					{
+						error = where.str() + "bad coefficient " + tokens[k + 1];
+						return NULL;
+					}
+
+					if (row_index.find(tokens[k]) == row_index.end())
+						// entries of ignored objective rows
+						continue;
+
+					rows[row_index[tokens[k]]].entries.push_back(Entry(j, value));
+				}
+				break;
+			}
+
+			case MPS_RHS:
+			{
+				// the name of the RHS vector is optional
+				unsigned int first = tokens.size() % 2;
+
+				for (unsigned int k = first; k + 1 < tokens.size(); k += 2)
+				{
+					double value;
+					if (!parse_number(tokens[k + 1], value))
+					{
+						error = where.str() + "bad right-hand side " + tokens[k + 1];
+						return NULL;
+					}
+
+					if (row_index.find(tokens[k]) == row_index.end())
+						continue;
+
+					rows[row_index[tokens[k]]].rhs = value;
+				}
+				break;
+			}
+
+			case MPS_BOUNDS:
+			{
+				const std::string &type = tokens[0];
+				bool has_value = type == "UP" || type == "LO" || type == "FX" ||
+				                 type == "UI" || type == "LI";
+
+				// the name of the bound vector is optional
+				unsigned int name_pos = tokens.size() - (has_value ? 2 : 1);
+				if (name_pos < 1 || name_pos > 2)
+				{
+					error = where.str() + "malformed bound";
+					return NULL;
+				}
+
+				if (col_index.find(tokens[name_pos]) == col_index.end())
+				{
+					error = where.str() + "bound for unknown column " + tokens[name_pos];
+					return NULL;
+				}
+				MPSColumn &col = cols[col_index[tokens[name_pos]]];
+
+				double value = 0;
+				if (has_value && !parse_number(tokens[name_pos + 1], value))
+				{
+					error = where.str() + "bad bound " + tokens[name_pos + 1];
+					return NULL;
+				}
+
+				if (type == "UP" || type == "UI")
+					col.ub = value;
+				else if (type == "LO" || type == "LI")
+					col.lb = value;
+				else if (type == "FX")
+					col.lb = col.ub = value;
+				else if (type == "FR")
+				{
+					col.lb = -INF;
+					col.ub = INF;
+				}
+				else if (type == "MI")
+					col.lb = -INF;
+				else if (type == "PL")
+					col.ub = INF;
+				else if (type == "BV")
+					col.is_binary = true;
+				else
+				{
+					error = where.str() + "unsupported bound type " + type;
+					return NULL;
+				}
+
+				if (type == "UI" || type == "LI")
+					col.is_integer = true;
+				break;
+			}
+
+			default:
+				error = where.str() + "data outside of a section";
+				return NULL;
+		}
+	}
+
+	LinearProgram *lp = new LinearProgram();
+	num_vars = cols.size();
+
+	if (objective_row >= 0)
+	{
+		LinearExpression *obj = lp->get_objective();
+		foreach(rows[objective_row].entries, e)
+			obj->add_term(maximize ? e->second : -e->second, e->first);
+	}
+
+	foreach(rows, row)
+	{
+		if (row->type == 'N')
+			continue;
+
+		LinearExpression *exp = new LinearExpression();
+		double sign = row->type == 'G' ? -1 : 1;
+
+		foreach(row->entries, e)
+			exp->add_term(sign * e->second, e->first);
+
+		if (row->type == 'E')
+			lp->add_equality(exp, row->rhs);
+		else
+			lp->add_inequality(exp, sign * row->rhs);
+	}
+
+	for (unsigned int j = 0; j < cols.size(); j++)
+	{
+		const MPSColumn &col = cols[j];
+
+		if (col.is_binary)
+			lp->declare_variable_binary(j);
+		else if (col.is_integer)
+			lp->declare_variable_integer(j);
+		else if (col.lb != 0.0 || col.ub != 1.0)
+			lp->declare_variable_bounds(j, col.lb > -INF, col.lb,
+			                            col.ub < INF, col.ub);
+	}
+
+	return lp;
+}
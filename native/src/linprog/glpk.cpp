@@ -3,11 +3,23 @@
 #include <stdlib.h>
 
 #include <iostream>
+#include <vector>
 
 #include "cpu_time.h"
 
 #include "linprog/glpk.h"
 
+// Simplex iterations performed so far on the problem object. Older GLPK
+// versions do not export the counter; their iterations are not reported.
+static int get_iteration_count(glp_prob *glpk)
+{
+#if GLP_MAJOR_VERSION > 4 || (GLP_MAJOR_VERSION == 4 && GLP_MINOR_VERSION >= 65)
+	return glp_get_it_cnt(glpk);
+#else
+	return 0;
+#endif
+}
+
 class GLPKSolution : public Solution
 {
 private:
@@ -54,9 +66,9 @@ GLPKSolution::GLPKSolution(const LinearProgram& lp, unsigned int max_num_vars,
 	: glpk(glp_create_prob()),
 	  linprog(lp),
 	  num_cols(max_num_vars),
-	  num_rows(lp.get_equalities().size() +
-		   lp.get_inequalities().size()),
-	  num_coeffs(0),
+	  num_rows(lp.get_num_rows()),
+	  num_coeffs(lp.get_equalities().get_num_coeffs() +
+		     lp.get_inequalities().get_num_coeffs()),
 	  is_mip(lp.has_binary_variables() || lp.has_integer_variables()),
 	  solved(false)
 {
@@ -99,6 +111,8 @@ void GLPKSolution::solve(double var_lb, double var_ub)
 	solver_costs.start();
 #endif
 
+	const int start_iterations = get_iteration_count(glpk);
+
 	if (is_mip)
 	{
 		glp_iocp glpk_params;
@@ -133,6 +147,8 @@ void GLPKSolution::solve(double var_lb, double var_ub)
 			glp_get_status(glpk) == GLP_OPT;
 	}
 
+	linprog_stats_add_iterations(get_iteration_count(glpk) - start_iterations);
+
 #if DEBUG_LP_OVERHEADS >= 3
 	solver_costs.stop();
 
@@ -158,23 +174,18 @@ void GLPKSolution::set_objective()
 
 void GLPKSolution::set_bounds(double col_lb, double col_ub)
 {
+	const SparseRows &equ = linprog.get_equalities();
+	const SparseRows &inequ = linprog.get_inequalities();
+
 	unsigned int r = 1;
 
-	foreach(linprog.get_equalities(), equ)
-	{
+	for (unsigned int i = 0; i < equ.size(); i++)
 		glp_set_row_bnds(glpk, r++, GLP_FX,
-				 equ->second, equ->second);
-
-	        num_coeffs += equ->first->get_terms().size();
-	}
+				 equ.get_bound(i), equ.get_bound(i));
 
-	foreach(linprog.get_inequalities(), inequ)
-	{
+	for (unsigned int i = 0; i < inequ.size(); i++)
 		glp_set_row_bnds(glpk, r++, GLP_UP,
-				 0, inequ->second);
-
-		num_coeffs += inequ->first->get_terms().size();
-	}
+				 0, inequ.get_bound(i));
 
 	for (unsigned int c = 1; c <= num_cols; c++)
 		glp_set_col_bnds(glpk, c, GLP_DB, col_lb, col_ub);
@@ -199,47 +210,47 @@ void GLPKSolution::set_bounds(double col_lb, double col_ub)
 	}
 }
 
-void GLPKSolution::set_coefficients()
+// GLPK expects 1-based row and column numbers, so the CSR arrays are
+// translated into its (1-based) triplet format in one sequential pass.
+static unsigned int copy_coefficients(const SparseRows &rows,
+				      unsigned int r, unsigned int k,
+				      int *row_idx, int *col_idx, double *coeff)
 {
-	int *row_idx, *col_idx;
-	double *coeff;
-
-	row_idx = new int[1 + num_coeffs];
-	col_idx = new int[1 + num_coeffs];
-	coeff   = new double[1 + num_coeffs];
-
-	unsigned int r = 1, k = 1;
+	const int *row_begin = rows.get_row_begin();
+	const int *vars      = rows.get_vars();
+	const double *vals   = rows.get_coeffs();
 
-	foreach(linprog.get_equalities(), equ)
+	for (unsigned int i = 0; i < rows.size(); i++, r++)
 	{
-		foreach(equ->first->get_terms(), term)
+		for (int j = row_begin[i]; j < row_begin[i + 1]; j++, k++)
 		{
-			assert(k <= num_coeffs);
-
 			row_idx[k] = r;
-			col_idx[k] = 1 + term->second;
-			coeff[k]   = term->first;
-
-			k += 1;
+			col_idx[k] = 1 + vars[j];
+			coeff[k]   = vals[j];
 		}
-		r += 1;
 	}
 
+	return k;
+}
 
-	foreach(linprog.get_inequalities(), inequ)
-	{
-		foreach(inequ->first->get_terms(), term)
-		{
-			assert(k <= num_coeffs);
+void GLPKSolution::set_coefficients()
+{
+	int *row_idx, *col_idx;
+	double *coeff;
 
-			row_idx[k] = r;
-			col_idx[k] = 1 + term->second;
-			coeff[k]   = term->first;
+	row_idx = new int[1 + num_coeffs];
+	col_idx = new int[1 + num_coeffs];
+	coeff   = new double[1 + num_coeffs];
 
-			k += 1;
-		}
-		r += 1;
-	}
+	const SparseRows &equ = linprog.get_equalities();
+	unsigned int k;
+
+	k = copy_coefficients(equ, 1, 1,
+			      row_idx, col_idx, coeff);
+	k = copy_coefficients(linprog.get_inequalities(), 1 + equ.size(), k,
+			      row_idx, col_idx, coeff);
+
+	assert(k == 1 + num_coeffs);
 
 	glp_load_matrix(glpk, num_coeffs, row_idx, col_idx, coeff);
 
@@ -352,3 +363,388 @@ Solution *glpk_solve(const LinearProgram& lp, unsigned int max_num_vars)
 		return NULL;
 	}
 }
+
+// ------------------------------------------------------------------
+// ----------------------[ S E S S I O N S ]-------------------------
+// ------------------------------------------------------------------
+
+class GLPKSessionSolution : public Solution
+{
+private:
+	std::vector<double> values;
+
+public:
+	GLPKSessionSolution(unsigned int num_cols)
+		: values(num_cols, 0.0)
+	{}
+
+	void set_value(unsigned int var, double val)
+	{
+		values[var] = val;
+	}
+
+	double get_value(unsigned int var) const
+	{
+		return values[var];
+	}
+};
+
+class GLPKSession : public LinearProgramSession
+{
+private:
+	struct Column
+	{
+		int kind;
+		int type;
+		double lb, ub;
+
+		bool operator!=(const Column &other) const
+		{
+			return kind != other.kind || type != other.type ||
+			       lb != other.lb || ub != other.ub;
+		}
+	};
+
+	glp_prob *glpk;
+
+	unsigned int num_cols;
+
+	// Mirror of what has been loaded into the GLPK problem so far,
+	// used to determine which parts of the model actually changed.
+	SparseRows equalities, inequalities;
+	std::vector<Column> cols;
+	std::vector<double> obj;
+
+	// Is the basis stored in the GLPK problem an optimal basis
+	// of the previously solved LP?
+	bool have_basis;
+
+	// scratch space for glp_set_mat_row()
+	std::vector<int> row_idx;
+	std::vector<double> row_coeff;
+
+	void reset(unsigned int max_num_vars);
+
+	void update_objective(const LinearProgram &lp);
+	void update_columns(const LinearProgram &lp);
+	void update_rows(const LinearProgram &lp);
+	void update_row(unsigned int r, int type,
+	                const SparseRows &rows, unsigned int i);
+
+	bool solve_relaxation(bool warm);
+	bool solve_model(bool is_mip, bool warm);
+
+public:
+	GLPKSession() : glpk(glp_create_prob()), num_cols(0), have_basis(false)
+	{
+		glp_term_out(GLP_OFF);
+		glp_set_obj_dir(glpk, GLP_MAX);
+	}
+
+	~GLPKSession()
+	{
+		glp_delete_prob(glpk);
+	}
+
+	Solution *solve(const LinearProgram& lp, unsigned int max_num_vars);
+};
+
+void GLPKSession::reset(unsigned int max_num_vars)
+{
+	glp_erase_prob(glpk);
+	glp_set_obj_dir(glpk, GLP_MAX);
+
+	num_cols = max_num_vars;
+	equalities = SparseRows();
+	inequalities = SparseRows();
+	cols.clear();
+	obj.assign(num_cols, 0.0);
+
+	if (num_cols)
+		glp_add_cols(glpk, num_cols);
+
+	// As in GLPKSolution, all columns are bounded by [0, 1] by default.
+	Column dflt;
+	dflt.kind = GLP_CV;
+	dflt.type = GLP_DB;
+	dflt.lb   = 0.0;
+	dflt.ub   = 1.0;
+	cols.assign(num_cols, dflt);
+
+	for (unsigned int c = 1; c <= num_cols; c++)
+		glp_set_col_bnds(glpk, c, GLP_DB, 0.0, 1.0);
+
+	have_basis = false;
+}
+
+void GLPKSession::update_objective(const LinearProgram &lp)
+{
+	std::vector<double> new_obj(num_cols, 0.0);
+
+	assert(lp.get_objective()->get_terms().size() <= num_cols);
+
+	foreach (lp.get_objective()->get_terms(), term)
+		new_obj[term->second] = term->first;
+
+	for (unsigned int c = 0; c < num_cols; c++)
+		if (new_obj[c] != obj[c])
+			glp_set_obj_coef(glpk, c + 1, new_obj[c]);
+
+	obj.swap(new_obj);
+}
+
+void GLPKSession::update_columns(const LinearProgram &lp)
+{
+	Column dflt;
+	dflt.kind = GLP_CV;
+	dflt.type = GLP_DB;
+	dflt.lb   = 0.0;
+	dflt.ub   = 1.0;
+
+	std::vector<Column> new_cols(num_cols, dflt);
+
+	// Same precedence as GLPKSolution::set_bounds() and
+	// GLPKSolution::set_column_types().
+	foreach(lp.get_non_default_variable_ranges(), bnds)
+	{
+		Column &col = new_cols[bnds->variable_id];
+
+		col.lb = bnds->lower_bound;
+		col.ub = bnds->upper_bound;
+
+		if (bnds->has_upper && bnds->has_lower)
+			col.type = GLP_DB;
+		else if (!bnds->has_upper && !bnds->has_lower)
+			col.type = GLP_FR;
+		else if (bnds->has_upper)
+			col.type = GLP_UP;
+		else
+			col.type = GLP_LO;
+	}
+
+	foreach(lp.get_integer_variables(), var_id)
+	{
+		Column &col = new_cols[*var_id];
+		// hack: for integer variables, ignore upper bound for now
+		col.kind = GLP_IV;
+		col.type = GLP_LO;
+		col.lb   = 0.0;
+		col.ub   = 0.0;
+	}
+
+	foreach(lp.get_binary_variables(), var_id)
+	{
+		Column &col = new_cols[*var_id];
+		// glp_set_col_kind() implicitly bounds binaries by [0, 1]
+		col.kind = GLP_BV;
+		col.type = GLP_DB;
+		col.lb   = 0.0;
+		col.ub   = 1.0;
+	}
+
+	for (unsigned int c = 0; c < num_cols; c++)
+	{
+		if (new_cols[c] != cols[c])
+		{
+			glp_set_col_kind(glpk, c + 1, new_cols[c].kind);
+			if (new_cols[c].kind != GLP_BV)
+				glp_set_col_bnds(glpk, c + 1, new_cols[c].type,
+				                 new_cols[c].lb, new_cols[c].ub);
+		}
+	}
+
+	cols.swap(new_cols);
+}
+
+void GLPKSession::update_row(unsigned int r, int type,
+                             const SparseRows &rows, unsigned int i)
+{
+	const unsigned int old_num_equ = equalities.size();
+	const unsigned int old_num_rows = old_num_equ + inequalities.size();
+
+	bool same_bound = false, same_coeffs = false;
+
+	// compare with row r as it was loaded for the previous LP
+	if (r < old_num_rows)
+	{
+		const bool was_equ = r < old_num_equ;
+		const SparseRows &old = was_equ ? equalities : inequalities;
+		const unsigned int old_i = was_equ ? r : r - old_num_equ;
+
+		same_bound = (type == GLP_FX) == was_equ &&
+		             rows.get_bound(i) == old.get_bound(old_i);
+		same_coeffs = rows.row_equals(i, old, old_i);
+	}
+
+	if (!same_bound)
+	{
+		if (type == GLP_FX)
+			glp_set_row_bnds(glpk, r + 1, GLP_FX,
+			                 rows.get_bound(i), rows.get_bound(i));
+		else
+			glp_set_row_bnds(glpk, r + 1, GLP_UP, 0, rows.get_bound(i));
+	}
+
+	if (!same_coeffs)
+	{
+		const unsigned int n = rows.get_row_size(i);
+		const int *vars = rows.get_row_vars(i);
+		const double *vals = rows.get_row_coeffs(i);
+
+		// glp_set_mat_row() expects 1-based arrays of column numbers
+		row_idx.resize(1 + n);
+		row_coeff.resize(1 + n);
+
+		for (unsigned int k = 0; k < n; k++)
+		{
+			row_idx[k + 1]   = 1 + vars[k];
+			row_coeff[k + 1] = vals[k];
+		}
+
+		glp_set_mat_row(glpk, r + 1, n, &row_idx[0], &row_coeff[0]);
+	}
+}
+
+void GLPKSession::update_rows(const LinearProgram &lp)
+{
+	const SparseRows &equ = lp.get_equalities();
+	const SparseRows &inequ = lp.get_inequalities();
+
+	const unsigned int num_rows = lp.get_num_rows();
+	const unsigned int old_num_rows = equalities.size() + inequalities.size();
+
+	if (num_rows > old_num_rows)
+		glp_add_rows(glpk, num_rows - old_num_rows);
+	else if (num_rows < old_num_rows)
+	{
+		// glp_del_rows() expects a 1-based array of row numbers
+		std::vector<int> dropped(1 + old_num_rows - num_rows);
+		for (unsigned int r = num_rows; r < old_num_rows; r++)
+			dropped[1 + r - num_rows] = r + 1;
+
+		glp_del_rows(glpk, old_num_rows - num_rows, &dropped[0]);
+	}
+
+	unsigned int r = 0;
+
+	for (unsigned int i = 0; i < equ.size(); i++)
+		update_row(r++, GLP_FX, equ, i);
+
+	for (unsigned int i = 0; i < inequ.size(); i++)
+		update_row(r++, GLP_UP, inequ, i);
+
+	equalities = equ;
+	inequalities = inequ;
+}
+
+bool GLPKSession::solve_relaxation(bool warm)
+{
+	glp_smcp glpk_params;
+
+	glp_init_smcp(&glpk_params);
+
+	// Without a usable basis, fall back to the same settings as
+	// GLPKSolution. The presolver discards the basis, though, so
+	// it must be disabled to warm-start from the previous optimum.
+	glpk_params.presolve = warm ? GLP_OFF : GLP_ON;
+	glpk_params.pricing  = GLP_PT_STD;
+	glpk_params.r_test   = GLP_RT_STD;
+
+	const int start_iterations = get_iteration_count(glpk);
+	int simplex_code = glp_simplex(glpk, &glpk_params);
+	linprog_stats_add_iterations(get_iteration_count(glpk) - start_iterations);
+
+	return simplex_code == 0 && glp_get_status(glpk) == GLP_OPT;
+}
+
+bool GLPKSession::solve_model(bool is_mip, bool warm)
+{
+	if (!solve_relaxation(warm))
+		return false;
+
+	if (is_mip)
+	{
+		glp_iocp glpk_params;
+
+		glp_init_iocp(&glpk_params);
+
+		// The problem object now holds an optimal solution to
+		// the relaxed LP, so the presolver is not required.
+		glpk_params.presolve = GLP_OFF;
+
+		return glp_intopt(glpk, &glpk_params) == 0 &&
+		       glp_mip_status(glpk) == GLP_OPT;
+	}
+
+	return true;
+}
+
+Solution *GLPKSession::solve(const LinearProgram& lp, unsigned int max_num_vars)
+{
+#if DEBUG_LP_OVERHEADS >= 3
+	static DEFINE_CPU_CLOCK(model_costs);
+	static DEFINE_CPU_CLOCK(solver_costs);
+
+	model_costs.start();
+#endif
+
+	const bool is_mip = lp.has_binary_variables() ||
+	                    lp.has_integer_variables();
+
+	// Trivial case: no variables.
+	if (!max_num_vars)
+		return new GLPKSessionSolution(0);
+
+	// A different number of columns means a different LP altogether.
+	if (max_num_vars != num_cols)
+		reset(max_num_vars);
+
+	update_objective(lp);
+	update_columns(lp);
+	update_rows(lp);
+
+#if DEBUG_LP_OVERHEADS >= 3
+	model_costs.stop();
+	solver_costs.start();
+#endif
+
+	bool solved = solve_model(is_mip, have_basis);
+
+	// The warm start can fail if the updates invalidated the basis
+	// (e.g., if non-basic rows were deleted). Retry from scratch.
+	if (!solved && have_basis)
+	{
+		glp_std_basis(glpk);
+		solved = solve_model(is_mip, false);
+	}
+
+	have_basis = solved;
+
+#if DEBUG_LP_OVERHEADS >= 3
+	solver_costs.stop();
+
+	std::cout << model_costs << std::endl
+		  << solver_costs << std::endl;
+#endif
+
+	if (!solved)
+		return NULL;
+
+	GLPKSessionSolution *sol = new GLPKSessionSolution(num_cols);
+
+	for (unsigned int c = 0; c < num_cols; c++)
+		sol->set_value(c, is_mip ? glp_mip_col_val(glpk, c + 1)
+		                         : glp_get_col_prim(glpk, c + 1));
+
+	return sol;
+}
+
+LinearProgramSession *glpk_create_session()
+{
+	return new GLPKSession();
+}
+
+void glpk_release_thread_state()
+{
+	glp_free_env();
+}
@@ -1,58 +1,110 @@
 #include <iostream>
+#include <vector>
 
 #include "stl-hashmap.h"
 
 #include "linprog/solver.h"
 #include "linprog/io.h"
 
-std::ostream& pretty_print_linear_expression(
+static std::ostream& pretty_print_terms(
 	std::ostream &os,
-	const LinearExpression &exp,
+	unsigned int num_terms,
+	const int *vars,
+	const double *coeffs,
 	hashmap<unsigned int, std::string> &var_names,
 	const Solution *solution,
 	bool skip_zero_vars)
 {
 	bool first = true;
+	double sum = 0;
 
-#ifdef DEBUG
-	std::string desc = exp.get_debug_description();
-	if (!desc.empty())
-		os << desc << ": ";
-#endif
-
-	foreach (exp.get_terms(), term)
+	for (unsigned int k = 0; k < num_terms; k++)
 	{
-		if (skip_zero_vars && solution && !solution->get_value(term->second))
+		const double coeff = coeffs[k];
+		const unsigned int var = vars[k];
+
+		if (solution)
+			sum += coeff * solution->get_value(var);
+
+		if (skip_zero_vars && solution && !solution->get_value(var))
 			continue;
 
-		if (term->first == -1)
+		if (coeff == -1)
 			os << "- ";
-		else if (term->first < 0)
-			os << "- " << -term->first << " ";
-		else if (!first && term->first == 1)
+		else if (coeff < 0)
+			os << "- " << -coeff << " ";
+		else if (!first && coeff == 1)
 			os << "+ ";
 		else if (!first)
-			os << "+ " << term->first << " ";
-		else if (term->first != 1)
-			os << term->first << " ";
+			os << "+ " << coeff << " ";
+		else if (coeff != 1)
+			os << coeff << " ";
 
-		if (var_names.find(term->second) != var_names.end())
-			os << var_names[term->second] << " ";
+		if (var_names.find(var) != var_names.end())
+			os << var_names[var] << " ";
 		else
-			os <<  "X" << term->second << " ";
+			os <<  "X" << var << " ";
 
 		if (solution)
-			os << "(=" << solution->get_value(term->second) << ") ";
+			os << "(=" << solution->get_value(var) << ") ";
 
 		first = false;
 	}
 
 	if (solution && !first)
-		os << "{=" << solution->evaluate(exp) << "} ";
+		os << "{=" << sum << "} ";
 
 	return os;
 }
 
+std::ostream& pretty_print_linear_expression(
+	std::ostream &os,
+	const LinearExpression &exp,
+	hashmap<unsigned int, std::string> &var_names,
+	const Solution *solution,
+	bool skip_zero_vars)
+{
+#ifdef DEBUG
+	std::string desc = exp.get_debug_description();
+	if (!desc.empty())
+		os << desc << ": ";
+#endif
+
+	std::vector<int> vars;
+	std::vector<double> coeffs;
+
+	foreach (exp.get_terms(), term)
+	{
+		coeffs.push_back(term->first);
+		vars.push_back(term->second);
+	}
+
+	return pretty_print_terms(os, vars.size(), vars.data(), coeffs.data(),
+	                          var_names, solution, skip_zero_vars);
+}
+
+static void pretty_print_rows(
+	std::ostream &os,
+	const SparseRows &rows,
+	const char *relation,
+	hashmap<unsigned int, std::string> &var_names,
+	const Solution *solution,
+	bool skip_zero_vars)
+{
+	for (unsigned int r = 0; r < rows.size(); r++)
+	{
+#ifdef DEBUG
+		const std::string &desc = rows.get_debug_description(r);
+		if (!desc.empty())
+			os << desc << ": ";
+#endif
+		pretty_print_terms(os, rows.get_row_size(r),
+		                   rows.get_row_vars(r), rows.get_row_coeffs(r),
+		                   var_names, solution, skip_zero_vars);
+		os << " " << relation << " " << rows.get_bound(r) << std::endl;
+	}
+}
+
 std::ostream& operator<<(std::ostream &os, const LinearExpression &exp)
 {
 	hashmap<unsigned int, std::string> dummy_map;
@@ -70,18 +122,10 @@ std::ostream& pretty_print_linear_program(
 	pretty_print_linear_expression(os, *lp.get_objective(), var_names,
 	                               solution, skip_zero_vars);
 	os << " subject to:" << std::endl;
-	foreach (lp.get_equalities(), it)
-	{
-		pretty_print_linear_expression(os, *(it->first), var_names,
-	                                   solution, skip_zero_vars);
-		os << " = " << it->second << std::endl;
-	}
-	foreach (lp.get_inequalities(), it)
-	{
-		pretty_print_linear_expression(os, *(it->first), var_names,
-	                                   solution, skip_zero_vars);
-		os << " <= " << it->second << std::endl;
-	}
+	pretty_print_rows(os, lp.get_equalities(), "=", var_names,
+	                  solution, skip_zero_vars);
+	pretty_print_rows(os, lp.get_inequalities(), "<=", var_names,
+	                  solution, skip_zero_vars);
 
 	return os;
 }
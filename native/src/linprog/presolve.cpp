@@ -0,0 +1,448 @@
+#include <assert.h>
+#include <math.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "stl-hashmap.h"
+
+#include "linprog/presolve.h"
+#include "linprog/solver.h"
+
+static const double INF = std::numeric_limits<double>::infinity();
+
+// absolute tolerance for bound and right-hand side comparisons
+static const double TOL = 1e-9;
+
+class PresolvedSolution : public Solution
+{
+private:
+	std::vector<double> values;
+
+public:
+	PresolvedSolution(std::vector<double> &vals)
+	{
+		values.swap(vals);
+	}
+
+	double get_value(unsigned int var) const
+	{
+		assert(var < values.size());
+		return values[var];
+	}
+};
+
+static bool entry_var_less(const std::pair<int, double> &a,
+                           const std::pair<int, double> &b)
+{
+	return a.first < b.first;
+}
+
+PresolvedLinearProgram::PresolvedLinearProgram(const LinearProgram &lp,
+                                               unsigned int num_vars)
+	: num_vars(num_vars),
+	  cost(num_vars, 0.0),
+	  lb(num_vars, 0.0),
+	  ub(num_vars, 1.0),
+	  is_integral(num_vars, false),
+	  is_binary(num_vars, false),
+	  is_fixed(num_vars, false),
+	  value(num_vars, 0.0),
+	  reduced_index(num_vars, -1),
+	  num_reduced_vars(0),
+	  infeasible(false)
+{
+	load_rows(lp.get_equalities(), true);
+	load_rows(lp.get_inequalities(), false);
+
+	foreach(lp.get_objective()->get_terms(), term)
+	{
+		assert(term->second < num_vars);
+		cost[term->second] += term->first;
+	}
+
+	load_bounds(lp);
+
+	for (unsigned int j = 0; j < num_vars && !infeasible; j++)
+		if (lb[j] > ub[j])
+			infeasible = true;
+		else if (lb[j] == ub[j])
+			fix(j, lb[j]);
+
+	// iterate until no row changes anymore
+	bool changed = !infeasible;
+	while (changed)
+	{
+		changed = false;
+
+		for (unsigned int r = 0; r < rhs.size() && !infeasible; r++)
+		{
+			if (!row_active[r])
+				continue;
+
+			changed |= substitute_fixed(r);
+
+			const unsigned int size = row_end[r] - row_begin[r];
+
+			if (!size)
+			{
+				// 0 <= b or 0 == b
+				if (rhs[r] < -TOL || (is_equality[r] && rhs[r] > TOL))
+					infeasible = true;
+				row_active[r] = false;
+				changed = true;
+			}
+			else if (size == 1)
+				changed |= apply_singleton(r);
+			else if (is_redundant(r))
+			{
+				row_active[r] = false;
+				changed = true;
+			}
+		}
+
+		changed &= !infeasible;
+	}
+
+	if (!infeasible && !merge_duplicate_rows())
+		infeasible = true;
+
+	if (!infeasible)
+		build_reduced();
+}
+
+// copy rows into the working set with their terms sorted by variable and
+// repeated variables merged
+void PresolvedLinearProgram::load_rows(const SparseRows &rows, bool equality)
+{
+	for (unsigned int r = 0; r < rows.size(); r++)
+	{
+		const int *vars = rows.get_row_vars(r);
+		const double *coeffs = rows.get_row_coeffs(r);
+		const unsigned int begin = entries.size();
+
+		for (unsigned int k = 0; k < rows.get_row_size(r); k++)
+		{
+			assert((unsigned int) vars[k] < num_vars);
+			entries.push_back(Entry(vars[k], coeffs[k]));
+		}
+
+		std::sort(entries.begin() + begin, entries.end(), entry_var_less);
+
+		unsigned int end = begin;
+		for (unsigned int k = begin; k < entries.size(); k++)
+		{
+			if (end > begin && entries[end - 1].first == entries[k].first)
+				entries[end - 1].second += entries[k].second;
+			else
+				entries[end++] = entries[k];
+		}
+
+		// drop terms that cancelled out
+		unsigned int kept = begin;
+		for (unsigned int k = begin; k < end; k++)
+			if (entries[k].second != 0.0)
+				entries[kept++] = entries[k];
+		entries.resize(kept);
+
+		row_begin.push_back(begin);
+		row_end.push_back(kept);
+		rhs.push_back(rows.get_bound(r));
+		is_equality.push_back(equality);
+		row_active.push_back(true);
+	}
+}
+
+// same conventions as the solver back ends
+void PresolvedLinearProgram::load_bounds(const LinearProgram &lp)
+{
+	foreach(lp.get_non_default_variable_ranges(), bnds)
+	{
+		lb[bnds->variable_id] = bnds->has_lower ? bnds->lower_bound : -INF;
+		ub[bnds->variable_id] = bnds->has_upper ? bnds->upper_bound : INF;
+	}
+
+	// integer variables are only bounded from below
+	foreach(lp.get_integer_variables(), var)
+	{
+		lb[*var] = 0.0;
+		ub[*var] = INF;
+		is_integral[*var] = true;
+	}
+
+	foreach(lp.get_binary_variables(), var)
+	{
+		lb[*var] = 0.0;
+		ub[*var] = 1.0;
+		is_integral[*var] = true;
+		is_binary[*var] = true;
+	}
+}
+
+bool PresolvedLinearProgram::fix(unsigned int var, double val)
+{
+	if (is_integral[var])
+	{
+		double rounded = floor(val + 0.5);
+		if (fabs(val - rounded) > TOL)
+		{
+			infeasible = true;
+			return false;
+		}
+		val = rounded;
+	}
+
+	if (val < lb[var] - TOL || val > ub[var] + TOL)
+	{
+		infeasible = true;
+		return false;
+	}
+
+	is_fixed[var] = true;
+	value[var] = val;
+	lb[var] = ub[var] = val;
+	return true;
+}
+
+// move the terms of fixed variables to the right-hand side
+bool PresolvedLinearProgram::substitute_fixed(unsigned int r)
+{
+	unsigned int kept = row_begin[r];
+
+	for (unsigned int k = row_begin[r]; k < row_end[r]; k++)
+	{
+		const Entry &e = entries[k];
+		if (is_fixed[e.first])
+			rhs[r] -= e.second * value[e.first];
+		else
+			entries[kept++] = e;
+	}
+
+	bool changed = kept != row_end[r];
+	row_end[r] = kept;
+	return changed;
+}
+
+// Turn the row a * x {<=, ==} b into a bound on x. Returns false if the
+// row must be kept because the bound cannot be expressed in the reduced
+// program (integer variables are always passed on as unbounded above).
+bool PresolvedLinearProgram::apply_singleton(unsigned int r)
+{
+	const unsigned int var = entries[row_begin[r]].first;
+	const double a = entries[row_begin[r]].second;
+	double bound = rhs[r] / a;
+
+	if (is_equality[r])
+	{
+		row_active[r] = false;
+		fix(var, bound);
+		return true;
+	}
+
+	if (a > 0)
+	{
+		// x <= bound
+		if (is_integral[var])
+			bound = floor(bound + TOL);
+
+		if (bound >= ub[var] - TOL)
+			row_active[r] = false;
+		else if (bound < lb[var] - TOL)
+			infeasible = true;
+		else if (bound <= lb[var] + TOL)
+		{
+			row_active[r] = false;
+			fix(var, lb[var]);
+		}
+		else if (!is_integral[var])
+		{
+			row_active[r] = false;
+			ub[var] = bound;
+		}
+	}
+	else
+	{
+		// x >= bound
+		if (is_integral[var])
+			bound = ceil(bound - TOL);
+
+		if (bound <= lb[var] + TOL)
+			row_active[r] = false;
+		else if (bound > ub[var] + TOL)
+			infeasible = true;
+		else if (bound >= ub[var] - TOL)
+		{
+			row_active[r] = false;
+			fix(var, ub[var]);
+		}
+		else if (!is_integral[var])
+		{
+			row_active[r] = false;
+			lb[var] = bound;
+		}
+	}
+
+	return !row_active[r] || infeasible;
+}
+
+// an inequality whose maximum activity does not exceed its bound
+bool PresolvedLinearProgram::is_redundant(unsigned int r) const
+{
+	if (is_equality[r])
+		return false;
+
+	double max_activity = 0;
+	for (unsigned int k = row_begin[r]; k < row_end[r]; k++)
+	{
+		const Entry &e = entries[k];
+		max_activity += e.second * (e.second > 0 ? ub[e.first] : lb[e.first]);
+	}
+
+	return max_activity <= rhs[r] + TOL * std::max(1.0, fabs(rhs[r]));
+}
+
+// Keep only one of several rows with identical left-hand sides. Returns
+// false if two of them contradict each other.
+bool PresolvedLinearProgram::merge_duplicate_rows()
+{
+	hashmap<size_t, std::vector<unsigned int> > buckets;
+	std::hash<double> hash_coeff;
+
+	for (unsigned int r = 0; r < rhs.size(); r++)
+	{
+		if (!row_active[r])
+			continue;
+
+		size_t h = row_end[r] - row_begin[r];
+		for (unsigned int k = row_begin[r]; k < row_end[r]; k++)
+			h = h * 31 + entries[k].first * 17 + hash_coeff(entries[k].second);
+
+		std::vector<unsigned int> &same_hash = buckets[h];
+		bool merged = false;
+
+		foreach(same_hash, q_it)
+		{
+			const unsigned int q = *q_it;
+			const unsigned int size = row_end[q] - row_begin[q];
+
+			if (size != row_end[r] - row_begin[r] ||
+			    !std::equal(entries.begin() + row_begin[q],
+			                entries.begin() + row_end[q],
+			                entries.begin() + row_begin[r]))
+				continue;
+
+			if (is_equality[q] && is_equality[r])
+			{
+				if (fabs(rhs[q] - rhs[r]) > TOL)
+					return false;
+			}
+			else if (is_equality[q])
+			{
+				if (rhs[q] > rhs[r] + TOL)
+					return false;
+			}
+			else if (is_equality[r])
+			{
+				if (rhs[r] > rhs[q] + TOL)
+					return false;
+				is_equality[q] = true;
+				rhs[q] = rhs[r];
+			}
+			else
+				rhs[q] = std::min(rhs[q], rhs[r]);
+
+			row_active[r] = false;
+			merged = true;
+			break;
+		}
+
+		if (!merged)
+			same_hash.push_back(r);
+	}
+
+	return true;
+}
+
+void PresolvedLinearProgram::build_reduced()
+{
+	std::vector<bool> in_rows(num_vars, false);
+
+	for (unsigned int r = 0; r < rhs.size(); r++)
+		if (row_active[r])
+			for (unsigned int k = row_begin[r]; k < row_end[r]; k++)
+				in_rows[entries[k].first] = true;
+
+	for (unsigned int j = 0; j < num_vars; j++)
+	{
+		if (is_fixed[j])
+			continue;
+
+		if (!in_rows[j])
+		{
+			// unconstrained: pick the bound that the objective favors
+			double val;
+			if (cost[j] > 0)
+				val = ub[j];
+			else if (cost[j] < 0)
+				val = lb[j];
+			else
+				val = lb[j] > -INF ? lb[j] : (ub[j] < INF ? ub[j] : 0.0);
+
+			if (fabs(val) < INF)
+			{
+				value[j] = val;
+				continue;
+			}
+			// unbounded; leave it to the solver to report that
+		}
+
+		reduced_index[j] = num_reduced_vars++;
+	}
+
+	LinearExpression *obj = reduced.get_objective();
+	for (unsigned int j = 0; j < num_vars; j++)
+	{
+		const int idx = reduced_index[j];
+		if (idx < 0)
+			continue;
+
+		if (cost[j] != 0.0)
+			obj->add_term(cost[j], idx);
+
+		if (is_binary[j])
+			reduced.declare_variable_binary(idx);
+		else if (is_integral[j])
+			reduced.declare_variable_integer(idx);
+		else if (lb[j] != 0.0 || ub[j] != 1.0)
+			reduced.declare_variable_bounds(idx,
+				lb[j] > -INF, lb[j], ub[j] < INF, ub[j]);
+	}
+
+	for (unsigned int r = 0; r < rhs.size(); r++)
+	{
+		if (!row_active[r])
+			continue;
+
+		LinearExpression *exp = new LinearExpression();
+		for (unsigned int k = row_begin[r]; k < row_end[r]; k++)
+			exp->add_term(entries[k].second,
+			              reduced_index[entries[k].first]);
+
+		if (is_equality[r])
+			reduced.add_equality(exp, rhs[r]);
+		else
+			reduced.add_inequality(exp, rhs[r]);
+	}
+}
+
+Solution *PresolvedLinearProgram::restore(Solution *reduced_sol) const
+{
+	std::vector<double> values(value);
+
+	for (unsigned int j = 0; j < num_vars; j++)
+		if (reduced_index[j] >= 0)
+			values[j] = reduced_sol->get_value(reduced_index[j]);
+
+	delete reduced_sol;
+	return new PresolvedSolution(values);
+}
@@ -0,0 +1,1197 @@
+#include <assert.h>
+#include <math.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "linprog/simplex.h"
+
+// Built-in solver for the small LPs generated by the blocking analyses
+// (typically a few hundred variables with default [0, 1] bounds). LPs are
+// solved with a two-phase, bounded-variable primal simplex that keeps the
+// basis inverse explicitly, which for programs of this size is far cheaper
+// than setting up an external solver. Integer and binary variables are
+// handled with depth-first branch-and-bound on top of it. LPs that differ
+// from an already solved one only in their bounds (branch-and-bound nodes,
+// and consecutive LPs of a session with an unchanged constraint matrix) are
+// re-solved by dual simplex, starting from the previous optimal basis.
+// The basis inverse is dense, not factored sparsely as in a revised simplex
+// code for large LPs; hence the row limit below.
+
+static const double INF = std::numeric_limits<double>::infinity();
+
+static const double FEAS_TOL  = 1e-7;  // primal feasibility
+static const double OPT_TOL   = 1e-9;  // reduced costs
+static const double PIVOT_TOL = 1e-9;  // smallest acceptable pivot
+static const double INT_TOL   = 1e-6;  // integrality
+static const double GAP_TOL   = 1e-6;  // absolute B&B pruning tolerance
+
+enum {
+	// recompute the basis inverse from scratch every so many pivots
+	REFACTOR_INTERVAL = 100,
+	// switch to Bland's rule after this many degenerate pivots in a row
+	MAX_DEGENERATE_PIVOTS = 50,
+};
+
+// give up on ILPs that need more branch-and-bound nodes than this
+static std::atomic<unsigned long> max_bb_nodes(100000);
+
+void set_simplex_max_bb_nodes(unsigned long max_nodes)
+{
+	max_bb_nodes = max_nodes;
+}
+
+unsigned long get_simplex_max_bb_nodes()
+{
+	return max_bb_nodes;
+}
+
+// refuse LPs whose dense basis inverse would exceed this many rows
+static std::atomic<unsigned int> max_rows(2000);
+
+void set_simplex_max_rows(unsigned int rows)
+{
+	max_rows = rows;
+}
+
+unsigned int get_simplex_max_rows()
+{
+	return max_rows;
+}
+
+// The LP in computational form: maximize c^T x subject to A x + s = b and
+// lb <= x <= ub, where the logical variable s_i of an inequality row ranges
+// over [0, inf) and that of an equality row is fixed to zero. The
+// constraint matrix is stored column-wise. Shared by all B&B nodes.
+class SimplexProblem
+{
+public:
+	unsigned int num_rows;
+	unsigned int num_cols;
+
+	std::vector<int> col_begin;
+	std::vector<int> col_rows;
+	std::vector<double> col_coeffs;
+
+	std::vector<double> rhs;
+	std::vector<double> logical_ub;
+
+	std::vector<double> cost;
+	std::vector<double> lb, ub;
+
+	// variables that must take integral values
+	std::vector<unsigned int> integers;
+
+	// every variable with a nonzero cost is integral and has an integral
+	// cost, so every integral solution has an integral objective value
+	bool integral_objective;
+
+	SimplexProblem(const LinearProgram &lp, unsigned int num_vars);
+
+	// Replace the right-hand sides, costs, and variable bounds with those
+	// of lp, which must have the same constraint matrix as the LP that
+	// this problem was created from.
+	void load_rhs_costs_and_bounds(const LinearProgram &lp);
+
+private:
+	void add_rows(const SparseRows &rows, unsigned int first_row,
+	              double row_logical_ub, std::vector<int> &fill);
+};
+
+SimplexProblem::SimplexProblem(const LinearProgram &lp, unsigned int num_vars)
+	: num_rows(lp.get_num_rows()),
+	  num_cols(num_vars),
+	  col_begin(num_vars + 1, 0)
+{
+	const SparseRows &equ = lp.get_equalities();
+	const SparseRows &inequ = lp.get_inequalities();
+
+	// count the entries of each column...
+	for (unsigned int k = 0; k < equ.get_num_coeffs(); k++)
+		col_begin[equ.get_vars()[k] + 1]++;
+	for (unsigned int k = 0; k < inequ.get_num_coeffs(); k++)
+		col_begin[inequ.get_vars()[k] + 1]++;
+	for (unsigned int j = 0; j < num_cols; j++)
+		col_begin[j + 1] += col_begin[j];
+
+	// ...and scatter the rows into the columns
+	col_rows.resize(col_begin[num_cols]);
+	col_coeffs.resize(col_begin[num_cols]);
+	std::vector<int> fill(col_begin.begin(), col_begin.end() - 1);
+
+	add_rows(equ, 0, 0.0, fill);
+	add_rows(inequ, equ.size(), INF, fill);
+
+	load_rhs_costs_and_bounds(lp);
+}
+
+void SimplexProblem::load_rhs_costs_and_bounds(const LinearProgram &lp)
+{
+	const SparseRows &equ = lp.get_equalities();
+	const SparseRows &inequ = lp.get_inequalities();
+
+	rhs.assign(equ.get_bounds(), equ.get_bounds() + equ.size());
+	rhs.insert(rhs.end(), inequ.get_bounds(),
+	           inequ.get_bounds() + inequ.size());
+
+	cost.assign(num_cols, 0.0);
+	lb.assign(num_cols, 0.0);
+	ub.assign(num_cols, 1.0);
+	integers.clear();
+
+	foreach(lp.get_objective()->get_terms(), term)
+	{
+		assert(term->second < num_cols);
+		cost[term->second] += term->first;
+	}
+
+	foreach(lp.get_non_default_variable_ranges(), bnds)
+	{
+		lb[bnds->variable_id] = bnds->has_lower ? bnds->lower_bound : -INF;
+		ub[bnds->variable_id] = bnds->has_upper ? bnds->upper_bound : INF;
+	}
+
+	// same conventions as the other back ends: integer variables are
+	// only bounded from below, binary variables range over {0, 1}
+	foreach(lp.get_integer_variables(), var)
+	{
+		lb[*var] = 0.0;
+		ub[*var] = INF;
+	}
+
+	foreach(lp.get_binary_variables(), var)
+	{
+		lb[*var] = 0.0;
+		ub[*var] = 1.0;
+	}
+
+	integral_objective = true;
+	for (unsigned int j = 0; j < num_cols; j++)
+		if (lp.is_integer_variable(j) || lp.is_binary_variable(j))
+			integers.push_back(j);
+		else if (cost[j] != 0)
+			integral_objective = false;
+
+	foreach(integers, var)
+		if (cost[*var] != floor(cost[*var]))
+			integral_objective = false;
+}
+
+void SimplexProblem::add_rows(const SparseRows &rows, unsigned int first_row,
+                              double row_logical_ub, std::vector<int> &fill)
+{
+	for (unsigned int r = 0; r < rows.size(); r++)
+	{
+		const int *vars = rows.get_row_vars(r);
+		const double *coeffs = rows.get_row_coeffs(r);
+
+		for (unsigned int k = 0; k < rows.get_row_size(r); k++)
+		{
+			assert((unsigned int) vars[k] < num_cols);
+			col_rows[fill[vars[k]]] = first_row + r;
+			col_coeffs[fill[vars[k]]] = coeffs[k];
+			fill[vars[k]]++;
+		}
+
+		logical_ub.push_back(row_logical_ub);
+	}
+}
+
+// An optimal basis (and its inverse) of a previously solved LP, from which
+// another LP with the same constraint matrix can be warm-started.
+struct SimplexBasis
+{
+	std::vector<int> head;
+	std::vector<double> binv;
+	unsigned int pivots_since_refactor;
+};
+
+class BoundedSimplex
+{
+public:
+	enum status_t
+	{
+		OPTIMAL    = SIMPLEX_OPTIMAL,
+		INFEASIBLE = SIMPLEX_INFEASIBLE,
+		UNBOUNDED  = SIMPLEX_UNBOUNDED,
+		FAILED     = SIMPLEX_FAILED,
+		NODE_LIMIT = SIMPLEX_NODE_LIMIT,
+	};
+
+private:
+	const SimplexProblem &prob;
+	const unsigned int m;
+	const unsigned int n;
+
+	// Variables 0..n-1 are the structural variables, variable n + i is the
+	// logical variable of row i, and any further variables are phase-1
+	// artificials. Column j >= n is unit_sign[j - n] * e_{unit_row[j - n]}.
+	std::vector<int> unit_row;
+	std::vector<double> unit_sign;
+
+	std::vector<double> lb, ub, cost, x;
+
+	// basic variable of each row of the basis, and basis row of each variable
+	std::vector<int> head;
+	std::vector<int> basis_row;
+
+	// explicit basis inverse, row-major m x m
+	std::vector<double> binv;
+	unsigned int pivots_since_refactor;
+	unsigned int iterations_left;
+	unsigned long num_iterations;
+
+	// scratch space
+	std::vector<double> duals;
+	std::vector<double> alpha;
+
+	unsigned int num_vars() const
+	{
+		return lb.size();
+	}
+
+	void add_unit_column(unsigned int row, double sign,
+	                     double var_lb, double var_ub, double value);
+
+	double reduced_cost(unsigned int j) const;
+	double row_alpha(unsigned int r, unsigned int j) const;
+	void compute_duals();
+	void compute_column(unsigned int j);
+	void compute_basic_values();
+	void pivot(unsigned int r, unsigned int q);
+	bool refactor();
+	status_t optimize();
+	status_t dual_optimize();
+
+public:
+	BoundedSimplex(const SimplexProblem &prob,
+	               const std::vector<double> &col_lb,
+	               const std::vector<double> &col_ub);
+
+	status_t solve();
+
+	// Solve starting from the given basis of an LP with the same
+	// constraint matrix. Returns FAILED if the basis cannot be used, in
+	// which case the LP must be solved from scratch with a fresh object.
+	status_t warm_solve(const SimplexBasis &basis);
+
+	// false if the final basis still contains phase-1 artificials
+	bool save_basis(SimplexBasis &basis) const;
+
+	double get_value(unsigned int j) const
+	{
+		return x[j];
+	}
+
+	unsigned long get_num_iterations() const
+	{
+		return num_iterations;
+	}
+
+	double get_objective() const
+	{
+		double sum = 0;
+		for (unsigned int j = 0; j < n; j++)
+			sum += prob.cost[j] * x[j];
+		return sum;
+	}
+};
+
+BoundedSimplex::BoundedSimplex(const SimplexProblem &prob,
+                               const std::vector<double> &col_lb,
+                               const std::vector<double> &col_ub)
+	: prob(prob), m(prob.num_rows), n(prob.num_cols),
+	  lb(col_lb), ub(col_ub), cost(n, 0.0), x(n, 0.0),
+	  head(m, -1), basis_row(n, -1), binv((size_t) m * m, 0.0),
+	  pivots_since_refactor(0), iterations_left(0), num_iterations(0),
+	  duals(m), alpha(m)
+{
+	// nonbasic structural variables start at a finite bound, if any
+	for (unsigned int j = 0; j < n; j++)
+		x[j] = lb[j] > -INF ? lb[j] : (ub[j] < INF ? ub[j] : 0.0);
+
+	for (unsigned int i = 0; i < m; i++)
+		add_unit_column(i, 1.0, 0.0, prob.logical_ub[i], 0.0);
+}
+
+void BoundedSimplex::add_unit_column(unsigned int row, double sign,
+                                     double var_lb, double var_ub,
+                                     double value)
+{
+	unit_row.push_back(row);
+	unit_sign.push_back(sign);
+	lb.push_back(var_lb);
+	ub.push_back(var_ub);
+	cost.push_back(0.0);
+	x.push_back(value);
+	basis_row.push_back(-1);
+}
+
+double BoundedSimplex::reduced_cost(unsigned int j) const
+{
+	double d = cost[j];
+
+	if (j < n)
+	{
+		for (int k = prob.col_begin[j]; k < prob.col_begin[j + 1]; k++)
+			d -= duals[prob.col_rows[k]] * prob.col_coeffs[k];
+	}
+	else
+		d -= unit_sign[j - n] * duals[unit_row[j - n]];
+
+	return d;
+}
+
+// entry (r, j) of B^-1 A, i.e., row r of the simplex tableau
+double BoundedSimplex::row_alpha(unsigned int r, unsigned int j) const
+{
+	const double *row = &binv[(size_t) r * m];
+
+	if (j < n)
+	{
+		double a = 0;
+		for (int k = prob.col_begin[j]; k < prob.col_begin[j + 1]; k++)
+			a += row[prob.col_rows[k]] * prob.col_coeffs[k];
+		return a;
+	}
+	else
+		return row[unit_row[j - n]] * unit_sign[j - n];
+}
+
+void BoundedSimplex::compute_duals()
+{
+	std::fill(duals.begin(), duals.end(), 0.0);
+
+	for (unsigned int i = 0; i < m; i++)
+	{
+		double c = cost[head[i]];
+		if (c != 0.0)
+		{
+			const double *row = &binv[(size_t) i * m];
+			for (unsigned int k = 0; k < m; k++)
+				duals[k] += c * row[k];
+		}
+	}
+}
+
+void BoundedSimplex::compute_column(unsigned int j)
+{
+	std::fill(alpha.begin(), alpha.end(), 0.0);
+
+	if (j < n)
+	{
+		for (int k = prob.col_begin[j]; k < prob.col_begin[j + 1]; k++)
+		{
+			unsigned int r = prob.col_rows[k];
+			double v = prob.col_coeffs[k];
+			for (unsigned int i = 0; i < m; i++)
+				alpha[i] += binv[(size_t) i * m + r] * v;
+		}
+	}
+	else
+	{
+		unsigned int r = unit_row[j - n];
+		double v = unit_sign[j - n];
+		for (unsigned int i = 0; i < m; i++)
+			alpha[i] = binv[(size_t) i * m + r] * v;
+	}
+}
+
+// replace the basic variable of row r by variable q, given alpha = B^-1 a_q
+void BoundedSimplex::pivot(unsigned int r, unsigned int q)
+{
+	double *row_r = &binv[(size_t) r * m];
+	const double p = alpha[r];
+
+	for (unsigned int k = 0; k < m; k++)
+		row_r[k] /= p;
+
+	for (unsigned int i = 0; i < m; i++)
+	{
+		if (i != r && alpha[i] != 0.0)
+		{
+			double *row_i = &binv[(size_t) i * m];
+			const double f = alpha[i];
+			for (unsigned int k = 0; k < m; k++)
+				row_i[k] -= f * row_r[k];
+		}
+	}
+
+	basis_row[head[r]] = -1;
+	basis_row[q] = r;
+	head[r] = q;
+
+	pivots_since_refactor++;
+}
+
+// Recompute the basis inverse with Gauss-Jordan elimination and the values
+// of the basic variables from the nonbasic ones, to get rid of the error
+// accumulated by the product-form updates.
+bool BoundedSimplex::refactor()
+{
+	const size_t w = 2 * (size_t) m;
+	std::vector<double> aug(m * w, 0.0);
+
+	for (unsigned int i = 0; i < m; i++)
+	{
+		unsigned int j = head[i];
+		if (j < n)
+		{
+			for (int k = prob.col_begin[j]; k < prob.col_begin[j + 1]; k++)
+				aug[prob.col_rows[k] * w + i] += prob.col_coeffs[k];
+		}
+		else
+			aug[unit_row[j - n] * w + i] += unit_sign[j - n];
+		aug[i * w + m + i] = 1.0;
+	}
+
+	for (unsigned int c = 0; c < m; c++)
+	{
+		unsigned int p = c;
+		for (unsigned int i = c + 1; i < m; i++)
+			if (fabs(aug[i * w + c]) > fabs(aug[p * w + c]))
+				p = i;
+
+		if (fabs(aug[p * w + c]) < PIVOT_TOL)
+			return false;
+
+		if (p != c)
+			std::swap_ranges(aug.begin() + p * w, aug.begin() + (p + 1) * w,
+			                 aug.begin() + c * w);
+
+		const double piv = aug[c * w + c];
+		for (size_t k = c; k < w; k++)
+			aug[c * w + k] /= piv;
+
+		for (unsigned int i = 0; i < m; i++)
+		{
+			const double f = aug[i * w + c];
+			if (i != c && f != 0.0)
+				for (size_t k = c; k < w; k++)
+					aug[i * w + k] -= f * aug[c * w + k];
+		}
+	}
+
+	for (unsigned int i = 0; i < m; i++)
+		std::copy(aug.begin() + i * w + m, aug.begin() + (i + 1) * w,
+		          binv.begin() + (size_t) i * m);
+
+	compute_basic_values();
+
+	pivots_since_refactor = 0;
+	return true;
+}
+
+// x_B = B^-1 (b - N x_N)
+void BoundedSimplex::compute_basic_values()
+{
+	std::vector<double> residual(prob.rhs);
+	for (unsigned int j = 0; j < num_vars(); j++)
+	{
+		if (basis_row[j] >= 0 || x[j] == 0.0)
+			continue;
+		if (j < n)
+		{
+			for (int k = prob.col_begin[j]; k < prob.col_begin[j + 1]; k++)
+				residual[prob.col_rows[k]] -= prob.col_coeffs[k] * x[j];
+		}
+		else
+			residual[unit_row[j - n]] -= unit_sign[j - n] * x[j];
+	}
+
+	for (unsigned int i = 0; i < m; i++)
+	{
+		double v = 0;
+		const double *row = &binv[(size_t) i * m];
+		for (unsigned int k = 0; k < m; k++)
+			v += row[k] * residual[k];
+		x[head[i]] = v;
+	}
+}
+
+// primal simplex iterations w.r.t. the current cost vector
+BoundedSimplex::status_t BoundedSimplex::optimize()
+{
+	unsigned int degenerate_pivots = 0;
+
+	while (true)
+	{
+		if (!iterations_left--)
+			return FAILED;
+		num_iterations++;
+
+		if (pivots_since_refactor >= REFACTOR_INTERVAL && !refactor())
+			return FAILED;
+
+		compute_duals();
+
+		// pricing: Dantzig's rule, or Bland's rule to escape stalling
+		const bool bland = degenerate_pivots >= MAX_DEGENERATE_PIVOTS;
+		int q = -1;
+		double dir = 0, best = 0;
+
+		for (unsigned int j = 0; j < num_vars(); j++)
+		{
+			if (basis_row[j] >= 0 || lb[j] == ub[j])
+				continue;
+
+			double d = reduced_cost(j);
+			double d_dir;
+
+			if (d > OPT_TOL && x[j] < ub[j])
+				d_dir = 1.0;
+			else if (d < -OPT_TOL && x[j] > lb[j])
+				d_dir = -1.0;
+			else
+				continue;
+
+			if (fabs(d) > best)
+			{
+				q = j;
+				dir = d_dir;
+				best = fabs(d);
+				if (bland)
+					break;
+			}
+		}
+
+		if (q < 0)
+			return OPTIMAL;
+
+		compute_column(q);
+
+		// ratio test: x_q moves by dir * t, x_B by -dir * t * alpha
+		double t = ub[q] - lb[q];
+		int r = -1;
+		double r_alpha = 0;
+
+		for (unsigned int i = 0; i < m; i++)
+		{
+			const double a = dir * alpha[i];
+			const unsigned int j = head[i];
+			double limit;
+
+			if (fabs(a) <= PIVOT_TOL)
+				continue;
+			else if (a > 0 && lb[j] > -INF)
+				limit = (x[j] - lb[j]) / a;
+			else if (a < 0 && ub[j] < INF)
+				limit = (ub[j] - x[j]) / -a;
+			else
+				continue;
+
+			limit = std::max(limit, 0.0);
+
+			if (limit < t ||
+			    (limit == t && r >= 0 &&
+			     (bland ? j < (unsigned int) head[r]
+			            : fabs(a) > r_alpha)))
+			{
+				t = limit;
+				r = i;
+				r_alpha = fabs(a);
+			}
+		}
+
+		if (t == INF)
+			return UNBOUNDED;
+
+		degenerate_pivots = t > 0 ? 0 : degenerate_pivots + 1;
+
+		x[q] += dir * t;
+		for (unsigned int i = 0; i < m; i++)
+			if (alpha[i] != 0.0)
+				x[head[i]] -= dir * t * alpha[i];
+
+		if (r < 0)
+		{
+			// bound flip, the basis does not change
+			x[q] = dir > 0 ? ub[q] : lb[q];
+		}
+		else
+		{
+			unsigned int leaving = head[r];
+			x[leaving] = dir * alpha[r] > 0 ? lb[leaving] : ub[leaving];
+			pivot(r, q);
+		}
+	}
+}
+
+BoundedSimplex::status_t BoundedSimplex::solve()
+{
+	for (unsigned int j = 0; j < n; j++)
+		if (lb[j] > ub[j])
+			return INFEASIBLE;
+
+	// residual of the rows w.r.t. the nonbasic starting point
+	std::vector<double> residual(prob.rhs);
+	for (unsigned int j = 0; j < n; j++)
+		if (x[j] != 0.0)
+			for (int k = prob.col_begin[j]; k < prob.col_begin[j + 1]; k++)
+				residual[prob.col_rows[k]] -= prob.col_coeffs[k] * x[j];
+
+	// Start from the all-logical basis. Rows whose logical variable would
+	// violate its bounds get an artificial variable instead.
+	double max_rhs = 0;
+	bool need_phase1 = false;
+
+	for (unsigned int i = 0; i < m; i++)
+	{
+		const double v = residual[i];
+		unsigned int basic;
+
+		max_rhs = std::max(max_rhs, fabs(prob.rhs[i]));
+
+		if (v >= -FEAS_TOL && v <= prob.logical_ub[i] + FEAS_TOL)
+		{
+			basic = n + i;
+			x[basic] = v;
+		}
+		else
+		{
+			const double sign = v > 0 ? 1.0 : -1.0;
+			basic = num_vars();
+			add_unit_column(i, sign, 0.0, INF, fabs(v));
+			cost[basic] = -1.0;
+			need_phase1 = true;
+		}
+
+		head[i] = basic;
+		basis_row[basic] = i;
+		binv[(size_t) i * m + i] = unit_sign[basic - n];
+	}
+
+	iterations_left = 100 * (m + num_vars()) + 1000;
+
+	if (need_phase1)
+	{
+		// phase 1: drive the artificial variables to zero
+		if (optimize() != OPTIMAL)
+			return FAILED;
+
+		double infeasibility = 0;
+		for (unsigned int j = n + m; j < num_vars(); j++)
+		{
+			infeasibility += x[j];
+			cost[j] = 0.0;
+			ub[j] = 0.0;
+		}
+
+		if (infeasibility > FEAS_TOL * (1 + max_rhs))
+			return INFEASIBLE;
+	}
+
+	// phase 2: the actual objective
+	for (unsigned int j = 0; j < n; j++)
+		cost[j] = prob.cost[j];
+
+	return optimize();
+}
+
+// Dual simplex iterations w.r.t. the current cost vector, starting from a
+// dual feasible basis (e.g., the optimal basis of an LP that differed only
+// in its right-hand sides or bounds). Each iteration moves a basic variable
+// that violates its bounds to the violated bound.
+BoundedSimplex::status_t BoundedSimplex::dual_optimize()
+{
+	while (true)
+	{
+		if (!iterations_left--)
+			return FAILED;
+		num_iterations++;
+
+		if (pivots_since_refactor >= REFACTOR_INTERVAL && !refactor())
+			return FAILED;
+
+		// leaving variable: the largest bound violation
+		int r = -1;
+		double worst = FEAS_TOL;
+
+		for (unsigned int i = 0; i < m; i++)
+		{
+			const unsigned int j = head[i];
+			const double violation = std::max(lb[j] - x[j], x[j] - ub[j]);
+
+			if (violation > worst)
+			{
+				r = i;
+				worst = violation;
+			}
+		}
+
+		if (r < 0)
+			return OPTIMAL;
+
+		const unsigned int leaving = head[r];
+		const double target = x[leaving] < lb[leaving] ? lb[leaving]
+		                                               : ub[leaving];
+
+		compute_duals();
+
+		// Entering variable: moving it in a feasible direction must move
+		// the leaving variable towards its target. Among those, the one
+		// with the smallest ratio |d_j / alpha_rj| keeps all reduced
+		// costs dual feasible.
+		int q = -1;
+		double best_ratio = INF, q_alpha = 0;
+
+		for (unsigned int j = 0; j < num_vars(); j++)
+		{
+			if (basis_row[j] >= 0 || lb[j] == ub[j])
+				continue;
+
+			const double a = row_alpha(r, j);
+			if (fabs(a) <= PIVOT_TOL)
+				continue;
+
+			// x_B(r) changes by -a per unit increase of x_j
+			const bool increase = (x[leaving] - target) / a > 0;
+			if (increase ? x[j] >= ub[j] : x[j] <= lb[j])
+				continue;
+
+			const double ratio = fabs(reduced_cost(j)) / fabs(a);
+
+			if (ratio < best_ratio ||
+			    (ratio == best_ratio && fabs(a) > q_alpha))
+			{
+				q = j;
+				best_ratio = ratio;
+				q_alpha = fabs(a);
+			}
+		}
+
+		if (q < 0)
+			return INFEASIBLE;
+
+		compute_column(q);
+
+		const double theta = (x[leaving] - target) / alpha[r];
+
+		x[q] += theta;
+		for (unsigned int i = 0; i < m; i++)
+			if (alpha[i] != 0.0)
+				x[head[i]] -= theta * alpha[i];
+		x[leaving] = target;
+
+		pivot(r, q);
+	}
+}
+
+BoundedSimplex::status_t BoundedSimplex::warm_solve(const SimplexBasis &basis)
+{
+	if (basis.head.size() != m)
+		return FAILED;
+
+	for (unsigned int j = 0; j < n; j++)
+	{
+		if (lb[j] > ub[j])
+			return INFEASIBLE;
+		cost[j] = prob.cost[j];
+	}
+
+	for (unsigned int i = 0; i < m; i++)
+	{
+		const unsigned int j = basis.head[i];
+		if (j >= n + m || basis_row[j] >= 0)
+			return FAILED;
+		head[i] = j;
+		basis_row[j] = i;
+	}
+
+	binv = basis.binv;
+	pivots_since_refactor = basis.pivots_since_refactor;
+
+	// Place each nonbasic variable at the bound that its reduced cost
+	// favors, so that the basis is dual feasible if at all possible.
+	compute_duals();
+
+	bool dual_feasible = true;
+
+	for (unsigned int j = 0; j < num_vars(); j++)
+	{
+		if (basis_row[j] >= 0)
+			continue;
+
+		const double d = reduced_cost(j);
+
+		if (d > OPT_TOL && ub[j] < INF)
+			x[j] = ub[j];
+		else if (d < -OPT_TOL && lb[j] > -INF)
+			x[j] = lb[j];
+		else
+		{
+			dual_feasible = dual_feasible && fabs(d) <= OPT_TOL;
+			x[j] = lb[j] > -INF ? lb[j] : (ub[j] < INF ? ub[j] : 0.0);
+		}
+	}
+
+	compute_basic_values();
+
+	iterations_left = 100 * (m + num_vars()) + 1000;
+
+	if (dual_feasible)
+	{
+		status_t status = dual_optimize();
+		if (status != OPTIMAL)
+			return status;
+	}
+	else
+	{
+		// the costs changed, too; only a primal feasible basis helps
+		for (unsigned int i = 0; i < m; i++)
+		{
+			const unsigned int j = head[i];
+			if (x[j] < lb[j] - FEAS_TOL || x[j] > ub[j] + FEAS_TOL)
+				return FAILED;
+		}
+	}
+
+	// also cleans up reduced costs that tolerances left slightly off
+	return optimize();
+}
+
+bool BoundedSimplex::save_basis(SimplexBasis &basis) const
+{
+	for (unsigned int i = 0; i < m; i++)
+		if ((unsigned int) head[i] >= n + m)
+			return false;
+
+	basis.head = head;
+	basis.binv = binv;
+	basis.pivots_since_refactor = pivots_since_refactor;
+	return true;
+}
+
+class SimplexSolution : public Solution
+{
+private:
+	std::vector<double> values;
+
+public:
+	SimplexSolution(std::vector<double> &vals)
+	{
+		values.swap(vals);
+	}
+
+	double get_value(unsigned int var) const
+	{
+		assert(var < values.size());
+		return values[var];
+	}
+};
+
+// Solve the LP relaxation with the given variable bounds, starting from
+// basis if given. Anything but an optimum of the warm start (including
+// infeasibility, which is subject to the tolerances of the dual ratio test)
+// is confirmed by a solve from scratch.
+static BoundedSimplex::status_t solve_node(
+	const SimplexProblem &prob,
+	const std::vector<double> &lb,
+	const std::vector<double> &ub,
+	const SimplexBasis *basis,
+	std::unique_ptr<BoundedSimplex> &lp)
+{
+	BoundedSimplex::status_t status;
+
+	if (basis)
+	{
+		lp.reset(new BoundedSimplex(prob, lb, ub));
+		status = lp->warm_solve(*basis);
+		linprog_stats_add_iterations(lp->get_num_iterations());
+
+		if (status == BoundedSimplex::OPTIMAL)
+			return status;
+	}
+
+	lp.reset(new BoundedSimplex(prob, lb, ub));
+	status = lp->solve();
+	linprog_stats_add_iterations(lp->get_num_iterations());
+
+	return status;
+}
+
+// If have_basis is set, basis is used as the starting basis. On return,
+// basis and have_basis describe the optimal basis of the relaxation.
+static BoundedSimplex::status_t solve_relaxation(
+	const SimplexProblem &prob,
+	std::vector<double> &values,
+	SimplexBasis &basis, bool &have_basis)
+{
+	std::unique_ptr<BoundedSimplex> lp;
+	BoundedSimplex::status_t status =
+		solve_node(prob, prob.lb, prob.ub, have_basis ? &basis : NULL, lp);
+
+	have_basis = status == BoundedSimplex::OPTIMAL && lp->save_basis(basis);
+
+	if (status == BoundedSimplex::OPTIMAL)
+		for (unsigned int j = 0; j < prob.num_cols; j++)
+			values[j] = lp->get_value(j);
+
+	return status;
+}
+
+// Can a node whose relaxation attains bound contain an integral solution
+// that is better than the incumbent? The tolerance is absolute, since a
+// relative one would prune nodes that beat a large incumbent (e.g., a
+// blocking bound in nanoseconds) by whole units. If the objective is
+// integral, no solution below the node is better than floor(bound).
+static bool may_improve(const SimplexProblem &prob, double bound,
+                        double incumbent)
+{
+	if (prob.integral_objective)
+		return floor(bound + GAP_TOL) > incumbent + 0.5;
+	return bound > incumbent + GAP_TOL;
+}
+
+// Depth-first branch-and-bound on the most fractional variable. Each node
+// differs from its parent only in the bounds of the branching variable, so
+// it is warm-started from the parent's optimal basis. root_basis and
+// have_root_basis are used and updated as in solve_relaxation().
+static BoundedSimplex::status_t branch_and_bound(
+	const SimplexProblem &prob,
+	std::vector<double> &values,
+	SimplexBasis &root_basis, bool &have_root_basis)
+{
+	struct Node
+	{
+		std::vector<double> lb, ub;
+		std::shared_ptr<const SimplexBasis> basis;
+	};
+
+	std::vector<Node> open(1);
+	open.back().lb = prob.lb;
+	open.back().ub = prob.ub;
+
+	bool have_incumbent = false;
+	double incumbent = -INF;
+	unsigned long num_nodes = 0;
+	const unsigned long max_nodes = max_bb_nodes;
+
+	while (!open.empty())
+	{
+		if (++num_nodes > max_nodes)
+			return BoundedSimplex::NODE_LIMIT;
+
+		Node node;
+		node.lb.swap(open.back().lb);
+		node.ub.swap(open.back().ub);
+		node.basis.swap(open.back().basis);
+		open.pop_back();
+
+		const bool is_root = num_nodes == 1;
+		const SimplexBasis *start = node.basis.get();
+		if (is_root && have_root_basis)
+			start = &root_basis;
+
+		std::unique_ptr<BoundedSimplex> lp;
+		BoundedSimplex::status_t status =
+			solve_node(prob, node.lb, node.ub, start, lp);
+
+		if (is_root)
+			have_root_basis = status == BoundedSimplex::OPTIMAL &&
+			                  lp->save_basis(root_basis);
+
+		if (status == BoundedSimplex::INFEASIBLE)
+			continue;
+		else if (status != BoundedSimplex::OPTIMAL)
+			return status;
+
+		const double bound = lp->get_objective();
+		if (have_incumbent && !may_improve(prob, bound, incumbent))
+			continue;
+
+		int branch_var = -1;
+		double max_frac = INT_TOL;
+		foreach(prob.integers, var)
+		{
+			double v = lp->get_value(*var);
+			double frac = fabs(v - floor(v + 0.5));
+			if (frac > max_frac)
+			{
+				branch_var = *var;
+				max_frac = frac;
+			}
+		}
+
+		if (branch_var < 0)
+		{
+			// integral solution, new incumbent
+			have_incumbent = true;
+			incumbent = bound;
+			for (unsigned int j = 0; j < prob.num_cols; j++)
+				values[j] = lp->get_value(j);
+			foreach(prob.integers, var)
+				values[*var] = floor(values[*var] + 0.5);
+			continue;
+		}
+
+		// both children start from this node's optimal basis
+		std::shared_ptr<SimplexBasis> basis(new SimplexBasis());
+		if (!lp->save_basis(*basis))
+			basis.reset();
+
+		// explore the "up" branch first: blocking LPs maximize, so
+		// rounding up tends to find good incumbents early
+		const double v = lp->get_value(branch_var);
+
+		open.push_back(node);
+		open.back().ub[branch_var] = floor(v);
+		open.back().basis = basis;
+
+		open.push_back(Node());
+		open.back().lb.swap(node.lb);
+		open.back().ub.swap(node.ub);
+		open.back().lb[branch_var] = ceil(v);
+		open.back().basis = basis;
+	}
+
+	return have_incumbent ? BoundedSimplex::OPTIMAL
+	                      : BoundedSimplex::INFEASIBLE;
+}
+
+static void report_failure(BoundedSimplex::status_t status)
+{
+	std::cerr << "NOT SOLVED => simplex status: " << status << " (";
+	switch (status)
+	{
+		case BoundedSimplex::INFEASIBLE:
+			std::cerr << "INFEASIBLE";
+			break;
+		case BoundedSimplex::UNBOUNDED:
+			std::cerr << "UNBOUNDED";
+			break;
+		case BoundedSimplex::NODE_LIMIT:
+			std::cerr << "NODE LIMIT";
+			break;
+		default:
+			std::cerr << "FAILED";
+	}
+	std::cerr << ")" << std::endl;
+}
+
+// Checks the row limit; if status_out is NULL, a refusal is reported on
+// stderr.
+static bool is_too_large(const LinearProgram& lp,
+                         simplex_status_t *status_out)
+{
+	if (lp.get_num_rows() <= max_rows)
+		return false;
+
+	if (status_out)
+		*status_out = SIMPLEX_TOO_LARGE;
+	else
+		std::cerr << "NOT SOLVED => simplex: " << lp.get_num_rows()
+		          << " rows exceed the limit of " << max_rows
+		          << std::endl;
+	return true;
+}
+
+// If status_out is NULL, failures are reported on stderr.
+static Solution *solve_problem(const SimplexProblem &prob,
+                               SimplexBasis &basis, bool &have_basis,
+                               simplex_status_t *status_out)
+{
+	std::vector<double> values(prob.num_cols, 0.0);
+	BoundedSimplex::status_t status;
+
+	if (prob.integers.empty())
+		status = solve_relaxation(prob, values, basis, have_basis);
+	else
+		status = branch_and_bound(prob, values, basis, have_basis);
+
+	if (status_out)
+		*status_out = (simplex_status_t) status;
+
+	if (status == BoundedSimplex::OPTIMAL)
+		return new SimplexSolution(values);
+
+	if (!status_out)
+		report_failure(status);
+	return NULL;
+}
+
+Solution *simplex_solve(const LinearProgram& lp, unsigned int max_num_vars,
+                        simplex_status_t *status)
+{
+	// Trivial case: no variables.
+	if (!max_num_vars)
+	{
+		if (status)
+			*status = SIMPLEX_OPTIMAL;
+		std::vector<double> values;
+		return new SimplexSolution(values);
+	}
+
+	if (is_too_large(lp, status))
+		return NULL;
+
+	SimplexProblem prob(lp, max_num_vars);
+	SimplexBasis basis;
+	bool have_basis = false;
+
+	return solve_problem(prob, basis, have_basis, status);
+}
+
+// Keeps the column-wise problem and the optimal basis of the last LP (or,
+// for integer programs, of the root relaxation). If the next LP has the
+// same constraint matrix, only the right-hand sides, costs, and bounds are
+// reloaded, and the LP is solved starting from the old basis inverse: after
+// a change of right-hand sides or bounds, the old basis remains dual
+// feasible, so a few dual simplex pivots usually suffice.
+class SimplexSession : public LinearProgramSession
+{
+private:
+	std::unique_ptr<SimplexProblem> prob;
+
+	// constraint matrix of prob, to recognize LPs that differ only in
+	// their right-hand sides, costs, or bounds
+	SparseRows equalities, inequalities;
+
+	SimplexBasis basis;
+	bool have_basis;
+
+	// where to store the outcome of each solve, if anywhere
+	simplex_status_t *status;
+
+	bool same_matrix(const LinearProgram &lp, unsigned int num_vars) const
+	{
+		return prob && prob->num_cols == num_vars &&
+		       lp.get_equalities().same_matrix(equalities) &&
+		       lp.get_inequalities().same_matrix(inequalities);
+	}
+
+public:
+	SimplexSession(simplex_status_t *status)
+		: have_basis(false), status(status)
+	{}
+
+	Solution *solve(const LinearProgram& lp, unsigned int max_num_vars);
+};
+
+Solution *SimplexSession::solve(const LinearProgram& lp,
+                                unsigned int max_num_vars)
+{
+	if (!max_num_vars || is_too_large(lp, status))
+		return simplex_solve(lp, max_num_vars, status);
+
+	if (same_matrix(lp, max_num_vars))
+		prob->load_rhs_costs_and_bounds(lp);
+	else
+	{
+		prob.reset(new SimplexProblem(lp, max_num_vars));
+		equalities = lp.get_equalities();
+		inequalities = lp.get_inequalities();
+		have_basis = false;
+	}
+
+	return solve_problem(*prob, basis, have_basis, status);
+}
+
+LinearProgramSession *simplex_create_session(simplex_status_t *status)
+{
+	return new SimplexSession(status);
+}
@@ -0,0 +1,351 @@
+#include <assert.h>
+
+#include <atomic>
+
+#include "linprog/solver.h"
+#include "linprog/capture.h"
+#include "linprog/presolve.h"
+#include "linprog/simplex.h"
+
+#ifdef CONFIG_HAVE_GLPK
+#include "linprog/glpk.h"
+#endif
+
+#ifdef CONFIG_HAVE_CPLEX
+#include "linprog/cplex.h"
+#endif
+
+// builds configured with LP_SOLVER=native default to the built-in solver
+#ifdef CONFIG_NATIVE_LP
+static std::atomic<int> selected_solver(LP_SOLVER_NATIVE);
+#else
+static std::atomic<int> selected_solver(LP_SOLVER_AUTO);
+#endif
+
+// LP_SOLVER_AUTO sends programs up to this size to the built-in solver
+static std::atomic<unsigned int> native_max_rows(400);
+static std::atomic<unsigned int> native_max_cols(800);
+static std::atomic<unsigned int> native_max_int_vars(40);
+
+static std::atomic<bool> presolve_enabled(true);
+
+bool is_lp_solver_available(lp_solver_t solver)
+{
+	switch (solver)
+	{
+		case LP_SOLVER_AUTO:
+		case LP_SOLVER_NATIVE:
+			return true;
+#ifdef CONFIG_HAVE_GLPK
+		case LP_SOLVER_GLPK:
+			return true;
+#endif
+#ifdef CONFIG_HAVE_CPLEX
+		case LP_SOLVER_CPLEX:
+			return true;
+#endif
+		default:
+			return false;
+	}
+}
+
+bool set_lp_solver(lp_solver_t solver)
+{
+	if (!is_lp_solver_available(solver))
+		return false;
+
+	selected_solver = solver;
+	return true;
+}
+
+lp_solver_t get_lp_solver()
+{
+	return (lp_solver_t) selected_solver.load();
+}
+
+void set_lp_auto_dispatch_limits(unsigned int max_rows, unsigned int max_cols,
+                                 unsigned int max_int_vars)
+{
+	native_max_rows = max_rows;
+	native_max_cols = max_cols;
+	native_max_int_vars = max_int_vars;
+}
+
+void set_lp_presolve(bool enabled)
+{
+	presolve_enabled = enabled;
+}
+
+bool get_lp_presolve()
+{
+	return presolve_enabled;
+}
+
+// external back end for lp, or LP_SOLVER_NATIVE if none was compiled in
+static lp_solver_t choose_external_solver(const LinearProgram& lp)
+{
+	const bool is_mip = lp.has_integer_variables() ||
+	                    lp.has_binary_variables();
+
+	// CPLEX is the fastest choice for large ILPs, GLPK for large LPs.
+	if (is_mip && is_lp_solver_available(LP_SOLVER_CPLEX))
+		return LP_SOLVER_CPLEX;
+	else if (is_lp_solver_available(LP_SOLVER_GLPK))
+		return LP_SOLVER_GLPK;
+	else if (is_lp_solver_available(LP_SOLVER_CPLEX))
+		return LP_SOLVER_CPLEX;
+	else
+		return LP_SOLVER_NATIVE;
+}
+
+static lp_solver_t choose_solver(lp_solver_t selected,
+                                 const LinearProgram& lp,
+                                 unsigned int max_num_vars)
+{
+	// LPs that the built-in solver refuses (see simplex.h) go to an
+	// external back end even if the built-in one was selected.
+	if (selected == LP_SOLVER_NATIVE &&
+	    lp.get_num_rows() > get_simplex_max_rows())
+		return choose_external_solver(lp);
+
+	if (selected != LP_SOLVER_AUTO)
+		return selected;
+
+	const bool is_mip = lp.has_integer_variables() ||
+	                    lp.has_binary_variables();
+	const unsigned int num_int_vars = lp.get_integer_variables().size() +
+	                                  lp.get_binary_variables().size();
+
+	// Setting up an external solver dominates the cost of small programs.
+	if (lp.get_num_rows() <= native_max_rows &&
+	    lp.get_num_rows() <= get_simplex_max_rows() &&
+	    max_num_vars <= native_max_cols &&
+	    (!is_mip || num_int_vars <= native_max_int_vars))
+		return LP_SOLVER_NATIVE;
+
+	return choose_external_solver(lp);
+}
+
+lp_solver_t linprog_choose_solver(const LinearProgram& lp,
+                                  unsigned int max_num_vars)
+{
+	return choose_solver(get_lp_solver(), lp, max_num_vars);
+}
+
+// LP_SOLVER_AUTO picks the built-in solver only because it is cheaper for
+// small programs. LPs on which it fails (e.g., ILPs that exceed its
+// branch-and-bound node limit) are solved again with the external back end
+// that would have been chosen otherwise, if any. A back end that was
+// selected explicitly is never replaced.
+static lp_solver_t native_fallback(lp_solver_t selected,
+                                   const LinearProgram& lp)
+{
+	return selected == LP_SOLVER_AUTO ? choose_external_solver(lp)
+	                                  : LP_SOLVER_NATIVE;
+}
+
+static Solution *solve_with(lp_solver_t solver, const LinearProgram& lp,
+                            unsigned int max_num_vars)
+{
+	switch (solver)
+	{
+#ifdef CONFIG_HAVE_GLPK
+		case LP_SOLVER_GLPK:
+			return glpk_solve(lp, max_num_vars);
+#endif
+#ifdef CONFIG_HAVE_CPLEX
+		case LP_SOLVER_CPLEX:
+			return cpx_solve(lp, max_num_vars);
+#endif
+		case LP_SOLVER_NATIVE:
+			return simplex_solve(lp, max_num_vars);
+		default:
+			assert(0);
+			return NULL;
+	}
+}
+
+static Solution *choose_and_solve(const LinearProgram& lp,
+                                  unsigned int max_num_vars)
+{
+	const lp_solver_t selected = get_lp_solver();
+	const lp_solver_t solver = choose_solver(selected, lp, max_num_vars);
+	const lp_solver_t fallback = native_fallback(selected, lp);
+
+	if (solver != LP_SOLVER_NATIVE || fallback == LP_SOLVER_NATIVE)
+		return solve_with(solver, lp, max_num_vars);
+
+	// the failure is not reported if the fallback solves the LP
+	simplex_status_t status;
+	Solution *sol = simplex_solve(lp, max_num_vars, &status);
+	if (!sol)
+		sol = solve_with(fallback, lp, max_num_vars);
+
+	return sol;
+}
+
+static Solution *presolve_and_solve(const LinearProgram& lp,
+                                    unsigned int max_num_vars)
+{
+	PresolvedLinearProgram presolved(lp, max_num_vars);
+
+	if (presolved.is_infeasible())
+		return NULL;
+
+	Solution *sol = NULL;
+	if (presolved.get_num_reduced_vars())
+	{
+		sol = choose_and_solve(presolved.get_reduced(),
+		                       presolved.get_num_reduced_vars());
+		if (!sol)
+			return NULL;
+	}
+
+	return presolved.restore(sol);
+}
+
+// capture, time, and count every LP that is handed to a back end
+template <typename Solve>
+static Solution *instrumented_solve(const LinearProgram& lp,
+                                    unsigned int max_num_vars, Solve solve)
+{
+	linprog_capture(lp, max_num_vars);
+
+	const double start = linprog_stats_solve_begin();
+	Solution *sol = solve();
+	linprog_stats_solve_end(lp, max_num_vars, start, sol);
+
+	return sol;
+}
+
+Solution *linprog_solve(const LinearProgram& lp, unsigned int max_num_vars)
+{
+	return instrumented_solve(lp, max_num_vars, [&]() {
+		if (presolve_enabled && max_num_vars)
+			return presolve_and_solve(lp, max_num_vars);
+		else
+			return choose_and_solve(lp, max_num_vars);
+	});
+}
+
+template <typename Solve>
+static Solution *relaxed_first(const LinearProgram& lp,
+                               unsigned int max_num_vars,
+                               double threshold, bool *exact, Solve solve)
+{
+	if (exact)
+		*exact = true;
+
+	if (!lp.has_integer_variables() && !lp.has_binary_variables())
+		return solve(lp);
+
+	LinearProgram relaxed;
+	relaxed.append(lp, 0, true);
+	relaxed.set_objective(new LinearExpression(*lp.get_objective()));
+
+	Solution *sol = solve(relaxed);
+	if (sol && sol->evaluate(*relaxed.get_objective()) <= threshold)
+	{
+		if (exact)
+			*exact = false;
+		return sol;
+	}
+
+	delete sol;
+	return solve(lp);
+}
+
+Solution *linprog_solve_relaxed_first(const LinearProgram& lp,
+                                      unsigned int max_num_vars,
+                                      double threshold, bool *exact)
+{
+	return relaxed_first(lp, max_num_vars, threshold, exact,
+		[&](const LinearProgram& to_solve) {
+			return linprog_solve(to_solve, max_num_vars);
+		});
+}
+
+Solution *LinearProgramSession::solve_relaxed_first(const LinearProgram& lp,
+                                                    unsigned int max_num_vars,
+                                                    double threshold,
+                                                    bool *exact)
+{
+	return relaxed_first(lp, max_num_vars, threshold, exact,
+		[&](const LinearProgram& to_solve) {
+			return solve(to_solve, max_num_vars);
+		});
+}
+
+void linprog_release_thread_state()
+{
+#ifdef CONFIG_HAVE_GLPK
+	glpk_release_thread_state();
+#endif
+}
+
+// LPs dispatched to GLPK are solved incrementally in a persistent GLPK
+// problem, and LPs dispatched to the built-in solver are warm-started from
+// the previous basis if only their right-hand sides or bounds changed.
+// Both skip the presolve step, which would renumber variables and rows from
+// one LP to the next and thereby defeat the incremental updates.
+class DispatchingSession : public LinearProgramSession
+{
+private:
+	// created when the first LP is dispatched to the respective back end
+	LinearProgramSession *glpk_session;
+	LinearProgramSession *native_session;
+
+	// outcome of the last LP solved by native_session
+	simplex_status_t native_status;
+
+public:
+	DispatchingSession() : glpk_session(NULL), native_session(NULL) {}
+
+	~DispatchingSession()
+	{
+		delete glpk_session;
+		delete native_session;
+	}
+
+	Solution *solve(const LinearProgram& lp, unsigned int max_num_vars)
+	{
+		const lp_solver_t selected = get_lp_solver();
+		const lp_solver_t solver = choose_solver(selected, lp, max_num_vars);
+
+		if (solver == LP_SOLVER_NATIVE && max_num_vars)
+		{
+			// as in choose_and_solve(), failures are reported by the
+			// fallback, if there is one
+			const lp_solver_t fallback = native_fallback(selected, lp);
+			if (!native_session)
+				native_session = simplex_create_session(
+					is_lp_solver_available(LP_SOLVER_GLPK) ||
+					is_lp_solver_available(LP_SOLVER_CPLEX)
+					? &native_status : NULL);
+			return instrumented_solve(lp, max_num_vars, [&]() {
+				Solution *sol = native_session->solve(lp, max_num_vars);
+				if (!sol && fallback != LP_SOLVER_NATIVE)
+					sol = solve_with(fallback, lp, max_num_vars);
+				return sol;
+			});
+		}
+
+#ifdef CONFIG_HAVE_GLPK
+		if (solver == LP_SOLVER_GLPK)
+		{
+			if (!glpk_session)
+				glpk_session = glpk_create_session();
+			return instrumented_solve(lp, max_num_vars, [&]() {
+				return glpk_session->solve(lp, max_num_vars);
+			});
+		}
+#endif
+
+		return linprog_solve(lp, max_num_vars);
+	}
+};
+
+LinearProgramSession *linprog_create_session()
+{
+	return new DispatchingSession();
+}
@@ -0,0 +1,235 @@
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "linprog/solver.h"
+#include "linprog/stats.h"
+
+// The counters are kept per thread, so that the worker threads of the
+// parallel analyses neither contend for a lock nor look up analysis names
+// for every LP. Each thread keeps its counters by the address of the
+// analysis name (a static string); they are merged by name only when the
+// statistics are queried. The per-thread lock is only ever contended by
+// such a query or a reset.
+struct ThreadLPStats
+{
+	std::mutex lock;
+	std::vector<std::pair<const char *, LPStats> > by_analysis;
+
+	ThreadLPStats();
+	~ThreadLPStats();
+
+	// counters of analysis; must be called with lock held
+	LPStats& get(const char *analysis)
+	{
+		// consecutive LPs usually come from the same analysis
+		for (unsigned int i = by_analysis.size(); i > 0; i--)
+			if (by_analysis[i - 1].first == analysis)
+				return by_analysis[i - 1].second;
+
+		by_analysis.push_back(std::make_pair(analysis, LPStats()));
+		return by_analysis.back().second;
+	}
+};
+
+// all threads with counters, and the merged counters of threads that
+// have exited
+static std::mutex registry_lock;
+static std::set<ThreadLPStats*> live_threads;
+static std::map<std::string, LPStats> exited_threads;
+
+static thread_local ThreadLPStats thread_stats;
+
+// Start of the current model-building phase of the calling thread, or
+// negative if the thread is not running an analysis.
+static thread_local double build_start = -1;
+
+// simplex iterations reported by the back end during the current solve
+static thread_local unsigned long pending_iterations = 0;
+
+static void add_stats(LPStats &to, const LPStats &s)
+{
+	to.num_lps += s.num_lps;
+	to.num_failed += s.num_failed;
+	to.build_time += s.build_time;
+	to.solve_time += s.solve_time;
+	to.extract_time += s.extract_time;
+	to.rows += s.rows;
+	to.cols += s.cols;
+	to.nonzeros += s.nonzeros;
+	to.iterations += s.iterations;
+}
+
+ThreadLPStats::ThreadLPStats()
+{
+	std::lock_guard<std::mutex> guard(registry_lock);
+	live_threads.insert(this);
+}
+
+ThreadLPStats::~ThreadLPStats()
+{
+	std::lock_guard<std::mutex> guard(registry_lock);
+	live_threads.erase(this);
+	foreach(by_analysis, it)
+		add_stats(exited_threads[it->first], it->second);
+}
+
+// counters of all threads by analysis; must be called with registry_lock
+// held
+static std::map<std::string, LPStats> merged_stats()
+{
+	std::map<std::string, LPStats> merged(exited_threads);
+
+	foreach(live_threads, thread)
+	{
+		std::lock_guard<std::mutex> guard((*thread)->lock);
+		foreach((*thread)->by_analysis, it)
+			add_stats(merged[it->first], it->second);
+	}
+
+	return merged;
+}
+
+static double now()
+{
+	return std::chrono::duration<double>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static const char *current_analysis()
+{
+	const char *analysis = linprog_get_origin().analysis;
+	return analysis ? analysis : "unknown";
+}
+
+// Analyses are listed once they have recorded an LP, and stay listed
+// (with zero counters) after a reset. The list is a snapshot, so the
+// index of an analysis may change if another one records its first LP in
+// the meantime.
+static std::vector<std::string> analysis_names()
+{
+	std::lock_guard<std::mutex> guard(registry_lock);
+
+	std::vector<std::string> names;
+	std::map<std::string, LPStats> merged = merged_stats();
+	foreach(merged, it)
+		names.push_back(it->first);
+	return names;
+}
+
+unsigned int get_lp_stats_num_analyses()
+{
+	return analysis_names().size();
+}
+
+const char *get_lp_stats_analysis(unsigned int index)
+{
+	static std::mutex names_lock;
+	static std::set<std::string> names;
+
+	std::vector<std::string> current = analysis_names();
+	if (index >= current.size())
+		return NULL;
+
+	// the returned strings are kept for the lifetime of the process
+	std::lock_guard<std::mutex> guard(names_lock);
+	return names.insert(current[index]).first->c_str();
+}
+
+LPStats get_lp_stats(const char *analysis)
+{
+	std::lock_guard<std::mutex> guard(registry_lock);
+	std::map<std::string, LPStats> merged = merged_stats();
+
+	if (analysis)
+	{
+		std::map<std::string, LPStats>::const_iterator it =
+			merged.find(analysis);
+		return it != merged.end() ? it->second : LPStats();
+	}
+
+	LPStats total;
+	foreach(merged, it)
+		add_stats(total, it->second);
+	return total;
+}
+
+void reset_lp_stats()
+{
+	std::lock_guard<std::mutex> guard(registry_lock);
+
+	foreach(exited_threads, it)
+		it->second = LPStats();
+
+	foreach(live_threads, thread)
+	{
+		std::lock_guard<std::mutex> thread_guard((*thread)->lock);
+		foreach((*thread)->by_analysis, it)
+			it->second = LPStats();
+	}
+}
+
+void linprog_stats_begin_analysis()
+{
+	build_start = now();
+}
+
+void linprog_stats_end_analysis()
+{
+	build_start = -1;
+}
+
+double linprog_stats_solve_begin()
+{
+	pending_iterations = 0;
+	return now();
+}
+
+void linprog_stats_solve_end(const LinearProgram &lp, unsigned int num_vars,
+                             double start, Solution *sol)
+{
+	const double end = now();
+
+	if (sol)
+		sol->returned_at = end;
+
+	std::lock_guard<std::mutex> guard(thread_stats.lock);
+	LPStats &s = thread_stats.get(current_analysis());
+
+	s.num_lps++;
+	s.num_failed += !sol;
+	if (build_start >= 0)
+		s.build_time += start - build_start;
+	s.solve_time += end - start;
+	s.rows += lp.get_num_rows();
+	s.cols += num_vars;
+	s.nonzeros += lp.get_equalities().get_num_coeffs() +
+	              lp.get_inequalities().get_num_coeffs();
+	s.iterations += pending_iterations;
+
+	// the next model is built once this solution has been evaluated
+	if (build_start >= 0)
+		build_start = end;
+}
+
+void linprog_stats_add_iterations(unsigned long num_iterations)
+{
+	pending_iterations += num_iterations;
+}
+
+void linprog_stats_solution_deleted(double returned_at)
+{
+	const double end = now();
+
+	{
+		std::lock_guard<std::mutex> guard(thread_stats.lock);
+		thread_stats.get(current_analysis()).extract_time +=
+			end - returned_at;
+	}
+
+	if (build_start >= 0)
+		build_start = end;
+}
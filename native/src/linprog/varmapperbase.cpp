@@ -3,10 +3,80 @@
 #include <stdint.h>
 
 #include <sstream>
+#include <algorithm>
 
 #include "linprog/varmapperbase.h"
 
 
+void VarMapperBase::set_dense_layout(unsigned int e0, unsigned int e1,
+                                     unsigned int e2, unsigned int e3)
+{
+	dense_extent[0] = e0;
+	dense_extent[1] = e1;
+	dense_extent[2] = e2;
+	dense_extent[3] = e3;
+
+	dense_stride[2] = e3;
+	dense_stride[1] = (size_t) e2 * e3;
+	dense_stride[0] = (size_t) e1 * e2 * e3;
+
+	dense.assign((size_t) e0 * dense_stride[0], (unsigned int) NO_VAR);
+}
+
+void VarMapperBase::set_dense_extents(unsigned int e0, unsigned int e1,
+                                      unsigned int e2, unsigned int e3)
+{
+	assert(keys.empty());
+
+	size_t outer = (size_t) e0 * e1 * e2;
+
+	e3 = std::max(e3, 1u);
+	if (outer > 0 && outer * e3 <= MAX_DENSE_SLOTS)
+	{
+		set_dense_layout(e0, e1, e2, e3);
+		dense_growable = true;
+	}
+	else
+	{
+		// too large: everything goes through the hash map
+		set_dense_layout(0, 0, 0, 0);
+		dense_growable = false;
+	}
+}
+
+bool VarMapperBase::grow_dense_index(unsigned int c3)
+{
+	if (!dense_growable)
+		return false;
+
+	size_t outer = (size_t) dense_extent[0] * dense_extent[1] * dense_extent[2];
+	size_t new_e3 = std::max((size_t) c3 + 1, 2 * (size_t) dense_extent[3]);
+
+	if (new_e3 * outer > MAX_DENSE_SLOTS)
+		new_e3 = MAX_DENSE_SLOTS / outer;
+
+	if (new_e3 <= c3)
+	{
+		// Out of room. Freeze the layout so that a key that now goes
+		// to the hash map never later shows up in the dense index.
+		dense_growable = false;
+		return false;
+	}
+
+	std::vector<unsigned int> old;
+	unsigned int old_e3 = dense_extent[3];
+
+	old.swap(dense);
+	set_dense_layout(dense_extent[0], dense_extent[1], dense_extent[2],
+	                 new_e3);
+
+	for (size_t i = 0; i < outer; i++)
+		std::copy(old.begin() + i * old_e3, old.begin() + (i + 1) * old_e3,
+		          dense.begin() + i * new_e3);
+
+	return true;
+}
+
 std::string VarMapperBase::var2str(unsigned int var) const
 {
 	uint64_t key;
@@ -30,9 +100,10 @@ hashmap<unsigned int, std::string> VarMapperBase::get_translation_table() const
 {
 	hashmap<unsigned int, std::string> table;
 
-	foreach(map, kv)
+	for (unsigned int i = 0; i < keys.size(); i++)
 	{
-		table[kv->second] = key2str(kv->first, kv->second);
+		unsigned int var = start_var + i;
+		table[var] = key2str(keys[i], var);
 	}
 
 	return table;
@@ -0,0 +1,278 @@
+// Re-solve a corpus of LPs captured with set_lp_capture() under each LP
+// solver back end and report how long each back end took.
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "linprog/model.h"
+#include "linprog/solver.h"
+#include "linprog/export.h"
+
+using namespace std;
+
+struct SolverStats
+{
+	unsigned int solved, failed, mismatched;
+	double total_ms, max_ms;
+
+	SolverStats() : solved(0), failed(0), mismatched(0), total_ms(0), max_ms(0)
+	{}
+};
+
+static const char *solver_name(lp_solver_t solver)
+{
+	switch (solver)
+	{
+		case LP_SOLVER_AUTO:
+			return "auto";
+		case LP_SOLVER_NATIVE:
+			return "native";
+		case LP_SOLVER_GLPK:
+			return "glpk";
+		case LP_SOLVER_CPLEX:
+			return "cplex";
+		default:
+			return "???";
+	}
+}
+
+static bool parse_solver(const char *name, lp_solver_t &solver)
+{
+	static const lp_solver_t all[] = {
+		LP_SOLVER_AUTO, LP_SOLVER_NATIVE, LP_SOLVER_GLPK, LP_SOLVER_CPLEX
+	};
+
+	for (unsigned int i = 0; i < sizeof(all) / sizeof(all[0]); i++)
+		if (string(name) == solver_name(all[i]))
+		{
+			solver = all[i];
+			return true;
+		}
+	return false;
+}
+
+static void usage(const char *prog)
+{
+	cerr << "Usage: " << prog << " [-s SOLVER]... [-r REPEAT] [-n] [-q] FILE.mps..."
+	     << endl
+	     << "  -s SOLVER  back end to use: auto, native, glpk, or cplex;" << endl
+	     << "             may be repeated (default: all available back ends)"
+	     << endl
+	     << "  -r REPEAT  solve each LP REPEAT times and keep the fastest run"
+	     << endl
+	     << "  -n         disable the presolve step" << endl
+	     << "  -q         only print the summary" << endl;
+	exit(1);
+}
+
+// Returns the wall-clock time of the fastest of num_repeats runs in
+// milliseconds, or a negative value if the LP could not be solved.
+static double time_solve(const LinearProgram &lp, unsigned int num_vars,
+                         unsigned int num_repeats, double &objective)
+{
+	double best_ms = -1;
+
+	for (unsigned int k = 0; k < num_repeats; k++)
+	{
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		Solution *sol = linprog_solve(lp, num_vars);
+		chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+		if (!sol)
+			return -1;
+
+		objective = sol->evaluate(*lp.get_objective());
+		delete sol;
+
+		double ms = chrono::duration<double, milli>(end - start).count();
+		if (best_ms < 0 || ms < best_ms)
+			best_ms = ms;
+	}
+
+	return best_ms;
+}
+
+int main(int argc, char **argv)
+{
+	vector<lp_solver_t> solvers;
+	unsigned int num_repeats = 1;
+	bool quiet = false;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "s:r:nq")) != -1)
+	{
+		lp_solver_t solver;
+
+		switch (opt)
+		{
+			case 's':
+				if (!parse_solver(optarg, solver))
+				{
+					cerr << "Unknown solver: " << optarg << endl;
+					usage(argv[0]);
+				}
+				if (!is_lp_solver_available(solver))
+				{
+					cerr << "Solver not compiled in: " << optarg << endl;
+					return 1;
+				}
+				solvers.push_back(solver);
+				break;
+			case 'r':
+				num_repeats = max(atoi(optarg), 1);
+				break;
+			case 'n':
+				set_lp_presolve(false);
+				break;
+			case 'q':
+				quiet = true;
+				break;
+			default:
+				usage(argv[0]);
+		}
+	}
+
+	if (optind >= argc)
+		usage(argv[0]);
+
+	if (solvers.empty())
+	{
+		static const lp_solver_t backends[] = {
+			LP_SOLVER_NATIVE, LP_SOLVER_GLPK, LP_SOLVER_CPLEX
+		};
+		for (unsigned int i = 0; i < sizeof(backends) / sizeof(backends[0]); i++)
+			if (is_lp_solver_available(backends[i]))
+				solvers.push_back(backends[i]);
+	}
+
+	// stats per solver, overall and per analysis
+	vector<SolverStats> totals(solvers.size());
+	map<string, vector<SolverStats> > per_analysis;
+	unsigned int num_unreadable = 0;
+
+	cout << fixed << setprecision(3);
+
+	for (int arg = optind; arg < argc; arg++)
+	{
+		const char *path = argv[arg];
+		ifstream in(path);
+		LinearProgramTags tags;
+		unsigned int num_vars;
+		string error;
+
+		LinearProgram *lp = in ? read_mps(in, num_vars, error, &tags) : NULL;
+		if (!lp)
+		{
+			cerr << path << ": " << (in ? error : "cannot open file") << endl;
+			num_unreadable++;
+			continue;
+		}
+
+		const string analysis = tags.count("analysis") ?
+			tags["analysis"] : "unknown";
+		vector<SolverStats> &stats = per_analysis[analysis];
+		stats.resize(solvers.size());
+
+		if (!quiet)
+			cout << path << " [" << analysis
+			     << ", rows=" << lp->get_num_rows()
+			     << ", cols=" << num_vars
+			     << ", ints=" << lp->get_integer_variables().size() +
+			                     lp->get_binary_variables().size()
+			     << "]";
+
+		bool have_reference = false;
+		double reference = 0;
+
+		for (unsigned int s = 0; s < solvers.size(); s++)
+		{
+			double objective = 0;
+
+			set_lp_solver(solvers[s]);
+			double ms = time_solve(*lp, num_vars, num_repeats, objective);
+
+			if (ms < 0)
+			{
+				totals[s].failed++;
+				stats[s].failed++;
+				if (!quiet)
+					cout << "  " << solver_name(solvers[s]) << ": FAILED";
+				continue;
+			}
+
+			// all back ends should agree on the optimal objective value
+			bool mismatch = have_reference &&
+				fabs(objective - reference) >
+				1e-6 * max(1.0, fabs(reference));
+			if (!have_reference)
+			{
+				reference = objective;
+				have_reference = true;
+			}
+
+			SolverStats *both[] = { &totals[s], &stats[s] };
+			for (unsigned int k = 0; k < 2; k++)
+			{
+				both[k]->solved++;
+				both[k]->mismatched += mismatch;
+				both[k]->total_ms += ms;
+				both[k]->max_ms = max(both[k]->max_ms, ms);
+			}
+
+			if (!quiet)
+				cout << "  " << solver_name(solvers[s])
+				     << ": obj=" << objective << " " << ms << "ms"
+				     << (mismatch ? " MISMATCH" : "");
+		}
+
+		if (!quiet)
+			cout << endl;
+
+		delete lp;
+	}
+
+	cout << endl << "Summary (wall-clock time in ms";
+	if (num_repeats > 1)
+		cout << ", fastest of " << num_repeats << " runs";
+	cout << "):" << endl;
+
+	for (unsigned int s = 0; s < solvers.size(); s++)
+	{
+		const SolverStats &st = totals[s];
+		cout << "  " << setw(6) << solver_name(solvers[s])
+		     << ": solved=" << st.solved
+		     << " failed=" << st.failed
+		     << " mismatched=" << st.mismatched
+		     << " total=" << st.total_ms
+		     << " mean=" << st.total_ms / max(st.solved, 1u)
+		     << " max=" << st.max_ms << endl;
+	}
+
+	foreach(per_analysis, entry)
+	{
+		cout << "  " << entry->first << ":" << endl;
+		for (unsigned int s = 0; s < solvers.size(); s++)
+		{
+			const SolverStats &st = entry->second[s];
+			cout << "    " << setw(6) << solver_name(solvers[s])
+			     << ": solved=" << st.solved
+			     << " failed=" << st.failed
+			     << " total=" << st.total_ms
+			     << " max=" << st.max_ms << endl;
+		}
+	}
+
+	if (num_unreadable)
+		cout << "  (" << num_unreadable << " unreadable files skipped)" << endl;
+
+	return num_unreadable ? 1 : 0;
+}
@@ -2,11 +2,14 @@
 #include <string.h>
 
 #include <vector>
+#include <atomic>
 
 #include <iostream>
 
 #include "tasks.h"
+#include "demand_kernel.h"
 #include "task_io.h"
+#include "analysis_budget.h"
 
 void Task::init(unsigned long wcet,
                 unsigned long period,
@@ -150,8 +153,34 @@ unsigned long TaskSet::k_for_epsilon(unsigned int idx,
     return (unsigned long) ceil(std::max(0.0, bound.get_d()));
 }
 
+void TaskSet::bound_demand(const fixed_integral_t &time, fixed_integral_t &demand) const
+{
+	fixed_integral_t task_demand;
+	demand = 0;
+	for (unsigned int i = 0; i < tasks.size(); i++)
+	{
+		tasks[i].bound_demand(time, task_demand);
+		demand += task_demand;
+	}
+}
+
 void TaskSet::bound_demand(const integral_t &time, integral_t &demand) const
 {
+	// Usually, the demand fits into 64 bits, and only the result needs GMP.
+	if (time.fits_slong_p())
+	{
+		try
+		{
+			fixed_integral_t fixed_demand;
+			bound_demand(fixed_integral_t(time), fixed_demand);
+			demand = fixed_demand.get_si();
+			return;
+		}
+		catch (const fixed_width_overflow &)
+		{
+		}
+	}
+
 	integral_t task_demand;
 	demand = 0;
 	for (unsigned int i = 0; i < tasks.size(); i++)
@@ -161,7 +190,42 @@ void TaskSet::bound_demand(const integral_t &time, integral_t &demand) const
 	}
 }
 
-void TaskSet::approx_load(fractional_t &load, const fractional_t &epsilon) const
+static std::atomic<int> fixed_width_mode(FIXED_WIDTH_FIRST);
+
+void set_fixed_width_mode(fixed_width_mode_t mode)
+{
+	fixed_width_mode = mode;
+}
+
+fixed_width_mode_t get_fixed_width_mode()
+{
+	return (fixed_width_mode_t) fixed_width_mode.load();
+}
+
+// approximate demand of all tasks at time (see Task::approx_demand)
+static void approx_demand(const TaskSet &ts,
+                          const std::vector<unsigned long> &k,
+                          const integral_t &time, integral_t &demand)
+{
+    integral_t tmp;
+
+    demand = 0;
+    for (unsigned int i = 0; i < ts.get_task_count(); i++)
+    {
+        ts[i].approx_demand(time, tmp, k[i]);
+        demand += tmp;
+    }
+}
+
+static void approx_demand(const DemandKernel &kernel,
+                          const integral_t &time, integral_t &demand)
+{
+    // throws fixed_width_overflow if the time or demand do not fit
+    demand = kernel.approx_dbf(fixed_integral_t(time)).get_si();
+}
+
+void TaskSet::approx_load(fractional_t &load, const fractional_t &epsilon,
+                          AnalysisBudget *budget) const
 {
     fractional_t density;
 
@@ -173,8 +237,7 @@ void TaskSet::approx_load(fractional_t &load, const fractional_t &epsilon) const
         // ok, actually have to do the work;
         load += epsilon;
 
-        std::vector<unsigned long> k;
-        k.reserve(tasks.size());
+        std::vector<unsigned long> k(tasks.size());
 
         unsigned long total_times = tasks.size();
 
@@ -184,8 +247,6 @@ void TaskSet::approx_load(fractional_t &load, const fractional_t &epsilon) const
             total_times += k[i];
         }
 
-        std::cout << "total_times = " << total_times << std::endl;
-
         std::vector<integral_t> times;
         times.reserve(total_times);
 
@@ -204,6 +265,15 @@ void TaskSet::approx_load(fractional_t &load, const fractional_t &epsilon) const
         // sort times
         std::sort(times.begin(), times.end());
 
+        // The approximate demand usually fits into 64 bits, and the kernel
+        // evaluates it for all tasks at once.
+        DemandKernel kernel(*this);
+        kernel.set_approximation(k.data());
+        bool use_kernel = true;
+
+        AnalysisBudget::Meter meter(budget);
+        unsigned long points = 0;
+
         // iterate through test points
         integral_t last = 0;
 
@@ -212,15 +282,35 @@ void TaskSet::approx_load(fractional_t &load, const fractional_t &epsilon) const
             // avoid redundant check
             if (times[t] > last)
             {
-                fractional_t load_at_point = 0;
-                fractional_t tmp;
+                // check for excessive run time every 10 test points
+                meter.charge();
+                if (++points % 10 == 0 && meter.exhausted())
+                {
+                    // give up; the density bounds the load, too
+                    load = density;
+                    return;
+                }
 
-                // compute approximate load at point
-                for (unsigned int i = 0; i < tasks.size(); i++)
+                // compute approximate load at point, i.e., the sum of
+                // the approximate demands divided by the time
+                integral_t demand;
+
+                if (use_kernel)
                 {
-                    tasks[i].approx_load(times[t], tmp, k[i]);
-                    load_at_point += tmp;
+                    try
+                    {
+                        approx_demand(kernel, times[t], demand);
+                    }
+                    catch (const fixed_width_overflow &)
+                    {
+                        use_kernel = false;
+                    }
                 }
+                if (!use_kernel)
+                    approx_demand(*this, k, times[t], demand);
+
+                fractional_t load_at_point(demand, times[t]);
+                load_at_point.canonicalize();
 
                 // check if we have a new maximum
 
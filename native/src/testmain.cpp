@@ -1,6 +1,11 @@
 #include <iostream>
+#include <math.h>
+#include <limits>
+#include <sstream>
+#include <thread>
 
 #include "tasks.h"
+#include "demand_kernel.h"
 #include "task_io.h"
 #include "schedulability.h"
 
@@ -13,14 +18,28 @@
 #include "edf/bcl.h"
 #include "edf/bcl_iterative.h"
 #include "edf/la.h"
+#include "edf/qpa.h"
+#include "edf/ffdbf.h"
+#include "edf/rta.h"
+#include "edf/load.h"
 #include "edf/gedf.h"
 #include "edf/sim.h"
 
 #include "lp_analysis.h"
+#include "lp_pedf_analysis.h"
 
 #include "linprog/model.h"
 #include "linprog/solver.h"
 #include "linprog/io.h"
+#include "linprog/simplex.h"
+#include "linprog/presolve.h"
+#include "linprog/export.h"
+#include "linprog/capture.h"
+#include "linprog/stats.h"
+
+#ifdef CONFIG_HAVE_GLPK
+#include "linprog/glpk.h"
+#endif
 
 #include "event.h"
 #include "schedule_sim.h"
@@ -592,11 +611,1903 @@ void test_linprog()
 
 }
 
+// The self-checking tests below report each failed check and make main()
+// return non-zero.
+static unsigned int num_failures = 0;
+
+static void check(bool ok, const string &what)
+{
+	if (!ok)
+	{
+		cout << "FAILED: " << what << endl;
+		num_failures++;
+	}
+}
+
+static bool same_value(double a, double b)
+{
+	return fabs(a - b) <= 1e-6 * max(1.0, fabs(a));
+}
+
+// objective of sol, or NAN if the LP was not solved
+static double objective(const LinearProgram &lp, Solution *sol)
+{
+	double obj = sol ? sol->evaluate(*lp.get_objective()) : NAN;
+	delete sol;
+	return obj;
+}
+
+static bool same_objective(double a, double b)
+{
+	return (isnan(a) && isnan(b)) || same_value(a, b);
+}
+
+// Stand-in for the blocking LPs of the P-EDF analyses at interval length
+// t: the right-hand sides grow with the job counts, and a lower bound on
+// the objective is only added for lb > 0, which changes the row count. A
+// large lb makes the LP infeasible.
+static LinearProgram *make_job_count_lp(unsigned long t, unsigned long lb,
+                                        bool integral)
+{
+	LinearProgram *lp = new LinearProgram();
+	const double njobs = (t + 9) / 10;
+
+	LinearExpression *obj = lp->get_objective();
+	obj->add_term(3, 0);
+	obj->add_term(2, 1);
+	obj->add_term(1, 2);
+	obj->add_term(4, 3);
+
+	for (unsigned int v = 0; v < 4; v++)
+	{
+		lp->declare_variable_bounds(v, true, 0, false, 0);
+		if (integral)
+			lp->declare_variable_integer(v);
+	}
+
+	LinearExpression *exp = new LinearExpression();
+	exp->add_var(0);
+	exp->add_var(1);
+	lp->add_inequality(exp, njobs);
+
+	exp = new LinearExpression();
+	exp->add_var(1);
+	exp->add_term(2, 2);
+	exp->add_term(2, 3);
+	lp->add_inequality(exp, 2 * njobs + 1);
+
+	exp = new LinearExpression();
+	exp->add_var(0);
+	exp->sub_var(3);
+	lp->add_inequality(exp, 1);
+
+	if (lb > 0)
+	{
+		exp = new LinearExpression();
+		foreach(lp->get_objective()->get_terms(), term)
+			exp->sub_term(term->first, term->second);
+		lp->add_inequality(exp, -(double) lb);
+	}
+
+	return lp;
+}
+
+// A session must return the same optimum as a cold solve of each LP,
+// including after an infeasible LP, after which the warm start fails and
+// the session retries from a fresh basis.
+static void test_session(LinearProgramSession *session, const string &name,
+                         bool integral)
+{
+	const unsigned long steps[][2] = {
+		{100, 0}, {90, 0}, {90, 10}, {60, 10}, {60, 1000},
+		{50, 0}, {55, 5}, {150, 0}, {10, 0}, {10, 200}, {30, 0},
+	};
+
+	for (unsigned int i = 0; i < sizeof(steps) / sizeof(steps[0]); i++)
+	{
+		LinearProgram *lp = make_job_count_lp(steps[i][0], steps[i][1],
+		                                      integral);
+		const double warm = objective(*lp, session->solve(*lp, 4));
+		const double cold = objective(*lp, linprog_solve(*lp, 4));
+
+		ostringstream what;
+		what << name << (integral ? " ILP " : " LP ") << i
+		     << ": session " << warm << " vs. cold " << cold;
+		check(same_objective(warm, cold), what.str());
+
+		delete lp;
+	}
+
+	delete session;
+}
+
+void test_linprog_sessions()
+{
+	for (int integral = 0; integral < 2; integral++)
+	{
+		test_session(linprog_create_session(), "dispatching session",
+		             integral);
+		test_session(simplex_create_session(), "simplex session",
+		             integral);
+#ifdef CONFIG_HAVE_GLPK
+		test_session(glpk_create_session(), "GLPK session", integral);
+#endif
+	}
+}
+
+static const double INF = numeric_limits<double>::infinity();
+
+// add sum_k coeffs[k] * x_k (k < num_vars) as an inequality or equality row
+static void add_row(LinearProgram &lp, unsigned int num_vars,
+                    const double *coeffs, double bound, bool equality = false)
+{
+	LinearExpression *exp = new LinearExpression();
+	for (unsigned int k = 0; k < num_vars; k++)
+		if (coeffs[k])
+			exp->add_term(coeffs[k], k);
+	if (equality)
+		lp.add_equality(exp, bound);
+	else
+		lp.add_inequality(exp, bound);
+}
+
+static void set_objective(LinearProgram &lp, unsigned int num_vars,
+                          const double *coeffs)
+{
+	for (unsigned int k = 0; k < num_vars; k++)
+		if (coeffs[k])
+			lp.get_objective()->add_term(coeffs[k], k);
+}
+
+// variable k ranges over [lb, ub]; infinite bounds mean none
+static void set_bounds(LinearProgram &lp, unsigned int k, double lb, double ub)
+{
+	lp.declare_variable_bounds(k, lb > -INF, lb > -INF ? lb : 0,
+	                           ub < INF, ub < INF ? ub : 0);
+}
+
+struct LPTestCase
+{
+	string name;
+	LinearProgram *lp;
+	unsigned int num_vars;
+	simplex_status_t status;
+	double optimum;
+};
+
+// Small LPs and ILPs with known optima, covering the outcomes of the
+// built-in solver and all kinds of variable bounds. The integer variables
+// have the default range [0, inf) since GLPKSolution ignores their bounds.
+static vector<LPTestCase> make_lp_test_cases()
+{
+	vector<LPTestCase> cases;
+	LPTestCase c;
+
+	{
+		// default bounds [0, 1]
+		c.name = "feasible LP";
+		c.lp = new LinearProgram();
+		c.num_vars = 3;
+		const double obj[] = {1, 2, 3}, row[] = {1, 1, 1};
+		set_objective(*c.lp, 3, obj);
+		add_row(*c.lp, 3, row, 2);
+		c.status = SIMPLEX_OPTIMAL;
+		c.optimum = 5;
+		cases.push_back(c);
+	}
+
+	{
+		c.name = "infeasible LP";
+		c.lp = new LinearProgram();
+		c.num_vars = 2;
+		const double obj[] = {1, 1}, row[] = {1, 1};
+		set_objective(*c.lp, 2, obj);
+		add_row(*c.lp, 2, row, 3, true);
+		c.status = SIMPLEX_INFEASIBLE;
+		c.optimum = NAN;
+		cases.push_back(c);
+	}
+
+	{
+		c.name = "unbounded LP";
+		c.lp = new LinearProgram();
+		c.num_vars = 2;
+		const double obj[] = {1, 0}, row[] = {1, -1};
+		set_objective(*c.lp, 2, obj);
+		add_row(*c.lp, 2, row, 1);
+		set_bounds(*c.lp, 0, 0, INF);
+		set_bounds(*c.lp, 1, 0, INF);
+		c.status = SIMPLEX_UNBOUNDED;
+		c.optimum = NAN;
+		cases.push_back(c);
+	}
+
+	{
+		// Beale's example, on which the textbook simplex method cycles
+		c.name = "degenerate LP";
+		c.lp = new LinearProgram();
+		c.num_vars = 4;
+		const double obj[] = {0.75, -20, 0.5, -6};
+		const double row1[] = {0.25, -8, -1, 9};
+		const double row2[] = {0.5, -12, -0.5, 3};
+		const double row3[] = {0, 0, 1, 0};
+		set_objective(*c.lp, 4, obj);
+		add_row(*c.lp, 4, row1, 0);
+		add_row(*c.lp, 4, row2, 0);
+		add_row(*c.lp, 4, row3, 1);
+		for (unsigned int k = 0; k < 4; k++)
+			set_bounds(*c.lp, k, 0, INF);
+		c.status = SIMPLEX_OPTIMAL;
+		c.optimum = 1.25;
+		cases.push_back(c);
+	}
+
+	{
+		// x0 in [-5, 3], x1 free, x2 fixed to 2, x3 in (-inf, 4]:
+		// x0 + x1 <= 4 and x3 <= 4 bound the objective by 4 - 2 + 4
+		c.name = "bounded, free, and fixed variables";
+		c.lp = new LinearProgram();
+		c.num_vars = 4;
+		const double obj[] = {1, 1, -1, 1};
+		const double row1[] = {1, 1, 0, 0}, row2[] = {-1, 1, 0, 0};
+		const double row3[] = {0, 1, 1, 1};
+		set_objective(*c.lp, 4, obj);
+		add_row(*c.lp, 4, row1, 4);
+		add_row(*c.lp, 4, row2, 10);
+		add_row(*c.lp, 4, row3, 20);
+		set_bounds(*c.lp, 0, -5, 3);
+		set_bounds(*c.lp, 1, -INF, INF);
+		set_bounds(*c.lp, 2, 2, 2);
+		set_bounds(*c.lp, 3, -INF, 4);
+		c.status = SIMPLEX_OPTIMAL;
+		c.optimum = 6;
+		cases.push_back(c);
+	}
+
+	{
+		// the optimum requires a negative value of a free variable
+		c.name = "negative free variable";
+		c.lp = new LinearProgram();
+		c.num_vars = 2;
+		const double obj[] = {-1, 1}, row1[] = {-1, 0}, row2[] = {1, 1};
+		set_objective(*c.lp, 2, obj);
+		add_row(*c.lp, 2, row1, 3);
+		add_row(*c.lp, 2, row2, -2, true);
+		set_bounds(*c.lp, 0, -INF, INF);
+		set_bounds(*c.lp, 1, -INF, INF);
+		c.status = SIMPLEX_OPTIMAL;
+		// x0 = -3, x1 = 1
+		c.optimum = 4;
+		cases.push_back(c);
+	}
+
+	{
+		// LP relaxation: 1.5
+		c.name = "integer program";
+		c.lp = new LinearProgram();
+		c.num_vars = 2;
+		const double obj[] = {1, 1}, row[] = {2, 2};
+		set_objective(*c.lp, 2, obj);
+		add_row(*c.lp, 2, row, 3);
+		c.lp->declare_variable_integer(0);
+		c.lp->declare_variable_integer(1);
+		c.status = SIMPLEX_OPTIMAL;
+		c.optimum = 1;
+		cases.push_back(c);
+	}
+
+	{
+		// 0-1 knapsack: items 0 and 1 fill the capacity exactly
+		c.name = "binary program";
+		c.lp = new LinearProgram();
+		c.num_vars = 4;
+		const double obj[] = {10, 13, 7, 8}, row[] = {4, 6, 3, 5};
+		set_objective(*c.lp, 4, obj);
+		add_row(*c.lp, 4, row, 10);
+		for (unsigned int k = 0; k < 4; k++)
+			c.lp->declare_variable_binary(k);
+		c.status = SIMPLEX_OPTIMAL;
+		c.optimum = 23;
+		cases.push_back(c);
+	}
+
+	{
+		// x0 integral, x1 continuous; LP relaxation: 11.5 at (2.5, 2)
+		c.name = "mixed-integer program";
+		c.lp = new LinearProgram();
+		c.num_vars = 2;
+		const double obj[] = {3, 2}, row1[] = {1, 1}, row2[] = {1, -1};
+		set_objective(*c.lp, 2, obj);
+		add_row(*c.lp, 2, row1, 4.5);
+		add_row(*c.lp, 2, row2, 0.5);
+		c.lp->declare_variable_integer(0);
+		set_bounds(*c.lp, 1, 0, INF);
+		c.status = SIMPLEX_OPTIMAL;
+		c.optimum = 11;
+		cases.push_back(c);
+	}
+
+	{
+		// the LP relaxation is feasible (x0 = 0.5)
+		c.name = "infeasible integer program";
+		c.lp = new LinearProgram();
+		c.num_vars = 1;
+		const double obj[] = {1}, row[] = {2};
+		set_objective(*c.lp, 1, obj);
+		add_row(*c.lp, 1, row, 1, true);
+		c.lp->declare_variable_integer(0);
+		c.status = SIMPLEX_INFEASIBLE;
+		c.optimum = NAN;
+		cases.push_back(c);
+	}
+
+	return cases;
+}
+
+// effective variable ranges, with the conventions of the back ends
+static void get_var_bounds(const LinearProgram &lp, unsigned int num_vars,
+                           vector<double> &lb, vector<double> &ub)
+{
+	lb.assign(num_vars, 0);
+	ub.assign(num_vars, 1);
+	foreach(lp.get_non_default_variable_ranges(), b)
+	{
+		lb[b->variable_id] = b->has_lower ? b->lower_bound : -INF;
+		ub[b->variable_id] = b->has_upper ? b->upper_bound : INF;
+	}
+	foreach(lp.get_integer_variables(), v)
+	{
+		lb[*v] = 0;
+		ub[*v] = INF;
+	}
+	foreach(lp.get_binary_variables(), v)
+	{
+		lb[*v] = 0;
+		ub[*v] = 1;
+	}
+}
+
+// Does sol satisfy all rows, bounds, and integrality constraints of lp?
+static bool is_feasible(const LinearProgram &lp, unsigned int num_vars,
+                        const Solution &sol)
+{
+	const double tol = 1e-6;
+
+	for (int equ = 0; equ < 2; equ++)
+	{
+		const SparseRows &rows = equ ? lp.get_equalities()
+		                             : lp.get_inequalities();
+		for (unsigned int r = 0; r < rows.size(); r++)
+		{
+			double sum = 0;
+			for (unsigned int k = 0; k < rows.get_row_size(r); k++)
+				sum += rows.get_row_coeffs(r)[k] *
+				       sol.get_value(rows.get_row_vars(r)[k]);
+			if (sum > rows.get_bound(r) + tol ||
+			    (equ && sum < rows.get_bound(r) - tol))
+				return false;
+		}
+	}
+
+	vector<double> lb, ub;
+	get_var_bounds(lp, num_vars, lb, ub);
+
+	for (unsigned int k = 0; k < num_vars; k++)
+	{
+		const double x = sol.get_value(k);
+		if (x < lb[k] - tol || x > ub[k] + tol)
+			return false;
+		if ((lp.is_integer_variable(k) || lp.is_binary_variable(k)) &&
+		    fabs(x - floor(x + 0.5)) > tol)
+			return false;
+	}
+
+	return true;
+}
+
+void test_simplex()
+{
+	vector<LPTestCase> cases = make_lp_test_cases();
+
+	foreach(cases, c)
+	{
+		simplex_status_t status;
+		Solution *sol = simplex_solve(*c->lp, c->num_vars, &status);
+
+		check(status == c->status, "simplex status: " + c->name);
+		check((sol != NULL) == (c->status == SIMPLEX_OPTIMAL),
+		      "simplex solution: " + c->name);
+		if (sol)
+			check(is_feasible(*c->lp, c->num_vars, *sol),
+			      "simplex feasibility: " + c->name);
+
+		const double obj = objective(*c->lp, sol);
+		check(same_objective(obj, c->optimum),
+		      "simplex optimum: " + c->name);
+
+#ifdef CONFIG_HAVE_GLPK
+		const double glpk_obj = objective(*c->lp,
+			glpk_solve(*c->lp, c->num_vars));
+		check(same_objective(obj, glpk_obj), "simplex vs. GLPK: " + c->name);
+#endif
+
+		delete c->lp;
+	}
+
+	// Branch-and-bound gives up once it runs out of nodes, even if it
+	// has found an integral solution. The knapsack needs several nodes.
+	cases = make_lp_test_cases();
+	const unsigned long max_nodes = get_simplex_max_bb_nodes();
+	set_simplex_max_bb_nodes(2);
+
+	foreach(cases, c)
+	{
+		if (c->name == "binary program")
+		{
+			simplex_status_t status;
+			Solution *sol = simplex_solve(*c->lp, c->num_vars, &status);
+			check(!sol && status == SIMPLEX_NODE_LIMIT,
+			      "simplex node limit: " + c->name);
+			delete sol;
+		}
+		delete c->lp;
+	}
+
+	set_simplex_max_bb_nodes(max_nodes);
+
+	// Pruning must not be relative to the incumbent: with the incumbent
+	// 1e7 + 2 (x0 = x2 = 1), the branch x2 = 0 still gains one unit.
+	{
+		LinearProgram lp;
+		const double obj[] = {1e7, 3, 2}, row[] = {0, 2, 3};
+		set_objective(lp, 3, obj);
+		add_row(lp, 3, row, 4);
+		for (unsigned int k = 0; k < 3; k++)
+			lp.declare_variable_binary(k);
+
+		simplex_status_t status;
+		Solution *sol = simplex_solve(lp, 3, &status);
+		check(status == SIMPLEX_OPTIMAL &&
+		      fabs(objective(lp, sol) - (1e7 + 3)) < 0.5,
+		      "simplex optimum: large incumbent");
+	}
+
+	// LPs beyond the row limit are refused, since the basis inverse is
+	// dense; an explicit choice of the built-in solver then falls back.
+	{
+		LinearProgram lp;
+		const double obj[] = {1, 1}, row1[] = {1, 0}, row2[] = {0, 1};
+		set_objective(lp, 2, obj);
+		add_row(lp, 2, row1, 1);
+		add_row(lp, 2, row2, 1);
+
+		const unsigned int max_rows = get_simplex_max_rows();
+		const lp_solver_t selected = get_lp_solver();
+		set_simplex_max_rows(1);
+		set_lp_solver(LP_SOLVER_NATIVE);
+
+		simplex_status_t status;
+		Solution *sol = simplex_solve(lp, 2, &status);
+		check(!sol && status == SIMPLEX_TOO_LARGE, "simplex row limit");
+		delete sol;
+
+		LinearProgramSession *session = simplex_create_session(&status);
+		sol = session->solve(lp, 2);
+		check(!sol && status == SIMPLEX_TOO_LARGE,
+		      "simplex row limit: session");
+		delete session;
+
+		const bool have_external = is_lp_solver_available(LP_SOLVER_GLPK) ||
+		                           is_lp_solver_available(LP_SOLVER_CPLEX);
+		check((linprog_choose_solver(lp, 2) != LP_SOLVER_NATIVE) ==
+		      have_external, "simplex row limit: dispatch");
+
+		set_lp_solver(selected);
+		set_simplex_max_rows(max_rows);
+	}
+}
+
+// With LP_SOLVER_AUTO, an ILP on which the built-in solver fails (here, by
+// exceeding the branch-and-bound node limit) must be solved by the
+// external back end, if one is compiled in.
+void test_solver_fallback()
+{
+	vector<LPTestCase> cases = make_lp_test_cases();
+	const lp_solver_t selected = get_lp_solver();
+	const unsigned long max_nodes = get_simplex_max_bb_nodes();
+	const bool have_external = is_lp_solver_available(LP_SOLVER_GLPK) ||
+	                           is_lp_solver_available(LP_SOLVER_CPLEX);
+
+	set_lp_solver(LP_SOLVER_AUTO);
+	set_simplex_max_bb_nodes(2);
+
+	foreach(cases, c)
+	{
+		if (c->name == "binary program")
+		{
+			check(linprog_choose_solver(*c->lp, c->num_vars) ==
+			      LP_SOLVER_NATIVE, "fallback: built-in solver chosen");
+
+			const double expected = have_external ? c->optimum : NAN;
+
+			double obj = objective(*c->lp,
+			                       linprog_solve(*c->lp, c->num_vars));
+			check(same_objective(obj, expected), "fallback: linprog_solve");
+
+			LinearProgramSession *session = linprog_create_session();
+			obj = objective(*c->lp, session->solve(*c->lp, c->num_vars));
+			check(same_objective(obj, expected), "fallback: session");
+			delete session;
+		}
+		delete c->lp;
+	}
+
+	set_simplex_max_bb_nodes(max_nodes);
+	set_lp_solver(selected);
+}
+
+// Solve lp with and without presolve; the optima must agree (or both be
+// missing), and the restored solution must be feasible.
+static void check_presolve(const string &name, LinearProgram &lp,
+                           unsigned int num_vars, double optimum)
+{
+	const bool presolve = get_lp_presolve();
+
+	set_lp_presolve(true);
+	Solution *sol = linprog_solve(lp, num_vars);
+	if (sol)
+		check(is_feasible(lp, num_vars, *sol),
+		      "presolve feasibility: " + name);
+	const double with = objective(lp, sol);
+
+	set_lp_presolve(false);
+	const double without = objective(lp, linprog_solve(lp, num_vars));
+
+	set_lp_presolve(presolve);
+
+	check(same_objective(with, without), "presolve on vs. off: " + name);
+	check(same_objective(with, optimum), "presolve optimum: " + name);
+}
+
+void test_presolve()
+{
+	{
+		// x2 is fixed to 2 and substituted into the row
+		LinearProgram lp;
+		const double obj[] = {1, 2, 1}, row[] = {1, 1, 1};
+		set_objective(lp, 3, obj);
+		add_row(lp, 3, row, 3.5);
+		set_bounds(lp, 2, 2, 2);
+
+		PresolvedLinearProgram presolved(lp, 3);
+		check(presolved.get_num_reduced_vars() == 2 &&
+		      presolved.get_reduced().get_num_rows() == 1,
+		      "presolve removes fixed variable");
+		check_presolve("fixed variable", lp, 3, 4.5);
+	}
+
+	{
+		// 2 x0 <= 1 becomes the bound x0 <= 0.5
+		LinearProgram lp;
+		const double obj[] = {3, 1}, row1[] = {2, 0}, row2[] = {1, 1};
+		set_objective(lp, 2, obj);
+		add_row(lp, 2, row1, 1);
+		add_row(lp, 2, row2, 1.2);
+
+		PresolvedLinearProgram presolved(lp, 2);
+		check(presolved.get_num_reduced_vars() == 2 &&
+		      presolved.get_reduced().get_num_rows() == 1,
+		      "presolve turns singleton row into bound");
+		check_presolve("singleton row", lp, 2, 2.2);
+	}
+
+	{
+		// the first row is dominated by the second, and the third
+		// cannot be violated within the default bounds
+		LinearProgram lp;
+		const double obj[] = {1, 1, 1};
+		const double row1[] = {1, 1, 0}, row3[] = {1, 1, 1};
+		set_objective(lp, 3, obj);
+		add_row(lp, 3, row1, 1.5);
+		add_row(lp, 3, row1, 1.2);
+		add_row(lp, 3, row3, 5);
+
+		PresolvedLinearProgram presolved(lp, 3);
+		check(presolved.get_reduced().get_num_rows() == 1,
+		      "presolve merges duplicate and drops redundant rows");
+		check_presolve("duplicate and redundant rows", lp, 3, 2.2);
+	}
+
+	{
+		// x0 >= 2 contradicts the default bound x0 <= 1
+		LinearProgram lp;
+		const double obj[] = {1, 1}, row1[] = {-1, 0}, row2[] = {1, 1};
+		set_objective(lp, 2, obj);
+		add_row(lp, 2, row1, -2);
+		add_row(lp, 2, row2, 1.5);
+
+		check(PresolvedLinearProgram(lp, 2).is_infeasible(),
+		      "presolve detects infeasible bound");
+		check_presolve("infeasible bound", lp, 2, NAN);
+	}
+
+	{
+		// contradicting duplicate equalities
+		LinearProgram lp;
+		const double obj[] = {1, 1}, row[] = {1, 1};
+		set_objective(lp, 2, obj);
+		add_row(lp, 2, row, 1, true);
+		add_row(lp, 2, row, 1.5, true);
+
+		check(PresolvedLinearProgram(lp, 2).is_infeasible(),
+		      "presolve detects contradicting rows");
+		check_presolve("contradicting rows", lp, 2, NAN);
+	}
+
+	{
+		// 2 x0 = 1 fixes x0, which turns the second row into the bound
+		// x2 <= 0.2; then no row is left, and x1 and x2 are set to the
+		// bounds that their costs favor
+		LinearProgram lp;
+		const double obj[] = {1, 3, 1};
+		const double row1[] = {2, 0, 0}, row2[] = {1, 0, 1};
+		set_objective(lp, 3, obj);
+		add_row(lp, 3, row1, 1, true);
+		add_row(lp, 3, row2, 0.7);
+
+		PresolvedLinearProgram presolved(lp, 3);
+		check(!presolved.is_infeasible() &&
+		      presolved.get_num_reduced_vars() == 0,
+		      "presolve eliminates all variables");
+		check_presolve("empty reduced LP", lp, 3, 3.7);
+	}
+}
+
+static bool same_rows(const SparseRows &a, const SparseRows &b)
+{
+	if (!a.same_matrix(b))
+		return false;
+	for (unsigned int r = 0; r < a.size(); r++)
+		if (a.get_bound(r) != b.get_bound(r))
+			return false;
+	return true;
+}
+
+// write_mps() followed by read_mps() must reproduce the program exactly
+void test_mps_round_trip()
+{
+	// x0 free, x1 fixed, x2 integer, x3 binary, x4 default [0, 1],
+	// x5 in [-3, 7], x6 in (-inf, 4], x7 unused; the terms of the third
+	// inequality cancel, which leaves an empty row before the last one
+	const unsigned int n = 8;
+	LinearProgram lp;
+	const double obj[] = {1, 1, 2, 3, 1, 1, 1, 0};
+	const double equ[] = {1, 1, 0, 0, -1, 0, 0, 0};
+	const double row1[] = {2, 0, 1, 3, 0, 0, 0, 0};
+	const double row2[] = {0, 0, 1, 0, 0, -1, 1, 0};
+	const double row3[] = {-1, 0, 1, 0, 0, 0, 0, 0};
+	set_objective(lp, n, obj);
+	add_row(lp, n, equ, 1.5, true);
+	add_row(lp, n, row1, 10.25);
+	add_row(lp, n, row2, 8);
+	LinearExpression *empty = new LinearExpression();
+	empty->add_term(1, 5);
+	empty->add_term(-1, 5);
+	lp.add_inequality(empty, 3);
+	add_row(lp, n, row3, 4);
+	set_bounds(lp, 0, -INF, INF);
+	set_bounds(lp, 1, 2.5, 2.5);
+	lp.declare_variable_integer(2);
+	lp.declare_variable_binary(3);
+	set_bounds(lp, 5, -3, 7);
+	set_bounds(lp, 6, -INF, 4);
+
+	LinearProgramTags tags;
+	tags["analysis"] = "test_mps_round_trip";
+
+	stringstream mps;
+	write_mps(mps, lp, n, tags);
+
+	unsigned int num_vars = 0;
+	string error;
+	LinearProgramTags read_tags;
+	LinearProgram *copy = read_mps(mps, num_vars, error, &read_tags);
+
+	check(copy != NULL, "MPS round trip: parse error: " + error);
+	if (!copy)
+		return;
+
+	check(num_vars == n, "MPS round trip: number of variables");
+	check(read_tags == tags, "MPS round trip: tags");
+	check(same_rows(copy->get_equalities(), lp.get_equalities()),
+	      "MPS round trip: equalities");
+	check(same_rows(copy->get_inequalities(), lp.get_inequalities()),
+	      "MPS round trip: inequalities");
+
+	vector<double> lb, ub, copy_lb, copy_ub;
+	get_var_bounds(lp, n, lb, ub);
+	get_var_bounds(*copy, n, copy_lb, copy_ub);
+	check(lb == copy_lb && ub == copy_ub, "MPS round trip: bounds");
+
+	bool same_kinds = true;
+	for (unsigned int j = 0; j < n; j++)
+		same_kinds = same_kinds &&
+			lp.is_integer_variable(j) == copy->is_integer_variable(j) &&
+			lp.is_binary_variable(j) == copy->is_binary_variable(j);
+	check(same_kinds, "MPS round trip: integrality");
+
+	vector<double> coeffs(n, 0), copy_coeffs(n, 0);
+	foreach(lp.get_objective()->get_terms(), term)
+		coeffs[term->second] += term->first;
+	foreach(copy->get_objective()->get_terms(), term)
+		copy_coeffs[term->second] += term->first;
+	check(coeffs == copy_coeffs, "MPS round trip: objective");
+
+	// an LP file must not contain constraints without terms
+	stringstream cplex_lp;
+	write_cplex_lp(cplex_lp, lp, n);
+	check(cplex_lp.str().find(": <=") == string::npos,
+	      "LP export: empty row");
+
+	const double optimum = objective(lp, linprog_solve(lp, n));
+	check(!isnan(optimum) &&
+	      same_objective(optimum, objective(*copy, linprog_solve(*copy, n))),
+	      "MPS round trip: optimum");
+
+	delete copy;
+}
+
+
+static void solve_job_count_lps(const char *analysis, unsigned int count)
+{
+	LinearProgramOriginScope origin(analysis);
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		LinearProgram *lp = make_job_count_lp(10 * (i + 1), 0, false);
+		delete linprog_solve(*lp, 4);
+		delete lp;
+	}
+}
+
+void test_lp_stats()
+{
+	static const char *workers = "test_lp_stats_workers";
+	static const char *caller = "test_lp_stats_caller";
+
+	reset_lp_stats();
+
+	// the workers exit before the counters are queried
+	vector<thread> threads;
+	for (unsigned int i = 0; i < 4; i++)
+		threads.push_back(thread(solve_job_count_lps, workers, 5));
+	foreach(threads, t)
+		t->join();
+
+	solve_job_count_lps(caller, 3);
+
+	check(get_lp_stats(workers).num_lps == 20,
+	      "LP stats: LPs of exited threads");
+	check(get_lp_stats(caller).num_lps == 3,
+	      "LP stats: LPs of the calling thread");
+	check(get_lp_stats().num_lps == 23, "LP stats: total");
+
+	bool listed_workers = false, listed_caller = false;
+	for (unsigned int i = 0; i < get_lp_stats_num_analyses(); i++)
+	{
+		const string name = get_lp_stats_analysis(i);
+		listed_workers |= name == workers;
+		listed_caller |= name == caller;
+	}
+	check(listed_workers && listed_caller, "LP stats: analyses listed");
+
+	reset_lp_stats();
+	check(get_lp_stats().num_lps == 0 && get_lp_stats(workers).num_lps == 0,
+	      "LP stats: reset");
+}
+
+
+// two tasks on each of four processors that share three spin locks
+static ResourceSharingInfo *make_spinlock_task_set()
+{
+	ResourceSharingInfo *info = new ResourceSharingInfo(8);
+
+	for (unsigned int c = 0; c < 4; c++)
+	{
+		info->add_task(100 + 10 * c, 100 + 10 * c, c, 2 * c, 20);
+		info->add_request(c % 3, 2, 3 + c);
+		info->add_request((c + 1) % 3, 1, 2);
+
+		info->add_task(250 + 30 * c, 250 + 30 * c, c, 2 * c + 1, 40);
+		info->add_request(c % 3, 3, 1 + c);
+		info->add_request(2, 1, 5);
+	}
+
+	return info;
+}
+
+typedef BlockingBounds* (*spinlock_analysis_t)(const ResourceSharingInfo&,
+                                               const BlockingThresholds*);
+
+void test_blocking_thresholds()
+{
+	struct {
+		const char *name;
+		spinlock_analysis_t analysis;
+	} analyses[] = {
+		{"msrp", [](const ResourceSharingInfo &info,
+		            const BlockingThresholds *t) {
+			return lp_pfp_msrp_bounds(info, t); }},
+		{"preemptive fifo", [](const ResourceSharingInfo &info,
+		                       const BlockingThresholds *t) {
+			return lp_pfp_preemptive_fifo_spinlock_bounds(info, t); }},
+		{"unordered", [](const ResourceSharingInfo &info,
+		                 const BlockingThresholds *t) {
+			return lp_pfp_unordered_spinlock_bounds(info, false, t); }},
+		{"prio", [](const ResourceSharingInfo &info,
+		            const BlockingThresholds *t) {
+			return lp_pfp_prio_spinlock_bounds(info, true, t); }},
+		{"prio fifo", [](const ResourceSharingInfo &info,
+		                 const BlockingThresholds *t) {
+			return lp_pfp_prio_fifo_spinlock_bounds(info, false, t); }},
+		{"baseline", [](const ResourceSharingInfo &info,
+		                const BlockingThresholds *t) {
+			return lp_pfp_baseline_spinlock_bounds(info, t); }},
+	};
+
+	ResourceSharingInfo *info = make_spinlock_task_set();
+	const unsigned int n = info->get_tasks().size();
+	const bool merge = get_lp_merge_task_lps();
+
+	for (unsigned int a = 0; a < sizeof(analyses) / sizeof(analyses[0]); a++)
+	{
+		BlockingBounds *exact = analyses[a].analysis(*info, NULL);
+
+		// loose thresholds are usually decided by the relaxation alone,
+		// tight ones never (unless the relaxation is integral)
+		BlockingThresholds thresholds(n);
+		for (unsigned int i = 0; i < n; i++)
+			thresholds.set_threshold(i, i % 2 ?
+				exact->get_blocking_term(i) :
+				2 * exact->get_blocking_term(i) + 50);
+
+		for (int merged = 0; merged < 2; merged++)
+		{
+			set_lp_merge_task_lps(merged);
+			BlockingBounds *relaxed =
+				analyses[a].analysis(*info, &thresholds);
+
+			for (unsigned int i = 0; i < n; i++)
+			{
+				ostringstream what;
+				what << "thresholds: " << analyses[a].name
+				     << (merged ? " (merged)" : "")
+				     << " task " << i << ": "
+				     << relaxed->get_blocking_term(i)
+				     << " vs. exact "
+				     << exact->get_blocking_term(i)
+				     << " and threshold "
+				     << thresholds.get_threshold(i);
+				check(relaxed->get_blocking_term(i) >=
+				      exact->get_blocking_term(i) &&
+				      relaxed->get_blocking_term(i) <=
+				      thresholds.get_threshold(i), what.str());
+			}
+
+			delete relaxed;
+		}
+
+		delete exact;
+	}
+
+	set_lp_merge_task_lps(merge);
+	delete info;
+}
+
+
+// deterministic pseudo-random numbers, so that the test cases are fixed
+class TestRandom
+{
+	unsigned long state;
+
+public:
+	TestRandom(unsigned long seed) : state(seed * 2654435761UL + 12345) {}
+
+	// uniform in [0, range)
+	unsigned long operator()(unsigned long range)
+	{
+		state = state * 6364136223846793005UL + 1442695040888963407UL;
+		return (state >> 33) % range;
+	}
+};
+
+// A fixed pseudo-random task set on two processors that share three spin
+// locks, with constrained deadlines.
+static ResourceSharingInfo *make_pedf_task_set(unsigned int seed)
+{
+	TestRandom next(seed);
+
+	const unsigned int n = 4 + next(5);
+	ResourceSharingInfo *info = new ResourceSharingInfo(n);
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		const unsigned long period = 20 + next(60);
+		const unsigned long cost = 1 + next(period / 3);
+		info->add_task(period, period, i % 2, i, cost,
+		               period - next(period / 4));
+		info->add_request(next(3), 1 + next(2), 1 + next(2));
+		if (next(2))
+			info->add_request(2, 1, 1 + next(2));
+	}
+
+	return info;
+}
+
+typedef bool (*pedf_test_t)(const ResourceSharingInfo&, AnalysisBudget*);
+
+static const struct {
+	const char *name;
+	pedf_test_t is_schedulable;
+} pedf_tests[] = {
+	{"msrp", lp_pedf_msrp_is_schedulable},
+	{"fifo preempt", lp_pedf_fifo_preempt_is_schedulable},
+	{"lockfree preempt", lp_pedf_lockfree_preempt_is_schedulable},
+	{"lockfree NP", lp_pedf_lockfree_NP_is_schedulable},
+};
+
+static const unsigned int num_pedf_tests =
+	sizeof(pedf_tests) / sizeof(pedf_tests[0]);
+
+// the analyses behind pedf_tests, in the same order
+static const pedf_analysis_factory_t pedf_analyses[] = {
+	make_pedf_msrp_analysis,
+	make_pedf_fifo_preempt_analysis,
+	make_pedf_lockfree_preempt_analysis,
+	make_pedf_lockfree_NP_analysis,
+};
+
+static bool same_check_points(const vector<PEDFCheckPoint> &a,
+                              const vector<PEDFCheckPoint> &b)
+{
+	if (a.size() != b.size())
+		return false;
+
+	for (unsigned int i = 0; i < a.size(); i++)
+		if (a[i].cluster != b[i].cluster || a[i].mode != b[i].mode ||
+		    a[i].interval_length != b[i].interval_length ||
+		    a[i].relaxed != b[i].relaxed ||
+		    a[i].has_tight != b[i].has_tight ||
+		    a[i].tight != b[i].tight)
+			return false;
+
+	return true;
+}
+
+void test_pedf_bound_caching()
+{
+	// the check points are only recorded in the calling thread
+	const unsigned int num_threads = get_lp_analysis_num_threads();
+	set_lp_analysis_num_threads(1);
+
+	unsigned int num_lp_bounds = 0;
+
+	for (unsigned int seed = 0; seed < 30; seed++)
+	{
+		ResourceSharingInfo *info = make_pedf_task_set(seed);
+
+		for (unsigned int a = 0; a < num_pedf_tests; a++)
+		{
+			vector<PEDFCheckPoint> cached, uncached;
+
+			set_pedf_check_point_trace(&cached);
+			const bool with_cache = pedf_tests[a].is_schedulable(*info, NULL);
+
+			set_pedf_bound_caching(false);
+			set_pedf_check_point_trace(&uncached);
+			const bool without_cache = pedf_tests[a].is_schedulable(*info, NULL);
+
+			set_pedf_bound_caching(true);
+			set_pedf_check_point_trace(NULL);
+
+			ostringstream what;
+			what << "P-EDF caches: " << pedf_tests[a].name
+			     << " task set " << seed;
+			check(with_cache == without_cache, what.str() + ": verdict");
+			check(same_check_points(cached, uncached),
+			      what.str() + ": bounds at the check points");
+
+			foreach(cached, cp)
+				num_lp_bounds += cp->has_tight;
+		}
+
+		delete info;
+	}
+
+	// the task sets must exercise the tightened bounds
+	check(num_lp_bounds > 0, "P-EDF caches: tightened bounds checked");
+
+	set_lp_analysis_num_threads(num_threads);
+}
+
+
+struct PeriodicStep
+{
+	unsigned long first, period, weight;
+
+	unsigned long count(unsigned long t) const
+	{
+		return t < first ? 0 : (t - first) / period + 1;
+	}
+};
+
+void test_incremental_step_sum()
+{
+	for (unsigned int seed = 0; seed < 20; seed++)
+	{
+		TestRandom random(seed);
+		IncrementalStepSum sum;
+		vector<PeriodicStep> steps;
+
+		// some step functions are added after the first moves
+		const unsigned int num_steps = 2 + random(10);
+		unsigned long t = 0;
+
+		for (unsigned int move = 0; move < 300; move++)
+		{
+			if (steps.size() < num_steps && random(10) == 0)
+			{
+				PeriodicStep s = {1 + random(60), 1 + random(40), random(10)};
+				steps.push_back(s);
+				sum.add(s.first, s.period, s.weight);
+			}
+			else if (!steps.empty() && random(8) == 0)
+			{
+				const unsigned int k = random(steps.size());
+				steps[k].weight = random(10);
+				sum.set_weight(k, steps[k].weight);
+			}
+			else
+			{
+				// mostly small steps up or down, sometimes far jumps
+				const unsigned long delta = random(4) ? random(20) : random(1000);
+				if (random(2))
+					t += delta;
+				else
+					t = t > delta ? t - delta : 0;
+				sum.move_to(t);
+			}
+
+			unsigned long value = 0, last = 0;
+			bool has_last = false;
+			foreach(steps, s)
+			{
+				const unsigned long count = s->count(t);
+				value += count * s->weight;
+				if (count)
+				{
+					const unsigned long point = s->first + (count - 1) * s->period;
+					if (!has_last || point > last)
+						last = point;
+					has_last = true;
+				}
+			}
+
+			unsigned long point = 0;
+			const bool found = sum.last_point(point);
+
+			ostringstream what;
+			what << "step sum " << seed << " move " << move << " at t = " << t;
+			check(sum.value() == value, what.str() + ": value");
+			check(found == has_last && (!found || point == last),
+			      what.str() + ": last point");
+		}
+	}
+}
+
+// exposes the check-point search of the P-EDF analyses
+class CheckPointSearch : public PEDFBlockingAnalysis
+{
+public:
+	CheckPointSearch(const ResourceSharingInfo& info, unsigned int cluster)
+		: PEDFBlockingAnalysis(info, cluster)
+	{}
+
+	using PEDFBlockingAnalysis::last_check_point_before;
+
+protected:
+	unsigned long compute_blocking_PDC(unsigned long interval_length)
+	{
+		return 0;
+	}
+
+	unsigned long compute_blocking_AC(unsigned long interval_length)
+	{
+		return 0;
+	}
+};
+
+// The O(n) scan that last_check_point_before() replaced. The scan computed
+// step points below the first job (i.e., negative ones) in unsigned
+// arithmetic, which wrapped around; these are skipped here.
+static unsigned long scan_check_point_before(const ResourceSharingInfo &info,
+                                             unsigned int cluster,
+                                             unsigned long interval_length)
+{
+	const long t = interval_length;
+	long last_check_point = 0;
+
+	if (!t)
+		return 0;
+
+	foreach(info.get_tasks(), T_i)
+	{
+		const long period = T_i->get_period();
+		const long deadline = T_i->get_deadline();
+		long d;
+
+		if (T_i->get_cluster() == cluster)
+		{
+			if (deadline >= t)
+				continue;
+
+			// steps of nljobs(T_i,t)
+			d = (t - deadline) / period * period + deadline;
+			if (d == t)
+				d -= period;
+			last_check_point = max(last_check_point, d);
+
+			// steps of ceil(T_i,t)
+			d = (t + period - 1) / period * period - period + 1;
+			if (d == t)
+				d -= period;
+			last_check_point = max(last_check_point, d);
+		}
+		else
+		{
+			// steps of nrjobs(T_i,t)
+			const long njobs = (t + deadline + period - 1) / period;
+			if (njobs > 1)
+			{
+				d = (njobs - 1) * period - deadline + 1;
+				if (d == t)
+					d -= period;
+				last_check_point = max(last_check_point, d);
+			}
+		}
+	}
+
+	return last_check_point;
+}
+
+void test_last_check_point_before()
+{
+	for (unsigned int seed = 0; seed < 10; seed++)
+	{
+		ResourceSharingInfo *info = make_pedf_task_set(seed);
+		TestRandom random(seed);
+
+		for (unsigned int cluster = 0; cluster < 2; cluster++)
+		{
+			CheckPointSearch search(*info, cluster);
+
+			// walk down from far out, as QPA does, then randomly
+			unsigned long t = 1000;
+			for (unsigned int i = 0; i < 400; i++)
+			{
+				const unsigned long expected =
+					scan_check_point_before(*info, cluster, t);
+
+				ostringstream what;
+				what << "check points: task set " << seed << " cluster "
+				     << cluster << " t = " << t << ": "
+				     << search.last_check_point_before(t)
+				     << " vs. " << expected;
+				check(search.last_check_point_before(t) == expected,
+				      what.str());
+
+				if (i < 200)
+					t = t ? expected : 1000;
+				else
+					t = random(1100);
+			}
+		}
+
+		delete info;
+	}
+}
+
+
+void test_pedf_closed_form_bounds()
+{
+	for (unsigned int seed = 0; seed < 8; seed++)
+	{
+		ResourceSharingInfo *info = make_pedf_task_set(seed);
+
+		for (unsigned int a = 0; a < num_pedf_tests; a++)
+			for (unsigned int cluster = 0; cluster < 2; cluster++)
+			{
+				PEDFBlockingAnalysis *analysis =
+					pedf_analyses[a](*info, cluster);
+
+				double rate, offset;
+				const bool has_rate =
+					analysis->get_closed_form_blocking_rate_PDC(rate, offset);
+
+				for (unsigned long t = 1; t <= 400; t += 3)
+				{
+					unsigned long closed_form;
+					if (!analysis->get_closed_form_blocking_PDC(t, closed_form))
+						continue;
+
+					const unsigned long lp = analysis->solve_blocking_PDC(t);
+
+					ostringstream what;
+					what << "closed form: " << pedf_tests[a].name
+					     << " task set " << seed << " cluster " << cluster
+					     << " t = " << t << ": " << closed_form
+					     << " vs. LP " << lp;
+					check(closed_form >= lp, what.str());
+					check(!has_rate || closed_form <= rate * t + offset + 1E-6,
+					      what.str() + " (rate)");
+				}
+
+				delete analysis;
+			}
+
+		delete info;
+	}
+}
+
+
+void test_pedf_horizon()
+{
+	const pedf_horizon_t horizon = get_pedf_analysis_horizon();
+
+	for (unsigned int seed = 0; seed < 30; seed++)
+	{
+		ResourceSharingInfo *info = make_pedf_task_set(seed);
+
+		for (unsigned int a = 0; a < num_pedf_tests; a++)
+		{
+			set_pedf_analysis_horizon(PEDF_HORIZON_NONE);
+			const bool none = pedf_tests[a].is_schedulable(*info, NULL);
+			set_pedf_analysis_horizon(PEDF_HORIZON_SAFE);
+			const bool safe = pedf_tests[a].is_schedulable(*info, NULL);
+
+			ostringstream what;
+			what << "horizon: " << pedf_tests[a].name << " task set "
+			     << seed << ": " << none << " without vs. " << safe
+			     << " with safe horizon";
+			check(none == safe, what.str());
+		}
+
+		delete info;
+	}
+
+	set_pedf_analysis_horizon(horizon);
+
+	// three co-prime periods of about 10^6 fit, four do not
+	const unsigned long primes[] = {1000003, 1000033, 1000037, 1000039};
+	ResourceSharingInfo three(3), four(4), small(3);
+	for (unsigned int i = 0; i < 4; i++)
+	{
+		if (i < 3)
+			three.add_task(primes[i], primes[i], 0, i, 1);
+		four.add_task(primes[i], primes[i], 0, i, 1);
+	}
+	small.add_task(4, 4, 0, 0, 1);
+	small.add_task(6, 6, 0, 1, 1);
+	small.add_task(10, 10, 0, 2, 1);
+
+	check(saturating_hyper_period(small) == 60, "hyper-period of 4, 6, 10");
+	check(saturating_hyper_period(three) == primes[0] * primes[1] * primes[2],
+	      "hyper-period of three co-prime periods");
+	check(saturating_hyper_period(four) == ULONG_MAX,
+	      "hyper-period of four co-prime periods saturates");
+}
+
+
+typedef PEDFSensitivity* (*pedf_sensitivity_t)(const ResourceSharingInfo&,
+                                               pedf_sensitivity_param_t,
+                                               double, double,
+                                               AnalysisBudget*);
+
+// fresh analysis of one processor of info, with all request lengths (and
+// the costs, if scale_wcets) multiplied by factor
+static bool pedf_schedulable_at(const ResourceSharingInfo &info,
+                                pedf_analysis_factory_t make_analysis,
+                                unsigned int cluster, bool scale_wcets,
+                                double factor, unsigned int seed)
+{
+	ResourceSharingInfo *scaled = make_pedf_task_set(seed);
+	scaled->set_scaled_parameters(info, scale_wcets ? factor : 1, factor);
+
+	PEDFBlockingAnalysis *analysis = make_analysis(*scaled, cluster);
+	const bool ok = analysis->is_schedulable();
+
+	delete analysis;
+	delete scaled;
+	return ok;
+}
+
+void test_pedf_sensitivity()
+{
+	const pedf_sensitivity_t sensitivity[] = {
+		lp_pedf_msrp_sensitivity,
+		lp_pedf_fifo_preempt_sensitivity,
+		lp_pedf_lockfree_preempt_sensitivity,
+		lp_pedf_lockfree_NP_sensitivity,
+	};
+
+	const double max_factor = 8, precision = 0.05;
+
+	for (unsigned int seed = 0; seed < 6; seed++)
+	{
+		ResourceSharingInfo *info = make_pedf_task_set(seed);
+		const bool scale_wcets = seed % 2;
+		const pedf_sensitivity_param_t param =
+			scale_wcets ? PEDF_SCALE_WCETS : PEDF_SCALE_REQUEST_LENGTHS;
+
+		for (unsigned int a = 0; a < num_pedf_tests; a++)
+		{
+			PEDFSensitivity *result = sensitivity[a](*info, param,
+			                                         max_factor, precision,
+			                                         NULL);
+			check(!result->is_inconclusive(),
+			      "sensitivity: conclusive without a budget");
+
+			for (unsigned int k = 0; k < result->get_num_clusters(); k++)
+			{
+				const double factor = result->get_critical_factor(k);
+
+				ostringstream what;
+				what << "sensitivity: " << pedf_tests[a].name
+				     << " task set " << seed << " cluster " << k
+				     << " factor " << factor;
+
+				// the factor must agree with fresh analyses
+				if (factor >= 0)
+					check(pedf_schedulable_at(*info, pedf_analyses[a], k,
+					                          scale_wcets, factor, seed),
+					      what.str() + " is schedulable");
+				if (factor < 0)
+					check(!pedf_schedulable_at(*info, pedf_analyses[a], k,
+					                           scale_wcets, 0, seed),
+					      what.str() + ": not schedulable at 0");
+				else if (factor < max_factor)
+					check(!pedf_schedulable_at(*info, pedf_analyses[a], k,
+					                           scale_wcets, factor + precision,
+					                           seed),
+					      what.str() + " plus precision is not");
+			}
+
+			delete result;
+
+			// a budget that runs out during the bisection
+			AnalysisBudget budget(0, 0, 3);
+			result = sensitivity[a](*info, param, max_factor, precision,
+			                        &budget);
+			check(result->is_inconclusive(),
+			      "sensitivity: inconclusive when the budget runs out");
+			delete result;
+		}
+
+		delete info;
+	}
+}
+
+static fractional_t to_fractional(const fixed_fractional_t &q)
+{
+	fractional_t r(integral_t(q.get_num().get_si()),
+	               integral_t(q.get_den().get_si()));
+	r.canonicalize();
+	return r;
+}
+
+void test_fixed_fractional()
+{
+	TestRandom next(1);
+
+	for (unsigned int n = 0; n < 200; n++)
+	{
+		const long a = next(2000) - 1000, b = next(1000) + 1;
+		const long c = next(2000) - 1000, d = next(1000) + 1;
+		const fixed_fractional_t x(a, b), y(c, d);
+		fractional_t ex(a, b), ey(c, d);
+		ex.canonicalize();
+		ey.canonicalize();
+
+		check(to_fractional(x + y) == ex + ey, "fixed fraction: sum");
+		check(to_fractional(x - y) == ex - ey, "fixed fraction: difference");
+		check(to_fractional(x * y) == ex * ey, "fixed fraction: product");
+		if (c)
+			check(to_fractional(x / y) == ex / ey,
+			      "fixed fraction: quotient");
+	}
+
+	// The cross products of these fit into 128 bits, but their sum and
+	// difference do not.
+	const fixed_fractional_t big(fixed_integral_t(INT64_MAX),
+	                             fixed_integral_t(INT64_MAX - 1));
+	const fixed_fractional_t other(fixed_integral_t(INT64_MAX),
+	                               fixed_integral_t(INT64_MAX - 2));
+	const fixed_fractional_t neg_other(fixed_integral_t(-INT64_MAX),
+	                                   fixed_integral_t(INT64_MAX - 2));
+
+	bool overflowed = false;
+	try
+	{
+		big + other;
+	}
+	catch (const fixed_width_overflow &)
+	{
+		overflowed = true;
+	}
+	check(overflowed, "fixed fraction: sum of cross products overflows");
+
+	overflowed = false;
+	try
+	{
+		big - neg_other;
+	}
+	catch (const fixed_width_overflow &)
+	{
+		overflowed = true;
+	}
+	check(overflowed,
+	      "fixed fraction: difference of cross products overflows");
+
+	// a difference of large cross products whose result still fits
+	const fixed_fractional_t half(fixed_integral_t(INT64_MAX),
+	                              fixed_integral_t(2));
+	const fixed_fractional_t quarter(fixed_integral_t(INT64_MAX),
+	                                 fixed_integral_t(4));
+	check(to_fractional(half - quarter) == to_fractional(quarter),
+	      "fixed fraction: difference of large fractions");
+}
+
+struct fixed_width_test_t
+{
+	const char *name;
+	bool (*is_schedulable)(const TaskSet &ts);
+};
+
+static bool qpa_schedulable(const TaskSet &ts)
+{
+	return QPATest(1).is_schedulable(ts);
+}
+
+static bool baruah_schedulable(const TaskSet &ts)
+{
+	return BaruahGedf(2).is_schedulable(ts);
+}
+
+static bool la_schedulable(const TaskSet &ts)
+{
+	return LAGedf(2).is_schedulable(ts);
+}
+
+static bool ffdbf_schedulable(const TaskSet &ts)
+{
+	return FFDBFGedf(2).is_schedulable(ts);
+}
+
+static const fixed_width_test_t fixed_width_tests[] = {
+	{"QPA", qpa_schedulable},
+	{"Baruah", baruah_schedulable},
+	{"LA", la_schedulable},
+	{"FFDBF", ffdbf_schedulable},
+};
+
+static const unsigned int num_fixed_width_tests =
+	sizeof(fixed_width_tests) / sizeof(fixed_width_tests[0]);
+
+// Checks that each test reaches the same verdict in every mode and records
+// which tests overflowed when confined to fixed-width arithmetic.
+static void check_fixed_width_modes(const TaskSet &ts, const string &name,
+                                    bool overflowed[])
+{
+	for (unsigned int t = 0; t < num_fixed_width_tests; t++)
+	{
+		const string what = string("fixed width: ") +
+			fixed_width_tests[t].name + " on " + name;
+
+		set_fixed_width_mode(GMP_ONLY);
+		const bool expected = fixed_width_tests[t].is_schedulable(ts);
+
+		set_fixed_width_mode(FIXED_WIDTH_FIRST);
+		check(fixed_width_tests[t].is_schedulable(ts) == expected,
+		      what + " with fallback matches GMP");
+
+		set_fixed_width_mode(FIXED_WIDTH_ONLY);
+		try
+		{
+			check(fixed_width_tests[t].is_schedulable(ts) == expected,
+			      what + " in fixed width matches GMP");
+		}
+		catch (const fixed_width_overflow &)
+		{
+			overflowed[t] = true;
+		}
+	}
+
+	set_fixed_width_mode(FIXED_WIDTH_FIRST);
+}
+
+void test_fixed_width_tests()
+{
+	// small task sets, which never need GMP
+	for (unsigned int seed = 0; seed < 20; seed++)
+	{
+		TestRandom next(seed);
+		TaskSet ts;
+
+		const unsigned int num_tasks = 3 + next(4);
+		for (unsigned int i = 0; i < num_tasks; i++)
+		{
+			const unsigned long period = 10 + next(190);
+			const unsigned long wcet = 1 + next(period / 3);
+			const unsigned long deadline = wcet + next(period - wcet + 1);
+			ts.add_task(wcet, period, deadline);
+		}
+
+		ostringstream name;
+		name << "task set " << seed;
+
+		bool overflowed[num_fixed_width_tests] = {false};
+		check_fixed_width_modes(ts, name.str(), overflowed);
+		for (unsigned int t = 0; t < num_fixed_width_tests; t++)
+			check(!overflowed[t], string("fixed width: ") +
+			      fixed_width_tests[t].name + " on " + name.str() +
+			      " fits into 64 bits");
+	}
+
+	// Parameters close to 2^63 force the fallback to GMP. Each test
+	// overflows on at least one of these task sets.
+	bool overflowed[num_fixed_width_tests] = {false};
+
+	const unsigned long huge = (1UL << 62) + (1UL << 61);
+	TaskSet light;
+	light.add_task(huge / 16, huge, huge);
+	light.add_task(huge / 16 + 1, huge + 5, huge - 7);
+	light.add_task(huge / 32, huge / 2, huge / 2);
+	check_fixed_width_modes(light, "light task set", overflowed);
+
+	const unsigned long big = 1UL << 61;
+	TaskSet heavy;
+	heavy.add_task(big / 2, big, big / 2 + 5);
+	heavy.add_task(big / 3, big + 11, big - 3);
+	heavy.add_task(big / 8, big / 2, big / 3);
+	heavy.add_task(big / 4 + 1, big + 3, big);
+	check_fixed_width_modes(heavy, "heavy task set", overflowed);
+
+	// periods beyond 2^63 and a total demand at the first deadline of
+	// 5 * 2^61, although the utilization is only 5/6
+	const unsigned long half = 1UL << 61;
+	TaskSet sparse;
+	for (unsigned int i = 0; i < 5; i++)
+		sparse.add_task(half, 6 * half, half);
+	check_fixed_width_modes(sparse, "sparse task set", overflowed);
+
+	for (unsigned int t = 0; t < num_fixed_width_tests; t++)
+		check(overflowed[t], string("fixed width: ") +
+		      fixed_width_tests[t].name + " falls back to GMP");
+}
+
+// uniform in [0, range), for ranges beyond 31 bits
+static unsigned long random_below(TestRandom &next, unsigned long range)
+{
+	const unsigned long r = (next(1UL << 31) << 31) | next(1UL << 31);
+	return r % range;
+}
+
+// GMP counterparts of the kernel's functions that Task does not provide
+
+static integral_t gmp_rbf(const TaskSet &ts, const integral_t &time)
+{
+	integral_t requests = 0, jobs;
+	if (time > 0)
+		for (unsigned int i = 0; i < ts.get_task_count(); i++)
+		{
+			mpz_cdiv_q_ui(jobs.get_mpz_t(), time.get_mpz_t(),
+			              ts[i].get_period());
+			requests += jobs * ts[i].get_wcet();
+		}
+	return requests;
+}
+
+static integral_t gmp_last_deadline_before(const TaskSet &ts,
+                                           const integral_t &time)
+{
+	integral_t latest = 0, dl;
+	for (unsigned int i = 0; i < ts.get_task_count(); i++)
+		if (ts[i].get_deadline() < time)
+		{
+			dl = time - ts[i].get_deadline() - 1;
+			dl /= ts[i].get_period();
+			dl = dl * ts[i].get_period() + ts[i].get_deadline();
+			if (dl > latest)
+				latest = dl;
+		}
+	return latest;
+}
+
+static integral_t gmp_carry_in_dbf(const Task &tsk, const integral_t &time)
+{
+	integral_t periods, rest;
+	mpz_fdiv_qr_ui(periods.get_mpz_t(), rest.get_mpz_t(), time.get_mpz_t(),
+	               tsk.get_period());
+	if (rest > tsk.get_wcet())
+		rest = tsk.get_wcet();
+	return periods * tsk.get_wcet() + rest;
+}
+
+static void check_demand_kernel(const TaskSet &ts,
+                                const std::vector<unsigned long> &k,
+                                const DemandKernel &kernel,
+                                long time, const string &name)
+{
+	const integral_t t = time;
+	const fixed_integral_t ft = time;
+
+	ostringstream what;
+	what << "demand kernel: " << name << " at " << time;
+
+	integral_t dbf = 0, approx = 0, demand;
+	for (unsigned int i = 0; i < ts.get_task_count(); i++)
+	{
+		dbf += ts[i].dbf(t);
+		ts[i].approx_demand(t, demand, k[i]);
+		approx += demand;
+	}
+
+	check(kernel.dbf(ft).get_si() == dbf, what.str() + ": dbf");
+	check(kernel.rbf(ft).get_si() == gmp_rbf(ts, t), what.str() + ": rbf");
+	check(kernel.last_deadline_before(ft).get_si() ==
+	      gmp_last_deadline_before(ts, t),
+	      what.str() + ": last deadline before");
+	check(kernel.approx_dbf(ft).get_si() == approx,
+	      what.str() + ": approx dbf");
+
+	// the carry-in variant is only defined for non-negative times
+	if (time < 0)
+		return;
+
+	std::vector<fixed_integral_t> task_dbf(ts.get_task_count());
+	std::vector<fixed_integral_t> carry_in_dbf(ts.get_task_count());
+	kernel.task_dbf(ft, task_dbf.data(), carry_in_dbf.data());
+	for (unsigned int i = 0; i < ts.get_task_count(); i++)
+	{
+		check(task_dbf[i].get_si() == ts[i].dbf(t),
+		      what.str() + ": task dbf");
+		check(carry_in_dbf[i].get_si() == gmp_carry_in_dbf(ts[i], t),
+		      what.str() + ": carry-in dbf");
+	}
+}
+
+// whether every function of the kernel throws fixed_width_overflow
+static bool kernel_rejects(const DemandKernel &kernel,
+                           const fixed_integral_t &time)
+{
+	std::vector<fixed_integral_t> dbf(kernel.get_task_count());
+	unsigned int rejected = 0;
+
+	for (unsigned int f = 0; f < 5; f++)
+	{
+		try
+		{
+			switch (f)
+			{
+			case 0: kernel.dbf(time); break;
+			case 1: kernel.rbf(time); break;
+			case 2: kernel.last_deadline_before(time); break;
+			case 3: kernel.approx_dbf(time); break;
+			case 4: kernel.task_dbf(time, dbf.data(), dbf.data()); break;
+			}
+		}
+		catch (const fixed_width_overflow &)
+		{
+			rejected++;
+		}
+	}
+
+	return rejected == 5;
+}
+
+void test_demand_kernel()
+{
+	// Up to 17 tasks cover full and partially filled vectors of any lane
+	// width. The large task sets reach times close to 2^53, where the
+	// lanes' doubles are barely exact.
+	for (unsigned int seed = 0; seed < 34; seed++)
+	{
+		TestRandom next(seed);
+		TaskSet ts;
+
+		const unsigned int num_tasks = 1 + seed % 17;
+		const bool large = seed >= 17;
+		const unsigned long max_period = large ? 1UL << 26 : 1000;
+
+		std::vector<unsigned long> k(num_tasks);
+		for (unsigned int i = 0; i < num_tasks; i++)
+		{
+			const unsigned long period = 1 + random_below(next, max_period);
+			const unsigned long wcet = 1 + random_below(next, period / 4 + 1);
+			const unsigned long deadline = 1 + random_below(next, 2 * period);
+			ts.add_task(wcet, period, deadline);
+			k[i] = next(5);
+		}
+
+		DemandKernel kernel(ts);
+		kernel.set_approximation(k.data());
+
+		ostringstream name;
+		name << (large ? "large" : "small") << " task set " << seed;
+
+		const long max_time = kernel.get_max_time().get_si();
+		check(max_time > 0, "demand kernel: " + name.str() + " fits");
+		if (max_time <= 0)
+			continue;
+
+		std::vector<long> times;
+		times.push_back(0);
+		times.push_back(max_time);
+		times.push_back(-max_time);
+		for (unsigned int i = 0; i < num_tasks; i++)
+		{
+			times.push_back(ts[i].get_deadline() - 1);
+			times.push_back(ts[i].get_deadline());
+			times.push_back(ts[i].get_deadline() + ts[i].get_period());
+		}
+		for (unsigned int n = 0; n < 100; n++)
+			times.push_back(random_below(next, max_time + 1));
+		for (unsigned int n = 0; n < 10; n++)
+			times.push_back(-(long) random_below(next, max_period * 4));
+
+		for (unsigned int n = 0; n < times.size(); n++)
+			check_demand_kernel(ts, k, kernel, times[n], name.str());
+
+		check(kernel_rejects(kernel, fixed_integral_t(max_time + 1)),
+		      "demand kernel: " + name.str() + " rejects times beyond "
+		      "the maximum");
+		check(kernel_rejects(kernel, fixed_integral_t(-max_time - 1)),
+		      "demand kernel: " + name.str() + " rejects negative times "
+		      "beyond the maximum");
+	}
+}
+// The tests that GlobalEDF combines, run one after the other as a plain
+// sequential cascade.
+static bool gedf_cascade(unsigned int m, const TaskSet &ts)
+{
+	if (!(ts.has_only_feasible_tasks() && ts.is_not_overutilized(m)))
+		return false;
+
+	if (BakerGedf(m).is_schedulable(ts, false))
+		return true;
+	if (ts.has_only_constrained_deadlines() &&
+	    (GFBGedf(m).is_schedulable(ts, false) ||
+	     RTAGedf(m).is_schedulable(ts, false) ||
+	     BaruahGedf(m).is_schedulable(ts, false) ||
+	     FFDBFGedf(m).is_schedulable(ts, false)))
+		return true;
+	return LAGedf(m).is_schedulable(ts, false) ||
+	       LoadGedf(m).is_schedulable(ts, false);
+}
+
+void test_gedf_cascade_modes()
+{
+	const gedf_cascade_mode_t modes[] = {
+		GEDF_CASCADE_FIXED,
+		GEDF_CASCADE_PARALLEL,
+		GEDF_CASCADE_ADAPTIVE,
+	};
+	const char *mode_names[] = {"fixed", "parallel", "adaptive"};
+
+	unsigned int num_schedulable = 0, num_task_sets = 40;
+
+	for (unsigned int seed = 0; seed < num_task_sets; seed++)
+	{
+		TestRandom next(seed);
+		TaskSet ts;
+
+		const unsigned int m = 2 + next(3);
+		const unsigned int num_tasks = m + 1 + next(6);
+		// every fourth task set has arbitrary deadlines
+		const bool constrained = seed % 4;
+		for (unsigned int i = 0; i < num_tasks; i++)
+		{
+			const unsigned long period = 10 + next(490);
+			const unsigned long wcet = 1 + next(period * 3 / 5);
+			const unsigned long deadline = wcet +
+				next(constrained ? period - wcet + 1 : 2 * period);
+			ts.add_task(wcet, period, deadline);
+		}
+
+		const bool expected = gedf_cascade(m, ts);
+		num_schedulable += expected;
+
+		for (unsigned int i = 0; i < 3; i++)
+		{
+			GlobalEDF test(m, 1, true, true, true, true, true);
+			test.set_cascade_mode(modes[i]);
+
+			ostringstream what;
+			what << "G-EDF cascade: " << mode_names[i]
+			     << " mode on task set " << seed;
+			check(test.is_schedulable(ts) == expected, what.str());
+		}
+	}
+
+	check(num_schedulable > 0 && num_schedulable < num_task_sets,
+	      "G-EDF cascade: both verdicts occur");
+
+	// Only the adaptive mode measures its tests.
+	TaskSet ts;
+	ts.add_task(20, 100, 60);
+	ts.add_task(30, 150, 90);
+	ts.add_task(70, 120, 110);
+
+	reset_gedf_test_stats();
+	GlobalEDF test(2);
+	test.is_schedulable(ts);
+	test.set_cascade_mode(GEDF_CASCADE_PARALLEL);
+	test.is_schedulable(ts);
+
+	unsigned long runs = 0;
+	for (unsigned int i = 0; i < GEDF_NUM_TESTS; i++)
+		runs += get_gedf_test_stats((gedf_test_t) i).runs;
+	check(runs == 0, "G-EDF cascade: no stats outside the adaptive mode");
+
+	test.set_cascade_mode(GEDF_CASCADE_ADAPTIVE);
+	test.is_schedulable(ts);
+	for (unsigned int i = 0; i < GEDF_NUM_TESTS; i++)
+		runs += get_gedf_test_stats((gedf_test_t) i).runs;
+	check(runs > 0, "G-EDF cascade: stats in the adaptive mode");
+	reset_gedf_test_stats();
+
+	// The load test gives up once its budget is cancelled, and runs to
+	// completion with a budget that is large enough.
+	AnalysisBudget cancelled;
+	cancelled.cancel();
+	check(!LoadGedf(2, 100, &cancelled).is_schedulable(ts),
+	      "load test: gives up when cancelled");
+	check(cancelled.get_outcome(false) == OUTCOME_INCONCLUSIVE,
+	      "load test: inconclusive when cancelled");
+
+	AnalysisBudget ample(0, 0, 1000000);
+	check(LoadGedf(2, 100, &ample).is_schedulable(ts) ==
+	      LoadGedf(2).is_schedulable(ts),
+	      "load test: same verdict with an ample budget");
+	check(ample.get_work() > 10, "load test: charges its test points");
+}
 
 int main(int argc, char** argv)
 {
     test_linprog();
-    return 0;
+
+    cerr << "(The LP tests below report failed solves on purpose.)" << endl;
+    test_linprog_sessions();
+    test_simplex();
+    test_solver_fallback();
+    test_presolve();
+    test_mps_round_trip();
+    test_lp_stats();
+    test_blocking_thresholds();
+    test_pedf_bound_caching();
+    test_incremental_step_sum();
+    test_last_check_point_before();
+    test_pedf_closed_form_bounds();
+    test_pedf_horizon();
+    test_pedf_sensitivity();
+    test_fixed_fractional();
+    test_fixed_width_tests();
+    test_demand_kernel();
+    test_gedf_cascade_modes();
+
+    if (num_failures)
+        cout << num_failures << " checks FAILED" << endl;
+    return num_failures ? 1 : 0;
 }
 
 int xxxmain(int argc, char** argv)
@@ -1047,7 +2958,7 @@ int __main(int argc, char** argv)
 	delete results;
 
 
-#if defined(CONFIG_HAVE_CPLEX) || defined(CONFIG_HAVE_GLPK)
+#ifdef CONFIG_HAVE_LP
 
 	results = lp_dpcp_bounds(rsi, loc, false);
 
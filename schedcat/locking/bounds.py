@@ -354,6 +354,16 @@ def get_cpp_nested_cs_model(all_tasks):
     return model
 
 
+def get_cpp_blocking_thresholds(all_tasks, max_blocking):
+    # max_blocking[i] is the largest blocking bound that is still acceptable
+    # for all_tasks[i], or None if task i must be analyzed exactly.
+    thresholds = lp_cpp.BlockingThresholds(len(all_tasks))
+    for i, b in enumerate(max_blocking):
+        if b is not None:
+            thresholds.set_threshold(i, int(b))
+    return thresholds
+
+
 def apply_lp_dflp_bounds(all_tasks, resource_mapping):
     model = get_cpp_model(all_tasks)
     topo = get_cpp_topology(resource_mapping)
@@ -456,73 +466,109 @@ def apply_msrp_bounds(all_tasks, num_cpus):
         t.remote_blocking = res.get_remote_blocking(i)
 
 
-def apply_pfp_lp_preemptive_fifo_bounds(all_tasks):
+def apply_pfp_lp_preemptive_fifo_bounds(all_tasks, max_blocking=None):
     model = get_cpp_model(all_tasks)
-    res = lp_cpp.lp_pfp_preemptive_fifo_spinlock_bounds(model)
+    if max_blocking is None:
+        res = lp_cpp.lp_pfp_preemptive_fifo_spinlock_bounds(model)
+    else:
+        thresholds = get_cpp_blocking_thresholds(all_tasks, max_blocking)
+        res = lp_cpp.lp_pfp_preemptive_fifo_spinlock_bounds(model, thresholds)
     for i, _ in enumerate(all_tasks):
         all_tasks[i].blocked = res.get_blocking_term(i)
     return res
 
 
-def apply_pfp_lp_msrp_bounds(all_tasks):
+def apply_pfp_lp_msrp_bounds(all_tasks, max_blocking=None):
     model = get_cpp_model(all_tasks)
-    res = lp_cpp.lp_pfp_msrp_bounds(model)
+    if max_blocking is None:
+        res = lp_cpp.lp_pfp_msrp_bounds(model)
+    else:
+        thresholds = get_cpp_blocking_thresholds(all_tasks, max_blocking)
+        res = lp_cpp.lp_pfp_msrp_bounds(model, thresholds)
     for i, _ in enumerate(all_tasks):
         all_tasks[i].blocked = res.get_blocking_term(i)
     return res
 
 
-def apply_pfp_lp_unordered_bounds(all_tasks):
+def apply_pfp_lp_unordered_bounds(all_tasks, max_blocking=None):
     model = get_cpp_model(all_tasks)
-    res = lp_cpp.lp_pfp_unordered_spinlock_bounds(model, False)
+    if max_blocking is None:
+        res = lp_cpp.lp_pfp_unordered_spinlock_bounds(model, False)
+    else:
+        thresholds = get_cpp_blocking_thresholds(all_tasks, max_blocking)
+        res = lp_cpp.lp_pfp_unordered_spinlock_bounds(model, False, thresholds)
     for i, _ in enumerate(all_tasks):
         all_tasks[i].blocked = res.get_blocking_term(i)
     return res
 
 
-def apply_pfp_lp_preemptive_unordered_bounds(all_tasks):
+def apply_pfp_lp_preemptive_unordered_bounds(all_tasks, max_blocking=None):
     model = get_cpp_model(all_tasks)
-    res = lp_cpp.lp_pfp_unordered_spinlock_bounds(model, True)
+    if max_blocking is None:
+        res = lp_cpp.lp_pfp_unordered_spinlock_bounds(model, True)
+    else:
+        thresholds = get_cpp_blocking_thresholds(all_tasks, max_blocking)
+        res = lp_cpp.lp_pfp_unordered_spinlock_bounds(model, True, thresholds)
     for i, _ in enumerate(all_tasks):
         all_tasks[i].blocked = res.get_blocking_term(i)
     return res
 
 
-def apply_pfp_lp_prio_bounds(all_tasks):
+def apply_pfp_lp_prio_bounds(all_tasks, max_blocking=None):
     model = get_cpp_model(all_tasks)
-    res = lp_cpp.lp_pfp_prio_spinlock_bounds(model, False)
+    if max_blocking is None:
+        res = lp_cpp.lp_pfp_prio_spinlock_bounds(model, False)
+    else:
+        thresholds = get_cpp_blocking_thresholds(all_tasks, max_blocking)
+        res = lp_cpp.lp_pfp_prio_spinlock_bounds(model, False, thresholds)
     for i, _ in enumerate(all_tasks):
         all_tasks[i].blocked = res.get_blocking_term(i)
     return res
 
 
-def apply_pfp_lp_preemptive_prio_bounds(all_tasks):
+def apply_pfp_lp_preemptive_prio_bounds(all_tasks, max_blocking=None):
     model = get_cpp_model(all_tasks)
-    res = lp_cpp.lp_pfp_prio_spinlock_bounds(model, True)
+    if max_blocking is None:
+        res = lp_cpp.lp_pfp_prio_spinlock_bounds(model, True)
+    else:
+        thresholds = get_cpp_blocking_thresholds(all_tasks, max_blocking)
+        res = lp_cpp.lp_pfp_prio_spinlock_bounds(model, True, thresholds)
     for i, _ in enumerate(all_tasks):
         all_tasks[i].blocked = res.get_blocking_term(i)
     return res
 
 
-def apply_pfp_lp_prio_fifo_bounds(all_tasks):
+def apply_pfp_lp_prio_fifo_bounds(all_tasks, max_blocking=None):
     model = get_cpp_model(all_tasks)
-    res = lp_cpp.lp_pfp_prio_fifo_spinlock_bounds(model, False)
+    if max_blocking is None:
+        res = lp_cpp.lp_pfp_prio_fifo_spinlock_bounds(model, False)
+    else:
+        thresholds = get_cpp_blocking_thresholds(all_tasks, max_blocking)
+        res = lp_cpp.lp_pfp_prio_fifo_spinlock_bounds(model, False, thresholds)
     for i, _ in enumerate(all_tasks):
         all_tasks[i].blocked = res.get_blocking_term(i)
     return res
 
 
-def apply_pfp_lp_preemptive_prio_fifo_bounds(all_tasks):
+def apply_pfp_lp_preemptive_prio_fifo_bounds(all_tasks, max_blocking=None):
     model = get_cpp_model(all_tasks)
-    res = lp_cpp.lp_pfp_prio_fifo_spinlock_bounds(model, True)
+    if max_blocking is None:
+        res = lp_cpp.lp_pfp_prio_fifo_spinlock_bounds(model, True)
+    else:
+        thresholds = get_cpp_blocking_thresholds(all_tasks, max_blocking)
+        res = lp_cpp.lp_pfp_prio_fifo_spinlock_bounds(model, True, thresholds)
     for i, _ in enumerate(all_tasks):
         all_tasks[i].blocked = res.get_blocking_term(i)
     return res
 
 
-def apply_pfp_lp_baseline_spinlock_bounds(all_tasks):
+def apply_pfp_lp_baseline_spinlock_bounds(all_tasks, max_blocking=None):
     model = get_cpp_model(all_tasks)
-    res = lp_cpp.lp_pfp_baseline_spinlock_bounds(model)
+    if max_blocking is None:
+        res = lp_cpp.lp_pfp_baseline_spinlock_bounds(model)
+    else:
+        thresholds = get_cpp_blocking_thresholds(all_tasks, max_blocking)
+        res = lp_cpp.lp_pfp_baseline_spinlock_bounds(model, thresholds)
     for i, _ in enumerate(all_tasks):
         all_tasks[i].blocked = res.get_blocking_term(i)
     return res
@@ -627,10 +673,15 @@ def apply_no_progress_priority_bounds(all_tasks, num_cpus):
     return res
 
 
-def apply_pfp_nested_fifo_spinlock_bounds(all_tasks):
+def apply_pfp_nested_fifo_spinlock_bounds(all_tasks, max_blocking=None):
     task_info = get_cpp_model(all_tasks, no_requests=True)
     nested_model = get_cpp_nested_cs_model(all_tasks)
-    res = lp_cpp.lp_nested_fifo_spinlock_bounds(task_info, nested_model)
+    if max_blocking is None:
+        res = lp_cpp.lp_nested_fifo_spinlock_bounds(task_info, nested_model)
+    else:
+        thresholds = get_cpp_blocking_thresholds(all_tasks, max_blocking)
+        res = lp_cpp.lp_nested_fifo_spinlock_bounds(task_info, nested_model,
+                                                    thresholds)
     for i, _ in enumerate(all_tasks):
         all_tasks[i].blocked = res.get_blocking_term(i)
     return res
@@ -660,6 +711,47 @@ def pedf_lockfree_NP_is_schedulable(all_tasks):
     return lp_cpp.lp_pedf_lockfree_NP_is_schedulable(model)
 
 
+def _pedf_sensitivity(analysis, all_tasks, scale_wcets, max_factor, precision,
+                      budget):
+    # Per partition, the largest factor by which the request lengths (or the
+    # costs and request lengths) can be scaled without losing schedulability,
+    # as (factor, inconclusive) pairs. If the budget (an lp_cpp.AnalysisBudget)
+    # ran out for a partition, inconclusive is True and the factor is only a
+    # lower bound on the critical one.
+    model = get_cpp_model(all_tasks, use_task_deadline=True)
+    if scale_wcets:
+        param = lp_cpp.PEDF_SCALE_WCETS
+    else:
+        param = lp_cpp.PEDF_SCALE_REQUEST_LENGTHS
+    res = analysis(model, param, max_factor, precision, budget)
+    return [(res.get_critical_factor(c), res.is_inconclusive(c))
+            for c in range(res.get_num_clusters())]
+
+
+def pedf_msrp_sensitivity(all_tasks, scale_wcets=False, max_factor=16, precision=0.01,
+                          budget=None):
+    return _pedf_sensitivity(lp_cpp.lp_pedf_msrp_sensitivity, all_tasks,
+                             scale_wcets, max_factor, precision, budget)
+
+
+def pedf_fifo_preempt_sensitivity(all_tasks, scale_wcets=False, max_factor=16, precision=0.01,
+                                  budget=None):
+    return _pedf_sensitivity(lp_cpp.lp_pedf_fifo_preempt_sensitivity, all_tasks,
+                             scale_wcets, max_factor, precision, budget)
+
+
+def pedf_lockfree_preempt_sensitivity(all_tasks, scale_wcets=False, max_factor=16, precision=0.01,
+                                      budget=None):
+    return _pedf_sensitivity(lp_cpp.lp_pedf_lockfree_preempt_sensitivity, all_tasks,
+                             scale_wcets, max_factor, precision, budget)
+
+
+def pedf_lockfree_NP_sensitivity(all_tasks, scale_wcets=False, max_factor=16, precision=0.01,
+                                 budget=None):
+    return _pedf_sensitivity(lp_cpp.lp_pedf_lockfree_NP_sensitivity, all_tasks,
+                             scale_wcets, max_factor, precision, budget)
+
+
 def pedf_msrp_classic_is_schedulable(all_tasks, num_cpus):
     # MSRP classic analysis based on QPA
     model = get_cpp_model(all_tasks, use_task_deadline=True)